@@ -0,0 +1,352 @@
+#ifndef TATAMI_MULT_ASYNC_HPP
+#define TATAMI_MULT_ASYNC_HPP
+
+#include <memory>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <cstddef>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+
+#include "tatami_mult.hpp"
+
+/**
+ * @file async.hpp
+ * @brief Asynchronous multiplication with cancellation and progress reporting.
+ *
+ * This header is not included by `tatami_mult.hpp` and should be included separately.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Exception thrown when an asynchronous multiplication is cancelled.
+ */
+class MultiplicationCancelled final : public std::runtime_error {
+public:
+    /**
+     * @cond
+     */
+    MultiplicationCancelled() : std::runtime_error("multiplication was cancelled") {}
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * @cond
+ */
+struct AsyncState {
+    std::atomic<bool> cancelled = false;
+    std::atomic<std::size_t> processed = 0;
+    std::size_t total = 0;
+
+    void check_and_count(const bool count) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            throw MultiplicationCancelled();
+        }
+        if (count) {
+            processed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+template<class Extractor_, typename Value_, typename Index_>
+class MonitoredDenseExtractor final : public Extractor_ {
+public:
+    MonitoredDenseExtractor(std::unique_ptr<Extractor_> inner, AsyncState& state, const bool count) :
+        my_inner(std::move(inner)), my_state(state), my_count(count) {}
+
+    const Value_* fetch(const Index_ i, Value_* const buffer) {
+        my_state.check_and_count(my_count);
+        return my_inner->fetch(i, buffer);
+    }
+
+private:
+    std::unique_ptr<Extractor_> my_inner;
+    AsyncState& my_state;
+    bool my_count;
+};
+
+template<class Extractor_, typename Value_, typename Index_>
+class MonitoredSparseExtractor final : public Extractor_ {
+public:
+    MonitoredSparseExtractor(std::unique_ptr<Extractor_> inner, AsyncState& state, const bool count) :
+        my_inner(std::move(inner)), my_state(state), my_count(count) {}
+
+    tatami::SparseRange<Value_, Index_> fetch(const Index_ i, Value_* const vbuffer, Index_* const ibuffer) {
+        my_state.check_and_count(my_count);
+        return my_inner->fetch(i, vbuffer, ibuffer);
+    }
+
+private:
+    std::unique_ptr<Extractor_> my_inner;
+    AsyncState& my_state;
+    bool my_count;
+};
+
+// Checks for cancellation before every fetch from the underlying matrix.
+// Fetches along 'count_row' are also counted towards the progress.
+template<typename Value_, typename Index_>
+class MonitoredMatrix final : public tatami::Matrix<Value_, Index_> {
+public:
+    MonitoredMatrix(std::shared_ptr<const tatami::Matrix<Value_, Index_> > matrix, std::shared_ptr<AsyncState> state, const bool count_row) :
+        my_matrix(std::move(matrix)), my_state(std::move(state)), my_count_row(count_row) {}
+
+private:
+    std::shared_ptr<const tatami::Matrix<Value_, Index_> > my_matrix;
+    std::shared_ptr<AsyncState> my_state;
+    bool my_count_row;
+
+    typedef std::shared_ptr<const tatami::Oracle<Index_> > OraclePtr;
+
+    template<class Extractor_>
+    std::unique_ptr<Extractor_> wrap_dense(const bool row, std::unique_ptr<Extractor_> inner) const {
+        return std::make_unique<MonitoredDenseExtractor<Extractor_, Value_, Index_> >(std::move(inner), *my_state, row == my_count_row);
+    }
+
+    template<class Extractor_>
+    std::unique_ptr<Extractor_> wrap_sparse(const bool row, std::unique_ptr<Extractor_> inner) const {
+        return std::make_unique<MonitoredSparseExtractor<Extractor_, Value_, Index_> >(std::move(inner), *my_state, row == my_count_row);
+    }
+
+public:
+    Index_ nrow() const { return my_matrix->nrow(); }
+
+    Index_ ncol() const { return my_matrix->ncol(); }
+
+    bool is_sparse() const { return my_matrix->is_sparse(); }
+
+    double is_sparse_proportion() const { return my_matrix->is_sparse_proportion(); }
+
+    bool prefer_rows() const { return my_matrix->prefer_rows(); }
+
+    double prefer_rows_proportion() const { return my_matrix->prefer_rows_proportion(); }
+
+    bool uses_oracle(const bool row) const { return my_matrix->uses_oracle(row); }
+
+public:
+    std::unique_ptr<tatami::MyopicDenseExtractor<Value_, Index_> > dense(const bool row, const tatami::Options& opt) const {
+        return wrap_dense(row, my_matrix->dense(row, opt));
+    }
+
+    std::unique_ptr<tatami::MyopicDenseExtractor<Value_, Index_> > dense(const bool row, const Index_ block_start, const Index_ block_length, const tatami::Options& opt) const {
+        return wrap_dense(row, my_matrix->dense(row, block_start, block_length, opt));
+    }
+
+    std::unique_ptr<tatami::MyopicDenseExtractor<Value_, Index_> > dense(const bool row, tatami::VectorPtr<Index_> indices_ptr, const tatami::Options& opt) const {
+        return wrap_dense(row, my_matrix->dense(row, std::move(indices_ptr), opt));
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<Value_, Index_> > sparse(const bool row, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_matrix->sparse(row, opt));
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<Value_, Index_> > sparse(const bool row, const Index_ block_start, const Index_ block_length, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_matrix->sparse(row, block_start, block_length, opt));
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<Value_, Index_> > sparse(const bool row, tatami::VectorPtr<Index_> indices_ptr, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_matrix->sparse(row, std::move(indices_ptr), opt));
+    }
+
+public:
+    std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > dense(const bool row, OraclePtr oracle, const tatami::Options& opt) const {
+        return wrap_dense(row, my_matrix->dense(row, std::move(oracle), opt));
+    }
+
+    std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > dense(const bool row, OraclePtr oracle, const Index_ block_start, const Index_ block_length, const tatami::Options& opt) const {
+        return wrap_dense(row, my_matrix->dense(row, std::move(oracle), block_start, block_length, opt));
+    }
+
+    std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > dense(const bool row, OraclePtr oracle, tatami::VectorPtr<Index_> indices_ptr, const tatami::Options& opt) const {
+        return wrap_dense(row, my_matrix->dense(row, std::move(oracle), std::move(indices_ptr), opt));
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > sparse(const bool row, OraclePtr oracle, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_matrix->sparse(row, std::move(oracle), opt));
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > sparse(const bool row, OraclePtr oracle, const Index_ block_start, const Index_ block_length, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_matrix->sparse(row, std::move(oracle), block_start, block_length, opt));
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > sparse(const bool row, OraclePtr oracle, tatami::VectorPtr<Index_> indices_ptr, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_matrix->sparse(row, std::move(oracle), std::move(indices_ptr), opt));
+    }
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Handle to an asynchronous multiplication.
+ *
+ * Instances of this class are returned by `multiply_with_matrix_async()`.
+ * If the handle is destroyed before the multiplication is complete, the multiplication is cancelled and the destructor blocks until all threads have stopped.
+ */
+class AsyncMultiplication {
+public:
+    /**
+     * @cond
+     */
+    AsyncMultiplication(std::future<void> future, std::shared_ptr<AsyncState> state) : my_future(std::move(future)), my_state(std::move(state)) {}
+
+    AsyncMultiplication(AsyncMultiplication&&) = default;
+
+    ~AsyncMultiplication() {
+        if (my_future.valid()) {
+            cancel();
+            my_future.wait();
+        }
+    }
+    /**
+     * @endcond
+     */
+
+    /**
+     * Request cancellation of the multiplication.
+     * Each thread checks for cancellation before extracting each LHS row/column,
+     * after which `get()` will throw a `MultiplicationCancelled` exception.
+     * Cancellation is not checked while the delegated function realizes the RHS matrix into memory, so it only takes effect once the LHS is being extracted.
+     * This has no effect if the multiplication has already finished or if this handle was moved from.
+     */
+    void cancel() {
+        if (my_state) {
+            my_state->cancelled.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @return Fraction of LHS rows/columns that have been processed, from 0 to 1.
+     * This is based on the dimension of the LHS matrix that is iterated over by the delegated function.
+     * The realization of the RHS matrix into memory is not counted, so the progress may remain at zero for some time if the RHS is large.
+     * If this handle was moved from, 1 is returned.
+     */
+    double progress() const {
+        if (!my_state || my_state->total == 0) {
+            return 1;
+        }
+        const std::size_t processed = my_state->processed.load(std::memory_order_relaxed);
+        return std::min(1.0, static_cast<double>(processed) / static_cast<double>(my_state->total));
+    }
+
+    /**
+     * @return Whether the multiplication has finished, either successfully, due to cancellation or due to an error.
+     */
+    bool ready() const {
+        if (!my_future.valid()) { // i.e., get() was already called.
+            return true;
+        }
+        return my_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /**
+     * Block until the multiplication has finished.
+     */
+    void wait() const {
+        if (my_future.valid()) {
+            my_future.wait();
+        }
+    }
+
+    /**
+     * Block until the multiplication has finished, and rethrow any exception that occurred, e.g., `MultiplicationCancelled`.
+     * This should be called no more than once.
+     * On successful return, the output array contains the matrix product.
+     */
+    void get() {
+        my_future.get();
+    }
+
+private:
+    std::future<void> my_future;
+    std::shared_ptr<AsyncState> my_state;
+};
+
+/**
+ * @cond
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+AsyncMultiplication launch_async_multiplication(
+    std::shared_ptr<const tatami::Matrix<LeftValue_, LeftIndex_> > left,
+    std::shared_ptr<const tatami::Matrix<RightValue_, RightIndex_> > right,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplyWithMatrixOptions& options
+) {
+    auto state = std::make_shared<AsyncState>();
+    const bool iter_row = left->prefer_rows();
+    state->total = (iter_row ? left->nrow() : left->ncol());
+    auto monitored = std::make_shared<MonitoredMatrix<LeftValue_, LeftIndex_> >(std::move(left), state, iter_row);
+
+    auto future = std::async(
+        std::launch::async,
+        [monitored, right, output, output_row_major, options, state]() -> void {
+            if (right->is_sparse()) {
+                multiply_with_sparse_matrix(*monitored, *right, output, output_row_major, options.sparse_matrix);
+            } else {
+                multiply_with_dense_matrix(*monitored, *right, output, output_row_major, options.dense_matrix);
+            }
+
+            // Some delegated functions may skip LHS rows/columns, e.g., if they are known to be empty,
+            // so we need to explicitly report full progress when the multiplication completes.
+            state->processed.store(state->total, std::memory_order_relaxed);
+        }
+    );
+
+    return AsyncMultiplication(std::move(future), std::move(state));
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Asynchronous version of `multiply_with_matrix()`.
+ * The multiplication is performed in a separate thread (which may spawn further threads according to `options`),
+ * allowing the caller to do other work while monitoring the progress or cancelling the multiplication via the returned handle.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left Pointer to the LHS matrix to be multiplied.
+ * @param right Pointer to the RHS matrix to be multiplied.
+ * `right->nrow()` and `left->ncol()` should be equal.
+ * @param[out] output Pointer to an array of length equal to `left->nrow() * right->ncol()`.
+ * This should remain valid until the multiplication has finished.
+ * Once `AsyncMultiplication::get()` returns without error, this stores the product of `left` and `right` in either row- or column-major format depending on `output_row_major`.
+ * If the multiplication was cancelled, the contents of this array are unspecified.
+ * @param output_row_major Whether to store the matrix product in row-major format in `output`.
+ * @param options Further options.
+ *
+ * @return Handle to the asynchronous multiplication.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+AsyncMultiplication multiply_with_matrix_async(
+    std::shared_ptr<const tatami::Matrix<LeftValue_, LeftIndex_> > left,
+    std::shared_ptr<const tatami::Matrix<RightValue_, RightIndex_> > right,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplyWithMatrixOptions& options
+) {
+    // Same logic as in multiply_with_matrix(), but we need to do it here so that we know which matrix to monitor.
+    if (options.larger_left) {
+        if (sanisizer::is_less_than(left->nrow(), right->ncol())) {
+            std::shared_ptr<const tatami::Matrix<RightValue_, RightIndex_> > tright = tatami::make_DelayedTranspose(std::move(right));
+            std::shared_ptr<const tatami::Matrix<LeftValue_, LeftIndex_> > tleft = tatami::make_DelayedTranspose(std::move(left));
+            return launch_async_multiplication(std::move(tright), std::move(tleft), output, !output_row_major, options);
+        }
+    }
+
+    return launch_async_multiplication(std::move(left), std::move(right), output, output_row_major, options);
+}
+
+}
+
+#endif
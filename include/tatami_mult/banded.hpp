@@ -0,0 +1,364 @@
+#ifndef TATAMI_MULT_BANDED_HPP
+#define TATAMI_MULT_BANDED_HPP
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+
+/**
+ * @file banded.hpp
+ * @brief Banded and diagonal operands.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Banded matrix in row-major band storage.
+ *
+ * Diagonal scaling matrices and short-stencil operators (e.g., for smoothing or finite differences) are banded, i.e., all non-zero elements lie within a fixed distance of the diagonal.
+ * Representing them as a `tatami::Matrix` is wasteful as the multiplication functions will treat them as a general dense or sparse matrix, possibly realizing the other operand in the process.
+ * Instead, a `BandedMatrix` can be multiplied with a `tatami::Matrix` via `multiply_banded_with_matrix()` or `multiply_matrix_with_banded()`,
+ * where each row of the product is computed as a linear combination of a few consecutive rows of the other operand.
+ * This only needs to hold a window of rows in memory and runs at memory bandwidth, e.g., a diagonal matrix reduces to a scaled copy of each row.
+ *
+ * @tparam Value_ Numeric type of the matrix value.
+ * @tparam Index_ Integer type of the matrix index.
+ */
+template<typename Value_, typename Index_>
+class BandedMatrix {
+public:
+    /**
+     * @param nrow Number of rows.
+     * @param ncol Number of columns.
+     * @param lower Lower bandwidth, i.e., the number of sub-diagonals that may contain non-zero elements.
+     * @param upper Upper bandwidth, i.e., the number of super-diagonals that may contain non-zero elements.
+     * @param values Vector containing the band in row-major storage.
+     * This should have length equal to `nrow * (lower + upper + 1)`.
+     * The `k`-th value of row `i` corresponds to column `i - lower + k`.
+     * Values corresponding to columns outside of `[0, ncol)` are ignored.
+     */
+    BandedMatrix(const Index_ nrow, const Index_ ncol, const Index_ lower, const Index_ upper, std::vector<Value_> values) :
+        my_nrow(nrow),
+        my_ncol(ncol),
+        my_lower(lower),
+        my_upper(upper),
+        my_width(sanisizer::sum<std::size_t>(sanisizer::sum<std::size_t>(lower, upper), 1)),
+        my_values(std::move(values))
+    {}
+
+private:
+    Index_ my_nrow, my_ncol, my_lower, my_upper;
+    std::size_t my_width;
+    std::vector<Value_> my_values;
+
+public:
+    /**
+     * @return Number of rows.
+     */
+    Index_ nrow() const {
+        return my_nrow;
+    }
+
+    /**
+     * @return Number of columns.
+     */
+    Index_ ncol() const {
+        return my_ncol;
+    }
+
+    /**
+     * @return Lower bandwidth.
+     */
+    Index_ lower_bandwidth() const {
+        return my_lower;
+    }
+
+    /**
+     * @return Upper bandwidth.
+     */
+    Index_ upper_bandwidth() const {
+        return my_upper;
+    }
+
+    /**
+     * @return The transpose of this matrix, also in row-major band storage.
+     */
+    BandedMatrix transpose() const {
+        std::vector<Value_> tvalues(sanisizer::product<I<decltype(my_values.size())> >(my_ncol, my_width));
+        for (Index_ i = 0; i < my_nrow; ++i) {
+            const auto range = row_range(i);
+            const auto vptr = row_values(i, range.first);
+            for (Index_ c = range.first; c < range.second; ++c) {
+                // Element (i, c) becomes (c, i), which is the (i - c + upper)-th value of row 'c' in the transposed band.
+                const std::size_t k = (i + my_upper) - c;
+                tvalues[sanisizer::nd_offset<std::size_t>(k, my_width, c)] = vptr[c - range.first];
+            }
+        }
+        return BandedMatrix(my_ncol, my_nrow, my_upper, my_lower, std::move(tvalues));
+    }
+
+    /**
+     * @cond
+     */
+    // Interval of columns in the band of row 'i'.
+    std::pair<Index_, Index_> row_range(const Index_ i) const {
+        const Index_ last = (i < my_ncol && my_ncol - i > my_upper ? i + my_upper + 1 : my_ncol);
+        const Index_ first = std::min(i > my_lower ? i - my_lower : static_cast<Index_>(0), last);
+        return std::make_pair(first, last);
+    }
+
+    // Pointer to the value of row 'i' at column 'first', where 'first' is the start of the interval returned by 'row_range()'.
+    const Value_* row_values(const Index_ i, const Index_ first) const {
+        return my_values.data() + sanisizer::nd_offset<std::size_t>(my_lower - (i - first), my_width, i);
+    }
+
+    std::size_t width() const {
+        return my_width;
+    }
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * Create a diagonal matrix, i.e., a `BandedMatrix` with zero lower and upper bandwidths.
+ *
+ * @tparam Value_ Numeric type of the matrix value.
+ * @tparam Index_ Integer type of the matrix index.
+ *
+ * @param diagonal Vector containing the diagonal elements.
+ *
+ * @return A square diagonal matrix of order equal to the length of `diagonal`.
+ */
+template<typename Value_, typename Index_ = int>
+BandedMatrix<Value_, Index_> create_diagonal_matrix(std::vector<Value_> diagonal) {
+    const auto N = sanisizer::cast<Index_>(diagonal.size());
+    return BandedMatrix<Value_, Index_>(N, N, 0, 0, std::move(diagonal));
+}
+
+/**
+ * @brief Options for multiplication with a `BandedMatrix`.
+ */
+struct MultiplyBandedOptions {
+    /**
+     * Number of threads to use.
+     * Different numbers of threads will not change the results.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @cond
+ */
+template<typename Value_, typename Index_, typename Right_, typename Output_>
+Output_ banded_dot_product(const BandedMatrix<Value_, Index_>& left, const Index_ i, const Right_* const right) {
+    const auto range = left.row_range(i);
+    const auto vptr = left.row_values(i, range.first);
+    Output_ output = 0;
+    for (Index_ c = range.first; c < range.second; ++c) {
+        output += static_cast<Output_>(vptr[c - range.first]) * static_cast<Output_>(right[c]);
+    }
+    return output;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @tparam Value_ Numeric type of the banded matrix value.
+ * @tparam Index_ Integer type of the banded matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vector.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left Banded LHS matrix.
+ * @param[in] right Pointer to an array of length equal to `left.ncol()`, containing the RHS vector.
+ * @param[out] output Pointer to an array of length equal to `left.nrow()`.
+ * On output, this stores the product `left * right`.
+ * @param options Further options.
+ */
+template<typename Value_, typename Index_, typename RightValue_, typename Output_>
+void multiply_banded_with_single_vector(
+    const BandedMatrix<Value_, Index_>& left,
+    const RightValue_* const right,
+    Output_* const output,
+    const MultiplyBandedOptions& options
+) {
+    tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+        for (Index_ i = start, end = start + length; i < end; ++i) {
+            output[i] = banded_dot_product<Value_, Index_, RightValue_, Output_>(left, i, right);
+        }
+    }, left.nrow(), options.num_threads);
+}
+
+/**
+ * @tparam Value_ Numeric type of the banded matrix value.
+ * @tparam Index_ Integer type of the banded matrix index.
+ * @tparam Right_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output arrays.
+ *
+ * @param left Banded LHS matrix.
+ * @param[in] right Vector of pointers, each of which points to an array of length equal to `left.ncol()`.
+ * @param[out] output Vector of pointers, each of which points to an array of length equal to `left.nrow()`.
+ * On output, the `i`-th entry stores the product `left * right[i]`.
+ * @param options Further options.
+ */
+template<typename Value_, typename Index_, typename Right_, typename Output_>
+void multiply_banded_with_multiple_vectors(
+    const BandedMatrix<Value_, Index_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplyBandedOptions& options
+) {
+    const auto num_vectors = right.size();
+    tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+        for (Index_ i = start, end = start + length; i < end; ++i) {
+            for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                output[v][i] = banded_dot_product<Value_, Index_, I<decltype(*right[v])>, Output_>(left, i, right[v]);
+            }
+        }
+    }, left.nrow(), options.num_threads);
+}
+
+/**
+ * Multiply a banded matrix with a **tatami** matrix.
+ * If `right` prefers row access, each row of the product is computed as a linear combination of the rows of `right` within the band.
+ * Each thread only holds a sliding window of `min(right.nrow(), left.lower_bandwidth() + left.upper_bandwidth() + 1)` rows of `right` in memory.
+ * Otherwise, each column of `right` is extracted and multiplied with `left` to obtain the corresponding column of the product.
+ * In both cases, `right` is only extracted once and is never realized in its entirety.
+ *
+ * @tparam Value_ Numeric type of the banded matrix value.
+ * @tparam Index_ Integer type of the banded matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left Banded LHS matrix.
+ * @param right RHS matrix to be multiplied.
+ * `right.nrow()` and `left.ncol()` should be equal.
+ * @param[out] output Pointer to an array of length equal to `left.nrow() * right.ncol()`.
+ * On output, this stores the product of `left` and `right` in either row- or column-major format depending on `output_row_major`.
+ * @param output_row_major Whether to store the matrix product in row-major format in `output`.
+ * @param options Further options.
+ */
+template<typename Value_, typename Index_, typename RightValue_, typename RightIndex_, typename Output_>
+void multiply_banded_with_matrix(
+    const BandedMatrix<Value_, Index_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplyBandedOptions& options
+) {
+    const Index_ NR = left.nrow();
+    const RightIndex_ NC = right.ncol();
+
+    if (!right.prefer_rows()) {
+        tatami::parallelize([&](int, RightIndex_ start, RightIndex_ length) -> void {
+            auto ext = tatami::consecutive_extractor<false>(right, false, start, length);
+            auto buffer = tatami::create_container_of_Index_size<std::vector<RightValue_> >(right.nrow());
+            auto tmp = tatami::create_container_of_Index_size<std::vector<Output_> >(output_row_major ? NR : 0);
+            for (RightIndex_ k = start, end = start + length; k < end; ++k) {
+                const auto ptr = ext->fetch(buffer.data());
+                Output_* optr = (output_row_major ? tmp.data() : output + sanisizer::product_unsafe<std::size_t>(k, NR));
+                for (Index_ i = 0; i < NR; ++i) {
+                    optr[i] = banded_dot_product<Value_, Index_, RightValue_, Output_>(left, i, ptr);
+                }
+                if (output_row_major) {
+                    for (Index_ i = 0; i < NR; ++i) {
+                        output[sanisizer::nd_offset<std::size_t>(k, NC, i)] = tmp[i];
+                    }
+                }
+            }
+        }, NC, options.num_threads);
+        return;
+    }
+
+    const std::size_t window = sanisizer::min(left.width(), right.nrow());
+    tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+        const Index_ end = start + length;
+        const Index_ required_start = left.row_range(start).first;
+        const Index_ required_end = std::max(left.row_range(end - 1).second, required_start);
+        if (required_start == required_end) {
+            for (Index_ i = start; i < end; ++i) {
+                for (RightIndex_ k = 0; k < NC; ++k) {
+                    output[output_row_major ? sanisizer::nd_offset<std::size_t>(k, NC, i) : sanisizer::nd_offset<std::size_t>(i, NR, k)] = 0;
+                }
+            }
+            return;
+        }
+
+        // Rows of 'right' are stored in a circular buffer where row 'r' occupies slot 'r % window'.
+        // As the band of each successive row of 'left' only moves forward, we never need more than 'window' rows at once.
+        auto ext = tatami::consecutive_extractor<false>(right, true, static_cast<RightIndex_>(required_start), static_cast<RightIndex_>(required_end - required_start));
+        std::vector<RightValue_> slots(sanisizer::product<typename std::vector<RightValue_>::size_type>(window, NC));
+        auto tmp = tatami::create_container_of_Index_size<std::vector<Output_> >(NC);
+        Index_ next = required_start;
+
+        for (Index_ i = start; i < end; ++i) {
+            const auto range = left.row_range(i);
+            for (; next < range.second; ++next) {
+                const auto sptr = slots.data() + sanisizer::product_unsafe<std::size_t>(static_cast<std::size_t>(next) % window, NC);
+                const auto ptr = ext->fetch(sptr);
+                if (ptr != sptr) {
+                    std::copy_n(ptr, NC, sptr);
+                }
+            }
+
+            Output_* optr = (output_row_major ? output + sanisizer::product_unsafe<std::size_t>(i, NC) : tmp.data());
+            std::fill_n(optr, NC, 0);
+            const auto vptr = left.row_values(i, range.first);
+            for (Index_ c = range.first; c < range.second; ++c) {
+                const Output_ mult = vptr[c - range.first];
+                const auto sptr = slots.data() + sanisizer::product_unsafe<std::size_t>(static_cast<std::size_t>(c) % window, NC);
+                for (RightIndex_ k = 0; k < NC; ++k) {
+                    optr[k] += mult * static_cast<Output_>(sptr[k]);
+                }
+            }
+
+            if (!output_row_major) {
+                for (RightIndex_ k = 0; k < NC; ++k) {
+                    output[sanisizer::nd_offset<std::size_t>(i, NR, k)] = tmp[k];
+                }
+            }
+        }
+    }, NR, options.num_threads);
+}
+
+/**
+ * Multiply a **tatami** matrix with a banded matrix.
+ * This is computed by multiplying the transpose of `right` with the transpose of `left` in `multiply_banded_with_matrix()`.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam Value_ Numeric type of the banded matrix value.
+ * @tparam Index_ Integer type of the banded matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right Banded RHS matrix.
+ * `right.nrow()` and `left.ncol()` should be equal.
+ * @param[out] output Pointer to an array of length equal to `left.nrow() * right.ncol()`.
+ * On output, this stores the product of `left` and `right` in either row- or column-major format depending on `output_row_major`.
+ * @param output_row_major Whether to store the matrix product in row-major format in `output`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename Value_, typename Index_, typename Output_>
+void multiply_matrix_with_banded(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const BandedMatrix<Value_, Index_>& right,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplyBandedOptions& options
+) {
+    auto tleft = tatami::make_DelayedTranspose(tatami::wrap_shared_ptr(&left));
+    multiply_banded_with_matrix(right.transpose(), *tleft, output, !output_row_major, options);
+}
+
+}
+
+#endif
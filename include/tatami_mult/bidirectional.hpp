@@ -0,0 +1,220 @@
+#ifndef TATAMI_MULT_BIDIRECTIONAL_HPP
+#define TATAMI_MULT_BIDIRECTIONAL_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <optional>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "single_vector/dispatch.hpp"
+#include "multiple_vectors/dispatch.hpp"
+#include "utils.hpp"
+
+/**
+ * @file bidirectional.hpp
+ * @brief Repeated products with a matrix and its transpose.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for the `BidirectionalOperator` constructor.
+ */
+struct BidirectionalOperatorOptions {
+    /**
+     * Whether to cache the matrix in a compressed sparse format.
+     * If unset, this is determined from `tatami::Matrix::is_sparse()`.
+     */
+    std::optional<bool> sparse;
+
+    /**
+     * Number of threads to use when caching the matrix.
+     */
+    int num_threads = 1;
+
+    /**
+     * Options to pass to `multiply_with_single_vector()`.
+     */
+    MultiplyWithSingleVectorOptions single_vector;
+
+    /**
+     * Options to pass to `multiply_with_multiple_vectors()`.
+     */
+    MultiplyWithMultipleVectorsOptions multiple_vectors;
+};
+
+/**
+ * Set the number of threads to use in `BidirectionalOperator`, both for caching and for each product.
+ *
+ * @param options Options to be set.
+ * @param num_threads Number of threads, should be positive.
+ */
+inline void set_num_threads(BidirectionalOperatorOptions& options, int num_threads) {
+    options.num_threads = num_threads;
+    set_num_threads(options.single_vector, num_threads);
+    set_num_threads(options.multiple_vectors, num_threads);
+}
+
+/**
+ * @brief Repeated products with a matrix and its transpose.
+ *
+ * Iterative methods like randomized SVD, Lanczos or subspace iteration alternate between computing \f$AX\f$ and \f$A^TY\f$ for some matrix \f$A\f$.
+ * Calling `multiply_with_multiple_vectors()` in both directions is inefficient as one of the products must extract `A` along its non-preferred dimension,
+ * and `A` itself might be expensive to extract, e.g., if it is file-backed or involves delayed operations.
+ * Instead, the `BidirectionalOperator` realizes \f$A\f$ into memory once in both row-major and column-major layouts.
+ * Only one pass is made over \f$A\f$ along its preferred dimension, and the other layout is realized from the in-memory copy.
+ * The column-major copy is wrapped in a `tatami::DelayedTranspose` so that both \f$AX\f$ and \f$A^TY\f$ can be computed by extracting rows,
+ * using the dot product-based kernels that do not need any per-thread accumulation.
+ * This doubles the memory usage compared to a single realized copy, which is usually a worthwhile trade for the faster products.
+ *
+ * Each `apply()` and `apply_transpose()` method is not thread-safe as it may reuse internal workspaces.
+ * The products themselves are parallelized according to the options supplied to the constructor.
+ *
+ * @tparam Value_ Numeric type of the matrix value.
+ * @tparam Index_ Integer type of the matrix index.
+ * @tparam Data_ Numeric type of the input and output vectors.
+ */
+template<typename Value_, typename Index_, typename Data_ = double>
+class BidirectionalOperator {
+public:
+    /**
+     * @param matrix Matrix \f$A\f$ to be cached.
+     * This is only used during construction and does not need to outlive the `BidirectionalOperator`.
+     * @param options Further options.
+     */
+    BidirectionalOperator(const tatami::Matrix<Value_, Index_>& matrix, const BidirectionalOperatorOptions& options) :
+        my_nrow(matrix.nrow()),
+        my_ncol(matrix.ncol()),
+        my_single_vector(options.single_vector),
+        my_multiple_vectors(options.multiple_vectors)
+    {
+        // Only the first copy is realized from 'matrix', along its preferred dimension, as 'matrix' might be expensive to extract.
+        // The second copy is then realized from the in-memory first copy.
+        const bool sparse = options.sparse.value_or(matrix.is_sparse());
+        const bool row = matrix.prefer_rows();
+        std::shared_ptr<const tatami::Matrix<Value_, Index_> > preferred, other;
+        if (sparse) {
+            tatami::ConvertToCompressedSparseOptions copt;
+            copt.num_threads = options.num_threads;
+            preferred = tatami::convert_to_compressed_sparse<Value_, Index_>(matrix, row, copt);
+            other = tatami::convert_to_compressed_sparse<Value_, Index_>(*preferred, !row, copt);
+        } else {
+            tatami::ConvertToDenseOptions copt;
+            copt.num_threads = options.num_threads;
+            preferred = tatami::convert_to_dense<Value_, Index_>(matrix, row, copt);
+            other = tatami::convert_to_dense<Value_, Index_>(*preferred, !row, copt);
+        }
+
+        if (row) {
+            my_forward = std::move(preferred);
+            my_transposed = tatami::make_DelayedTranspose(std::move(other));
+        } else {
+            my_forward = std::move(other);
+            my_transposed = tatami::make_DelayedTranspose(std::move(preferred));
+        }
+    }
+
+private:
+    Index_ my_nrow, my_ncol;
+    std::shared_ptr<const tatami::Matrix<Value_, Index_> > my_forward, my_transposed;
+    MultiplyWithSingleVectorOptions my_single_vector;
+    MultiplyWithMultipleVectorsOptions my_multiple_vectors;
+
+    SingleVectorWorkspace<Value_, Index_, Data_> my_single_workspace;
+    std::vector<const Data_*> my_right_ptrs;
+    std::vector<Data_*> my_output_ptrs;
+
+    void apply_internal(const tatami::Matrix<Value_, Index_>& mat, const Data_* const right, const std::size_t num_vectors, Data_* const output) {
+        const auto in_len = mat.ncol(), out_len = mat.nrow();
+        sanisizer::resize(my_right_ptrs, num_vectors);
+        sanisizer::resize(my_output_ptrs, num_vectors);
+        for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+            my_right_ptrs[v] = right + sanisizer::product_unsafe<std::size_t>(v, in_len);
+            my_output_ptrs[v] = output + sanisizer::product_unsafe<std::size_t>(v, out_len);
+        }
+        multiply_with_multiple_vectors(mat, my_right_ptrs, my_output_ptrs, my_multiple_vectors);
+    }
+
+public:
+    /**
+     * @return Number of rows in \f$A\f$.
+     */
+    Index_ nrow() const {
+        return my_nrow;
+    }
+
+    /**
+     * @return Number of columns in \f$A\f$.
+     */
+    Index_ ncol() const {
+        return my_ncol;
+    }
+
+    /**
+     * @return Cached copy of \f$A\f$ that prefers row access.
+     */
+    const std::shared_ptr<const tatami::Matrix<Value_, Index_> >& forward() const {
+        return my_forward;
+    }
+
+    /**
+     * @return Cached copy of \f$A^T\f$ that prefers row access.
+     */
+    const std::shared_ptr<const tatami::Matrix<Value_, Index_> >& transposed() const {
+        return my_transposed;
+    }
+
+public:
+    /**
+     * Compute \f$Ax\f$ for a single vector \f$x\f$.
+     *
+     * @param[in] right Pointer to an array of length equal to `ncol()`.
+     * @param[out] output Pointer to an array of length equal to `nrow()`.
+     * On output, this contains the product of \f$A\f$ and `right`.
+     */
+    void apply(const Data_* const right, Data_* const output) {
+        multiply_with_single_vector(*my_forward, right, output, my_single_vector, my_single_workspace);
+    }
+
+    /**
+     * Compute \f$AX\f$ for a block of vectors \f$X\f$.
+     *
+     * @param[in] right Pointer to a column-major array with `ncol()` rows and `num_vectors` columns.
+     * @param num_vectors Number of vectors in `right`.
+     * @param[out] output Pointer to a column-major array with `nrow()` rows and `num_vectors` columns.
+     * On output, this contains the product of \f$A\f$ and `right`.
+     */
+    void apply(const Data_* const right, const std::size_t num_vectors, Data_* const output) {
+        apply_internal(*my_forward, right, num_vectors, output);
+    }
+
+    /**
+     * Compute \f$A^Ty\f$ for a single vector \f$y\f$.
+     *
+     * @param[in] right Pointer to an array of length equal to `nrow()`.
+     * @param[out] output Pointer to an array of length equal to `ncol()`.
+     * On output, this contains the product of \f$A^T\f$ and `right`.
+     */
+    void apply_transpose(const Data_* const right, Data_* const output) {
+        multiply_with_single_vector(*my_transposed, right, output, my_single_vector, my_single_workspace);
+    }
+
+    /**
+     * Compute \f$A^TY\f$ for a block of vectors \f$Y\f$.
+     *
+     * @param[in] right Pointer to a column-major array with `nrow()` rows and `num_vectors` columns.
+     * @param num_vectors Number of vectors in `right`.
+     * @param[out] output Pointer to a column-major array with `ncol()` rows and `num_vectors` columns.
+     * On output, this contains the product of \f$A^T\f$ and `right`.
+     */
+    void apply_transpose(const Data_* const right, const std::size_t num_vectors, Data_* const output) {
+        apply_internal(*my_transposed, right, num_vectors, output);
+    }
+};
+
+}
+
+#endif
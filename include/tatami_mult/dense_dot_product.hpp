@@ -2,6 +2,7 @@
 #define TATAMI_MULT_DENSE_DOT_PRODUCT_H
 
 #include <cstddef>
+#include <cstdint>
 #include <array>
 #include <numeric>
 
@@ -20,7 +21,16 @@ namespace tatami_mult {
 
 template<std::size_t accumulators_, typename Iterator1_, typename Iterator2_, typename Output_>
 Output_ dense_dot_product(const std::size_t len, Iterator1_ start1, Iterator2_ start2, Output_ initial) {
-    if constexpr(accumulators_ == 1) {
+    if constexpr(is_small_integer<I<decltype(*start1)> > && is_small_integer<I<decltype(*start2)> >) {
+        // Exact accumulation in a widened integer, which the compiler can map onto widening multiply-add instructions.
+        // The number of accumulators is irrelevant as integer addition is associative.
+        std::int64_t dot = 0;
+        for (std::size_t i = 0; i < len; ++i) {
+            dot += static_cast<std::int64_t>(*(start1 + i)) * static_cast<std::int64_t>(*(start2 + i));
+        }
+        return initial + static_cast<Output_>(dot);
+
+    } else if constexpr(accumulators_ == 1) {
         Output_ dot = initial;
         for (std::size_t i = 0; i < len; ++i) {
             dot += static_cast<Output_>(*(start1 + i)) * static_cast<Output_>(*(start2 + i));
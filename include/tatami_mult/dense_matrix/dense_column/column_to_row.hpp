@@ -152,18 +152,14 @@ void multiply_dense_column_with_dense_column_matrix_to_row_output(
                             }
                         }
 
-                        // Transposition using square blocks of the smaller (primary) block size.
-                        RightColumns_ lrt = 0;
-                        while (lrt < lr_num) {
-                            const LeftIndex_ lrt_end = lrt + sanisizer::min(options.primary_block_size, lr_num - lrt);
-                            for (RightColumns_ rc_counter = 0; rc_counter < rc_num; ++rc_counter) {
-                                for (LeftIndex_ lrt_copy = lrt; lrt_copy < lrt_end; ++lrt_copy) {
-                                    const auto val = tmp_output[sanisizer::nd_offset<std::size_t>(lrt_copy, lr_num, rc_counter)];
-                                    outptr[sanisizer::nd_offset<std::size_t>(rc + rc_counter, right_columns, lr + lrt_copy)] += val;
-                                }
-                            }
-                            lrt = lrt_end;
-                        }
+                        transpose_tile<true>(
+                            tmp_output.data(),
+                            rc_num,
+                            lr_num,
+                            lr_num,
+                            outptr + sanisizer::nd_offset<std::size_t>(rc, right_columns, lr),
+                            right_columns
+                        );
                         std::fill_n(tmp_output.begin(), sanisizer::product_unsafe<std::size_t>(rc_num, lr_num), 0);
 
                         lr += lr_num;
@@ -180,13 +176,7 @@ void multiply_dense_column_with_dense_column_matrix_to_row_output(
     }, common_dim, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
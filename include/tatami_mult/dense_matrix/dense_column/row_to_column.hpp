@@ -160,13 +160,7 @@ void multiply_dense_column_with_dense_row_matrix_to_column_output(
     }, common_dim, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
@@ -292,13 +286,7 @@ void multiply_dense_column_with_dense_row_matrix_to_column_output(
     }, common_dim, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
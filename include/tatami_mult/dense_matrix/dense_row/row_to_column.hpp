@@ -155,18 +155,7 @@ void multiply_dense_row_with_dense_row_matrix_to_column_output(
                     cd = cd_end;
                 }
 
-                // Transposition using square blocks of the smaller (primary) block size.
-                RightColumns_ rct = 0;
-                while (rct < right_columns) {
-                    const RightColumns_ rct_end = rct + sanisizer::min(options.primary_block_size, right_columns - rct);
-                    for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-                        for (auto rct_copy = rct; rct_copy < rct_end; ++rct_copy) {
-                            const auto val = tmp_output[sanisizer::nd_offset<std::size_t>(rct_copy, right_columns, lr_counter)];
-                            output[sanisizer::nd_offset<std::size_t>(start + lr + lr_counter, left_NR, rct_copy)] = val;
-                        }
-                    }
-                    rct = rct_end;
-                }
+                transpose_tile<false>(tmp_output.data(), lr_num, right_columns, right_columns, output + start + lr, left_NR);
 
                 lr += lr_num;
             }
@@ -3,7 +3,6 @@
 
 #include <vector>
 #include <cstddef>
-#include <optional>
 
 #include "tatami/tatami.hpp"
 #include "sanisizer/sanisizer.hpp"
@@ -45,8 +44,96 @@ struct MultiplyDenseRowWithDenseRowMatrixToRowOutputOptions {
      * Different secondary block sizes will not change the results.
      */
     int secondary_block_size = 64;
+
+    /**
+     * Whether each worker should realize its own copy of `right`, in the overload for a RHS `tatami::Matrix`.
+     * Every worker reads all of `right`, so on NUMA systems, a single shared copy will be remote for the workers on other nodes.
+     * If true, each worker realizes `right` inside its own task such that the copy is placed on that worker's node by the usual first-touch policy.
+     * This increases memory usage by a factor of `num_threads` and repeats the extraction of `right` in each worker,
+     * so it is only worthwhile for large LHS matrices on multi-socket machines.
+     * Ignored if `num_threads` is not greater than 1.
+     */
+    bool replicate_right = false;
 };
 
+/**
+ * @cond
+ */
+// Creating a functor that adds the product of the next 'lr_num' LHS rows in '[start, start + length)' to a row-major 'block' with 'right_columns' columns.
+// This is also used by multiply_with_matrix_to_row_blocks() to fill each block of streamed output rows.
+template<typename Output_, typename LeftValue_, typename LeftIndex_, typename RightColumns_, class GetRightRow_>
+auto setup_dense_row_with_dense_row_matrix_to_row_blocks(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ start,
+    const LeftIndex_ length,
+    const RightColumns_ right_columns,
+    GetRightRow_ get_right_row,
+    const MultiplyDenseRowWithDenseRowMatrixToRowOutputOptions& options
+) {
+    const auto common_dim = left.ncol();
+    const LeftIndex_ max_block_rows = sanisizer::min(length, options.primary_block_size);
+    std::vector<std::vector<LeftValue_> > left_buffers;
+    left_buffers.reserve(max_block_rows);
+    for (LeftIndex_  b = 0; b < max_block_rows ; ++b) {
+        left_buffers.emplace_back(tatami::cast_Index_to_container_size<std::vector<LeftValue_> >(common_dim));
+    }
+
+    return [
+        left_ext = tatami::consecutive_extractor<false>(left, true, start, length),
+        left_buffers = std::move(left_buffers),
+        left_ptrs = tatami::create_container_of_Index_size<std::vector<const LeftValue_*> >(max_block_rows),
+        get_right_row = std::move(get_right_row),
+        common_dim,
+        right_columns,
+        primary_block_size = options.primary_block_size,
+        secondary_block_size = options.secondary_block_size
+    ](const LeftIndex_ lr_num, Output_* const block) mutable -> void {
+        for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
+            left_ptrs[lr_counter] = left_ext->fetch(left_buffers[lr_counter].data());
+        }
+
+        if (primary_block_size == 1) {
+            // Skipping the blocking altogether when we only have one row at a time.
+            const auto left_ptr = left_ptrs[0];
+            for (LeftIndex_ cd = 0; cd < common_dim; ++cd) {
+                const Output_ mult = left_ptr[cd];
+                const auto rightrow = get_right_row(cd);
+                for (RightColumns_ rc = 0; rc < right_columns; ++rc) {
+                    block[rc] += static_cast<Output_>(rightrow[rc]) * mult;
+                }
+            }
+            return;
+        }
+
+        LeftIndex_ cd = 0;
+        while (cd < common_dim) { 
+            const LeftIndex_ cd_end = cd + sanisizer::min(primary_block_size, common_dim - cd);
+            RightColumns_ rc = 0;
+            while (rc < right_columns) {
+                const RightColumns_ rc_end = rc + sanisizer::min(secondary_block_size, right_columns - rc);
+
+                for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
+                    const auto matrow = left_ptrs[lr_counter];
+                    const auto prod = block + sanisizer::product_unsafe<std::size_t>(lr_counter, right_columns);
+                    for (auto ccopy = cd; ccopy < cd_end; ++ccopy) {
+                        const auto mult = matrow[ccopy];
+                        const auto& rightrow = get_right_row(ccopy);
+                        for (auto rc_copy = rc; rc_copy < rc_end; ++rc_copy) {
+                            prod[rc_copy] += mult * rightrow[rc_copy];
+                        }
+                    }
+                }
+
+                rc = rc_end;
+            }
+            cd = cd_end;
+        }
+    };
+}
+/**
+ * @endcond
+ */
+
 /**
  * @tparam LeftValue_ Numeric type of the LHS matrix value.
  * @tparam LeftIndex_ Integer type of the LHS matrix index.
@@ -72,126 +159,16 @@ void multiply_dense_row_with_dense_row_matrix_to_row_output(
     Output_* const output,
     const MultiplyDenseRowWithDenseRowMatrixToRowOutputOptions& options
 ) {
-    const auto left_NR = left.nrow();
-    const auto common_dim = left.ncol();
-
-    const bool do_parallel = options.num_threads > 1;
-    if (!do_parallel) {
-        // Product must fit in a size_t in order for output to have been allocated correctly in the first place.
-        // Technically, right_columns could be larger than a size_t if left_NR == 0, but the product after wraparound would still be zero, so it's fine.
-        std::fill_n(output, sanisizer::product_unsafe<std::size_t>(right_columns, left_NR), 0);
-    }
-
-    if (options.primary_block_size == 1) {
-        tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-            auto ext = tatami::consecutive_extractor<false>(left, true, start, length);
-            auto buffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(common_dim);
-
-            // Use a temporary buffer for each output row to mitigate false sharing during updates across all 'c'.
-            // There is still some false sharing when we transfer the results to the output row,
-            // but this is fine as it is outside of the innermost loop.
-            std::optional<std::vector<Output_> > tmp_output;
-            if (do_parallel) {
-                tmp_output.emplace(tatami::cast_Index_to_container_size<std::vector<Output_> >(right_columns));
-            }
-
-            for (LeftIndex_ lr = 0; lr < length; ++lr) {
-                const auto left_ptr = ext->fetch(buffer.data());
-                const auto optr = output + sanisizer::product_unsafe<std::size_t>(start + lr, right_columns);
-
-                Output_* tmp_optr;
-                if (!do_parallel) {
-                    tmp_optr = optr;
-                } else {
-                    tmp_optr = tmp_output->data();
-                }
-
-                for (LeftIndex_ cd = 0; cd < common_dim; ++cd) {
-                    const Output_ mult = left_ptr[cd];
-                    const auto rightrow = get_right_row(cd);
-                    for (RightColumns_ rc = 0; rc < right_columns; ++rc) {
-                        tmp_optr[rc] += static_cast<Output_>(rightrow[rc]) * mult;
-                    }
-                }
-
-                if (do_parallel) {
-                    std::copy_n(tmp_optr, right_columns, optr);
-                    std::fill_n(tmp_optr, right_columns, 0);
-                }
-            }
-        }, left_NR, options.num_threads);
-
-    } else {
-        tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-            auto left_ext = tatami::consecutive_extractor<false>(left, true, start, length);
-            std::vector<std::vector<LeftValue_> > left_buffers;
-            std::vector<const LeftValue_*> left_ptrs;
-
-            std::optional<std::vector<Output_> > tmp_output;
-            {
-                const LeftIndex_ max_block_rows = sanisizer::min(length, options.primary_block_size);
-                left_buffers.reserve(max_block_rows);
-                for (LeftIndex_  b = 0; b < max_block_rows ; ++b) {
-                    left_buffers.emplace_back(tatami::cast_Index_to_container_size<std::vector<LeftValue_> >(common_dim));
-                }
-                sanisizer::resize(left_ptrs, max_block_rows);
-
-                // Creating a block to hold the output during the updates over all 'c', to avoid false sharing.
-                // We should be able to hold the block size in a size_t safely here, as this block is no larger than the array referenced by 'output'.
-                // Of course, we might get an error if the vector's size_type is smaller than size_t but that seems a bit pathological.
-                if (do_parallel) {
-                    tmp_output.emplace(sanisizer::product<I<decltype(tmp_output->size())> >(max_block_rows, right_columns));
-                }
-            }
-
-            LeftIndex_ lr = 0;
-            while (lr < length) {
-                const LeftIndex_ lr_num = sanisizer::min(options.primary_block_size, length - lr);
-                for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-                    left_ptrs[lr_counter] = left_ext->fetch(left_buffers[lr_counter].data());
-                }
-
-                Output_* const optr = output + sanisizer::product_unsafe<std::size_t>(start + lr, right_columns);
-                Output_* tmp_optr;
-                if (!do_parallel) {
-                    tmp_optr = optr;
-                } else {
-                    tmp_optr = tmp_output->data();
-                }
-
-                LeftIndex_ cd = 0;
-                while (cd < common_dim) { 
-                    const LeftIndex_ cd_end = cd + sanisizer::min(options.primary_block_size, common_dim - cd);
-                    RightColumns_ rc = 0;
-                    while (rc < right_columns) {
-                        const RightColumns_ rc_end = rc + sanisizer::min(options.secondary_block_size, right_columns - rc);
-
-                        for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-                            const auto matrow = left_ptrs[lr_counter];
-                            const auto prod = tmp_optr + sanisizer::product_unsafe<std::size_t>(lr_counter, right_columns);
-                            for (auto ccopy = cd; ccopy < cd_end; ++ccopy) {
-                                const auto mult = matrow[ccopy];
-                                const auto& rightrow = get_right_row(ccopy);
-                                for (auto rc_copy = rc; rc_copy < rc_end; ++rc_copy) {
-                                    prod[rc_copy] += mult * rightrow[rc_copy];
-                                }
-                            }
-                        }
-
-                        rc = rc_end;
-                    }
-                    cd = cd_end;
-                }
-
-                if (do_parallel) {
-                    const auto out_space = sanisizer::product_unsafe<std::size_t>(lr_num, right_columns);
-                    std::copy_n(tmp_optr, out_space, optr);
-                    std::fill_n(tmp_optr, out_space, 0);
-                }
-                lr += lr_num;
-            }
-        }, left_NR, options.num_threads);
-    }
+    compute_row_blocks_to_row_output(
+        left.nrow(),
+        right_columns,
+        options.primary_block_size,
+        [&](const LeftIndex_ start, const LeftIndex_ length) {
+            return setup_dense_row_with_dense_row_matrix_to_row_blocks<Output_>(left, start, length, right_columns, get_right_row, options);
+        },
+        output,
+        options.num_threads
+    );
 }
 
 /**
@@ -222,9 +199,34 @@ void multiply_dense_row_with_dense_row_matrix_to_row_output(
     const MultiplyDenseRowWithDenseRowMatrixToRowOutputOptions& options
 ) {
     const auto common_dim = left.ncol();
+    const auto right_NC = right.ncol();
+
+    if (options.replicate_right && options.num_threads > 1) {
+        compute_row_blocks_to_row_output(
+            left.nrow(),
+            right_NC,
+            options.primary_block_size,
+            [&](const LeftIndex_ start, const LeftIndex_ length) {
+                // This is called inside each worker, so the copy is allocated and first touched by the worker that reads it.
+                return setup_dense_row_with_dense_row_matrix_to_row_blocks<Output_>(
+                    left,
+                    start,
+                    length,
+                    right_NC,
+                    [local = realize_dense_rows(right), right_NC](const LeftIndex_ cd) -> const RightValue_* {
+                        return local.data() + sanisizer::product_unsafe<std::size_t>(cd, right_NC);
+                    },
+                    options
+                );
+            },
+            output,
+            options.num_threads
+        );
+        return;
+    }
+
     auto right_buffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(common_dim);
     auto right_ptrs = tatami::create_container_of_Index_size<std::vector<const RightValue_*> >(common_dim);
-    const auto right_NC = right.ncol();
     populate_dense_buffers(true, common_dim, right_NC, right, right_buffers, right_ptrs, options.num_threads);
 
     multiply_dense_row_with_dense_row_matrix_to_row_output(
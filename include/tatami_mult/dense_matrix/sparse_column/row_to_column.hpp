@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <vector>
 #include <optional>
+#include <memory>
 
 #include "tatami/tatami.hpp"
 #include "sanisizer/sanisizer.hpp"
@@ -36,6 +37,16 @@ struct MultiplySparseColumnWithDenseRowMatrixToColumnOutputOptions {
      * See the \f$B\f$ parameter in the @ref sparse-blocking "Blocking for sparse matrices" section for more details.
      */
     int block_size = 16;
+
+    /**
+     * Whether to perform a structure-only pass over `left` to identify its non-empty columns before the multiplication.
+     * If true, only the non-empty LHS columns and the corresponding RHS rows are extracted, by supplying an oracle for only those indices to both extractors.
+     * This avoids extracting RHS rows that would be discarded, which is useful for file-backed matrices with expensive extraction.
+     * The pre-pass reads the structure of `left` twice, so it is only worthwhile if `left` is cheap to re-read and the extraction of `right` is expensive.
+     * If unset, the pre-pass is only performed if `left.uses_oracle(false)` is false (e.g., `left` is in memory) and `right.uses_oracle(true)` is true (e.g., `right` is file-backed).
+     * Only used in the overload that accepts a `tatami::Matrix` for `right`.
+     */
+    std::optional<bool> prepass_non_empty;
 };
 
 /**
@@ -184,13 +195,7 @@ void multiply_sparse_column_with_dense_row_matrix_to_column_output(
     }, common_dim, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
@@ -231,9 +236,23 @@ void multiply_sparse_column_with_dense_row_matrix_to_column_output(
         tmp_results.emplace(sanisizer::cast<I<decltype(tmp_results->size())> >(options.num_threads - 1));
     }
 
+    const bool prepass = options.prepass_non_empty.value_or(!left.uses_oracle(false) && right.uses_oracle(true));
     const auto num_used = tatami::parallelize([&](int t, LeftIndex_ start, LeftIndex_ length) -> void {
-        auto left_ext = tatami::consecutive_extractor<true>(left, false, start, length);
-        auto right_ext = tatami::consecutive_extractor<false>(right, true, start, length);
+        // Both extractors must be in sync along the common dimension, so if we skip the empty LHS columns, we must also skip the corresponding RHS rows.
+        LeftIndex_ num_fetch = length;
+        std::shared_ptr<const tatami::Oracle<LeftIndex_> > left_oracle;
+        std::shared_ptr<const tatami::Oracle<RightIndex_> > right_oracle;
+        if (prepass) {
+            auto non_empty = find_non_empty_sparse_vectors(left, false, start, length);
+            num_fetch = non_empty.size();
+            right_oracle.reset(new tatami::FixedVectorOracle<RightIndex_>(std::vector<RightIndex_>(non_empty.begin(), non_empty.end())));
+            left_oracle.reset(new tatami::FixedVectorOracle<LeftIndex_>(std::move(non_empty)));
+        } else {
+            left_oracle.reset(new tatami::ConsecutiveOracle<LeftIndex_>(start, length));
+            right_oracle.reset(new tatami::ConsecutiveOracle<RightIndex_>(start, length));
+        }
+        auto left_ext = tatami::new_extractor<true, true>(left, false, std::move(left_oracle));
+        auto right_ext = tatami::new_extractor<false, true>(right, true, std::move(right_oracle));
 
         std::optional<std::vector<Output_> > tmp_output;
         Output_* outptr; 
@@ -249,7 +268,7 @@ void multiply_sparse_column_with_dense_row_matrix_to_column_output(
             auto ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(left_NR);
             auto dbuffer = tatami::create_container_of_Index_size<std::vector<RightValue_> >(right_NC);
 
-            for (LeftIndex_ cd = 0; cd < length; ++cd) {
+            for (LeftIndex_ cd = 0; cd < num_fetch; ++cd) {
                 const auto lrange = left_ext->fetch(vbuffer.data(), ibuffer.data());
                 const auto rptr = right_ext->fetch(dbuffer.data());
 
@@ -276,7 +295,7 @@ void multiply_sparse_column_with_dense_row_matrix_to_column_output(
             std::vector<std::vector<RightValue_> > right_dbuffers;
             std::vector<const RightValue_*> right_ptrs;
             {
-                const LeftIndex_ max_block_cols = sanisizer::min(length, options.block_size);
+                const LeftIndex_ max_block_cols = sanisizer::min(num_fetch, options.block_size);
                 left_vbuffers.reserve(max_block_cols);
                 left_ibuffers.reserve(max_block_cols);
                 right_dbuffers.reserve(max_block_cols);
@@ -290,7 +309,7 @@ void multiply_sparse_column_with_dense_row_matrix_to_column_output(
             }
 
             LeftIndex_ cd = 0;
-            while (cd < length) {
+            while (cd < num_fetch) {
                 // Only processing LHS columns (and the corresponding RHS rows) if the LHS column has some structural non-zeros.
                 // If not, we just skip it altogether; no need to zero or do anything else, as we're skipping the corresponding RHS row too.
                 LeftIndex_ cd_num = 0;
@@ -312,7 +331,7 @@ void multiply_sparse_column_with_dense_row_matrix_to_column_output(
                     if (sanisizer::is_equal(cd_num, options.block_size)) {
                         break;
                     }
-                } while (cd < length);
+                } while (cd < num_fetch);
 
                 for (RightIndex_ rc = 0; rc < right_NC; ++rc) {
                     for (LeftIndex_ cd_counter = 0; cd_counter < cd_num; ++cd_counter) {
@@ -332,13 +351,7 @@ void multiply_sparse_column_with_dense_row_matrix_to_column_output(
     }, common_dim, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
@@ -36,6 +36,7 @@ struct MultiplySparseRowWithDenseRowMatrixToColumnOutputOptions {
      * Block size, i.e., the number of LHS rows to use at once.
      * The matrix product is computed for the submatrix consisting of each block of rows,
      * and then transposed for storage in the column-major output array.
+     * This only determines the number of rows in each submatrix, not the tiles used in the transposition, which are chosen recursively to fit in cache.
      *
      * The block size should be positive.
      * Larger values generally improve speed at the cost of increased memory usage.
@@ -140,17 +141,7 @@ void multiply_sparse_row_with_dense_row_matrix_to_column_output(
                 // Now doing a blocked transposition.
                 // This is, in fact, the only purpose of the blocking here.
                 // We do this even if there were no non-empty LHS rows, because we have to zero the output array anyway.
-                RightColumns_ rc = 0;
-                while (rc < right_columns) {
-                    const RightColumns_ rcend = rc + sanisizer::min(options.block_size, right_columns - rc);
-                    for (LeftIndex_ lrcopy = 0; lrcopy < lrnum; ++lrcopy) {
-                        for (auto rcopy = rc; rcopy < rcend; ++rcopy) {
-                            const auto val = tmp_output[sanisizer::nd_offset<std::size_t>(rcopy, right_columns, lrcopy)];
-                            output[sanisizer::nd_offset<std::size_t>(start + lr + lrcopy, left_NR, rcopy)] = val;
-                        }
-                    }
-                    rc = rcend;
-                }
+                transpose_tile<false>(tmp_output.data(), lrnum, right_columns, right_columns, output + start + lr, left_NR);
 
                 // Too much effort to track individual non-empty rows, but if they're all empty, we skip the zeroing.
                 // If a few are non-empty, a single memset call is probably faster anyway than splitting it up.
@@ -31,8 +31,56 @@ struct MultiplySparseRowWithDenseRowMatrixToRowOutputOptions {
      * Different numbers of threads will not change the results. 
      */
     int num_threads = 1;
+
+    /**
+     * Whether each worker should realize its own copy of `right`, in the overload for a RHS `tatami::Matrix`.
+     * Every worker reads all of `right`, so on NUMA systems, a single shared copy will be remote for the workers on other nodes.
+     * If true, each worker realizes `right` inside its own task such that the copy is placed on that worker's node by the usual first-touch policy.
+     * This increases memory usage by a factor of `num_threads` and repeats the extraction of `right` in each worker,
+     * so it is only worthwhile for large LHS matrices on multi-socket machines.
+     * Ignored if `num_threads` is not greater than 1.
+     */
+    bool replicate_right = false;
 };
 
+/**
+ * @cond
+ */
+// Creating a functor that adds the product of the next 'lr_num' LHS rows in '[start, start + length)' to a row-major 'block' with 'right_columns' columns.
+// This is also used by multiply_with_matrix_to_row_blocks() to fill each block of streamed output rows.
+template<typename Output_, typename LeftValue_, typename LeftIndex_, typename RightColumns_, class GetRightRow_>
+auto setup_sparse_row_with_dense_row_matrix_to_row_blocks(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ start,
+    const LeftIndex_ length,
+    const RightColumns_ right_columns,
+    GetRightRow_ get_right_row
+) {
+    const auto common_dim = left.ncol();
+    return [
+        ext = tatami::consecutive_extractor<true>(left, true, start, length),
+        vbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(common_dim),
+        ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(common_dim),
+        get_right_row = std::move(get_right_row),
+        right_columns
+    ](const LeftIndex_ lr_num, Output_* const block) mutable -> void {
+        for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
+            const auto range = ext->fetch(vbuffer.data(), ibuffer.data());
+            const auto optr = block + sanisizer::product_unsafe<std::size_t>(lr_counter, right_columns);
+            for (LeftIndex_ x = 0; x < range.number; ++x) {
+                const auto rightrow = get_right_row(range.index[x]);
+                const auto mult = range.value[x];
+                for (RightColumns_ rc = 0; rc < right_columns; ++rc) {
+                    optr[rc] += mult * rightrow[rc];
+                }
+            }
+        }
+    };
+}
+/**
+ * @endcond
+ */
+
 /**
  * @tparam LeftValue_ Numeric type of the LHS matrix value.
  * @tparam LeftIndex_ Integer type of the LHS matrix index.
@@ -58,49 +106,16 @@ void multiply_sparse_row_with_dense_row_matrix_to_row_output(
     Output_* const output,
     const MultiplySparseRowWithDenseRowMatrixToRowOutputOptions& options
 ) {
-    const auto left_NR = left.nrow();
-    const auto common_dim = left.ncol();
-
-    const bool do_parallel = options.num_threads > 1;
-    if (!do_parallel) {
-        std::fill_n(output, sanisizer::product_unsafe<std::size_t>(left_NR, right_columns), 0);
-    }
-
-    tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-        auto ext = tatami::consecutive_extractor<true>(left, true, start, length);
-        auto vbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(common_dim);
-        auto ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(common_dim);
-
-        std::optional<std::vector<Output_> > tmp_output;
-        if (do_parallel) {
-            tmp_output.emplace(tatami::cast_Index_to_container_size<std::vector<Output_> >(right_columns));
-        }
-
-        for (LeftIndex_ lr = 0; lr < length; ++lr) {
-            const auto range = ext->fetch(vbuffer.data(), ibuffer.data());
-            const auto optr =  output + sanisizer::product_unsafe<std::size_t>(start + lr, right_columns);
-            const auto tmp_optr = (do_parallel ? tmp_output->data() : optr);
-
-            for (LeftIndex_ x = 0; x < range.number; ++x) {
-                const auto rightrow = get_right_row(range.index[x]);
-                const auto mult = range.value[x];
-                for (RightColumns_ rc = 0; rc < right_columns; ++rc) {
-                    tmp_optr[rc] += mult * rightrow[rc];
-                }
-            }
-
-            if (do_parallel) {
-                if (range.number == 0) {
-                    // If it's empty, we would have never modified the temporary buffer,
-                    // so we can proceed to directly zeroing the output array.
-                    std::fill_n(optr, right_columns, 0);
-                } else {
-                    std::copy_n(tmp_output->data(), right_columns, optr);
-                    std::fill_n(tmp_output->data(), right_columns, 0);
-                }
-            }
-        }
-    }, left_NR, options.num_threads);
+    compute_row_blocks_to_row_output(
+        left.nrow(),
+        right_columns,
+        1,
+        [&](const LeftIndex_ start, const LeftIndex_ length) {
+            return setup_sparse_row_with_dense_row_matrix_to_row_blocks<Output_>(left, start, length, right_columns, get_right_row);
+        },
+        output,
+        options.num_threads
+    );
 }
 
 /**
@@ -131,9 +146,33 @@ void multiply_sparse_row_with_dense_row_matrix_to_row_output(
     const MultiplySparseRowWithDenseRowMatrixToRowOutputOptions& options
 ) {
     const auto common_dim = left.ncol();
+    const auto right_NC = right.ncol();
+
+    if (options.replicate_right && options.num_threads > 1) {
+        compute_row_blocks_to_row_output(
+            left.nrow(),
+            right_NC,
+            1,
+            [&](const LeftIndex_ start, const LeftIndex_ length) {
+                // This is called inside each worker, so the copy is allocated and first touched by the worker that reads it.
+                return setup_sparse_row_with_dense_row_matrix_to_row_blocks<Output_>(
+                    left,
+                    start,
+                    length,
+                    right_NC,
+                    [local = realize_dense_rows(right), right_NC](const LeftIndex_ cd) -> const RightValue_* {
+                        return local.data() + sanisizer::product_unsafe<std::size_t>(cd, right_NC);
+                    }
+                );
+            },
+            output,
+            options.num_threads
+        );
+        return;
+    }
+
     auto right_buffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(common_dim);
     auto right_ptrs = tatami::create_container_of_Index_size<std::vector<const RightValue_*> >(common_dim);
-    const auto right_NC = right.ncol();
     populate_dense_buffers(true, common_dim, right_NC, right, right_buffers, right_ptrs, options.num_threads);
 
     multiply_sparse_row_with_dense_row_matrix_to_row_output(
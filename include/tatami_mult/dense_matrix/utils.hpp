@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <optional>
+#include <algorithm>
+#include <cstddef>
 
 #include "tatami/tatami.hpp"
 #include "sanisizer/sanisizer.hpp"
@@ -21,6 +23,8 @@ void populate_dense_buffers(
     std::vector<const Value_*>& all_ptrs,
     int num_threads
 ) {
+    // Each worker allocates and fills the buffers for its own range of vectors.
+    // Note that this does not improve NUMA locality for kernels where every worker reads all of the vectors, see realize_dense_rows() instead.
     tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
         std::vector<Value_> tmp;
         sanisizer::reserve(tmp, secondary);
@@ -40,4 +44,25 @@ void populate_dense_buffers(
 
 }
 
+// Realizing all rows of 'matrix' into a contiguous row-major array.
+// This is intended to be called inside each worker to create a worker-local copy of the RHS,
+// so that the copy is allocated and first touched by the worker that reads it, i.e., it is placed on that worker's NUMA node.
+template<typename Value_, typename Index_>
+std::vector<Value_> realize_dense_rows(const tatami::Matrix<Value_, Index_>& matrix) {
+    const auto NR = matrix.nrow();
+    const auto NC = matrix.ncol();
+    std::vector<Value_> output(sanisizer::product<typename std::vector<Value_>::size_type>(NR, NC));
+    auto ext = tatami::consecutive_extractor<false>(matrix, true, static_cast<Index_>(0), NR);
+    for (Index_ r = 0; r < NR; ++r) {
+        const auto dest = output.data() + sanisizer::product_unsafe<std::size_t>(r, NC);
+        const auto ptr = ext->fetch(dest);
+        if (ptr != dest) {
+            std::copy_n(ptr, NC, dest);
+        }
+    }
+    return output;
+}
+
+}
+
 #endif
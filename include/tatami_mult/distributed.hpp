@@ -0,0 +1,470 @@
+#ifndef TATAMI_MULT_DISTRIBUTED_HPP
+#define TATAMI_MULT_DISTRIBUTED_HPP
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "tatami_mult.hpp"
+#include "utils.hpp"
+
+/**
+ * @file distributed.hpp
+ * @brief Multiplication of matrices that are partitioned by row across multiple processes.
+ *
+ * This header is not included by `tatami_mult.hpp` and should be included separately.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Interface for collective communication between processes.
+ *
+ * This abstracts away the details of the communication library (e.g., MPI) from the distributed multiplication functions.
+ * Each process holds its own `Communicator` instance, and all processes must call the same collective operations in the same order.
+ *
+ * Collective operations are split into a `start_*()` call and a `wait()` call, so that communication can be overlapped with computation.
+ * At most one operation can be in flight for each `Communicator` at any given time, i.e., `wait()` must be called before the next `start_*()`.
+ * For MPI, implementations would typically call `MPI_Iallreduce()` or `MPI_Iallgatherv()` in `start_*()` and `MPI_Wait()` in `wait()`.
+ * Implementations are free to defer all communication to `wait()`.
+ *
+ * @tparam Value_ Numeric type of the values to be communicated.
+ */
+template<typename Value_>
+class Communicator {
+public:
+    /**
+     * @cond
+     */
+    Communicator() = default;
+    Communicator(const Communicator&) = default;
+    Communicator(Communicator&&) = default;
+    Communicator& operator=(const Communicator&) = default;
+    Communicator& operator=(Communicator&&) = default;
+    virtual ~Communicator() = default;
+    /**
+     * @endcond
+     */
+
+    /**
+     * @return Rank of the current process, from 0 to `size() - 1`.
+     */
+    virtual int rank() const = 0;
+
+    /**
+     * @return Number of processes.
+     */
+    virtual int size() const = 0;
+
+    /**
+     * Blocking all-gather of a single count from each process.
+     *
+     * @param count Count for the current process.
+     * @return Vector of length equal to `size()`, containing the count from each process in order of rank.
+     */
+    virtual std::vector<std::size_t> all_gather_counts(std::size_t count) = 0;
+
+    /**
+     * Start an in-place all-reduce, i.e., the elementwise sum of `buffer` across all processes.
+     * Upon completion of `wait()`, `buffer` contains the sum on all processes.
+     *
+     * @param buffer Pointer to an array of length `length`.
+     * This should not be accessed until `wait()` returns.
+     * @param length Length of the array, which should be the same on all processes.
+     */
+    virtual void start_all_reduce_sum(Value_* buffer, std::size_t length) = 0;
+
+    /**
+     * Start an all-gather, i.e., the concatenation of each process's `buffer` in order of rank.
+     * Upon completion of `wait()`, `output` contains the concatenated buffers on all processes.
+     *
+     * @param buffer Pointer to an array of length `counts[rank()]`.
+     * This should not be modified until `wait()` returns.
+     * @param counts Vector of length equal to `size()`, containing the number of elements contributed by each process.
+     * This should be the same on all processes.
+     * @param[out] output Pointer to an array of length equal to the sum of `counts`.
+     * This should not be accessed until `wait()` returns.
+     */
+    virtual void start_all_gather(const Value_* buffer, const std::vector<std::size_t>& counts, Value_* output) = 0;
+
+    /**
+     * Wait for the operation started by the last `start_*()` call to complete.
+     * This should be a no-op if no operation is in flight.
+     */
+    virtual void wait() = 0;
+};
+
+/**
+ * @cond
+ */
+template<typename Value_>
+struct LocalCommunicatorState {
+    LocalCommunicatorState(const int size) : size(size) {
+        sanisizer::resize(slots, size);
+        sanisizer::resize(counts, size);
+    }
+
+    int size;
+    std::vector<const Value_*> slots;
+    std::vector<std::size_t> counts;
+
+    std::mutex lock;
+    std::condition_variable cv;
+    int arrived = 0;
+    std::size_t generation = 0;
+
+    void barrier() {
+        std::unique_lock<std::mutex> lck(lock);
+        const auto current = generation;
+        ++arrived;
+        if (arrived == size) {
+            arrived = 0;
+            ++generation;
+            cv.notify_all();
+        } else {
+            cv.wait(lck, [&]() -> bool { return generation != current; });
+        }
+    }
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @brief In-process stand-in for a `Communicator`.
+ *
+ * This simulates multiple processes with threads in the same process, where each thread uses its own `LocalCommunicator` from `create_local_communicators()`.
+ * It is primarily intended for testing and for prototyping distributed workflows on a single machine without a communication library.
+ * All communication is performed in `wait()`, which blocks until all threads have called it.
+ *
+ * @tparam Value_ Numeric type of the values to be communicated.
+ */
+template<typename Value_>
+class LocalCommunicator final : public Communicator<Value_> {
+public:
+    /**
+     * @cond
+     */
+    LocalCommunicator(std::shared_ptr<LocalCommunicatorState<Value_> > state, const int rank) : my_state(std::move(state)), my_rank(rank) {}
+    /**
+     * @endcond
+     */
+
+private:
+    std::shared_ptr<LocalCommunicatorState<Value_> > my_state;
+    int my_rank;
+
+    enum class Pending : char { NONE, REDUCE, GATHER };
+    Pending my_pending = Pending::NONE;
+    Value_* my_reduce_buffer = NULL;
+    std::size_t my_reduce_length = 0;
+    const Value_* my_gather_buffer = NULL;
+    const std::vector<std::size_t>* my_gather_counts = NULL;
+    Value_* my_gather_output = NULL;
+    std::vector<Value_> my_workspace;
+
+public:
+    int rank() const {
+        return my_rank;
+    }
+
+    int size() const {
+        return my_state->size;
+    }
+
+    std::vector<std::size_t> all_gather_counts(const std::size_t count) {
+        auto& state = *my_state;
+        state.counts[my_rank] = count;
+        state.barrier();
+        std::vector<std::size_t> output(state.counts);
+        state.barrier();
+        return output;
+    }
+
+    void start_all_reduce_sum(Value_* const buffer, const std::size_t length) {
+        my_pending = Pending::REDUCE;
+        my_reduce_buffer = buffer;
+        my_reduce_length = length;
+    }
+
+    void start_all_gather(const Value_* const buffer, const std::vector<std::size_t>& counts, Value_* const output) {
+        my_pending = Pending::GATHER;
+        my_gather_buffer = buffer;
+        my_gather_counts = &counts;
+        my_gather_output = output;
+    }
+
+    void wait() {
+        auto& state = *my_state;
+
+        if (my_pending == Pending::REDUCE) {
+            state.slots[my_rank] = my_reduce_buffer;
+            state.barrier();
+
+            // Summing in order of rank so that all processes get exactly the same result.
+            my_workspace.resize(my_reduce_length);
+            std::fill(my_workspace.begin(), my_workspace.end(), 0);
+            for (int r = 0; r < state.size; ++r) {
+                const auto src = state.slots[r];
+                for (std::size_t i = 0; i < my_reduce_length; ++i) {
+                    my_workspace[i] += src[i];
+                }
+            }
+
+            // Only overwriting our buffer after all other processes are done reading it.
+            state.barrier();
+            std::copy(my_workspace.begin(), my_workspace.end(), my_reduce_buffer);
+
+        } else if (my_pending == Pending::GATHER) {
+            state.slots[my_rank] = my_gather_buffer;
+            state.barrier();
+
+            const auto& counts = *my_gather_counts;
+            auto outptr = my_gather_output;
+            for (int r = 0; r < state.size; ++r) {
+                std::copy_n(state.slots[r], counts[r], outptr);
+                outptr += counts[r];
+            }
+
+            state.barrier();
+        }
+
+        my_pending = Pending::NONE;
+    }
+};
+
+/**
+ * Create a set of `LocalCommunicator` instances that communicate with each other.
+ * Each instance should be used by a different thread.
+ *
+ * @tparam Value_ Numeric type of the values to be communicated.
+ * @param size Number of simulated processes.
+ * @return Vector of length `size`, where the `i`-th entry is the communicator for rank `i`.
+ */
+template<typename Value_>
+std::vector<LocalCommunicator<Value_> > create_local_communicators(const int size) {
+    auto state = std::make_shared<LocalCommunicatorState<Value_> >(size);
+    std::vector<LocalCommunicator<Value_> > output;
+    output.reserve(size);
+    for (int r = 0; r < size; ++r) {
+        output.emplace_back(state, r);
+    }
+    return output;
+}
+
+/**
+ * @brief Options for `multiply_distributed_with_matrix()` and `multiply_distributed_transpose_with_matrix()`.
+ */
+struct MultiplyDistributedOptions {
+    /**
+     * Number of output rows in each all-gather in `multiply_distributed_with_matrix()`.
+     * Smaller values reduce the size of each message and allow the all-gather of one chunk to overlap with the computation of the next,
+     * but increase the number of collective operations.
+     * This is not used by `multiply_distributed_transpose_with_matrix()`, which performs a single all-reduce after the local product is complete.
+     * Non-positive values are treated as 1.
+     */
+    int chunk_size = 64;
+
+    /**
+     * Options for computing the local contribution in `multiply_distributed_transpose_with_matrix()`.
+     */
+    MultiplyWithMatrixOptions multiply;
+
+    /**
+     * Options for computing the local contribution in `multiply_distributed_with_matrix()`.
+     * `MultiplyWithMatrixToRowBlocksOptions::ordered_block_size` is independent of `chunk_size`,
+     * i.e., each computed block is re-split into chunks of `chunk_size` rows for the all-gathers.
+     */
+    MultiplyWithMatrixToRowBlocksOptions row_blocks;
+};
+
+/**
+ * Compute the product of `t(A)` and `B`, where both `A` and `B` are partitioned by row across multiple processes.
+ * Each process supplies its own row slices `left` and `right`, which should contain the same rows of `A` and `B`, respectively.
+ * The local contribution `t(left) * right` is computed with a single call to `multiply_with_matrix()` and summed across all processes with an all-reduce.
+ * This is commonly used to compute cross-products or projections, e.g., `t(X) * X` or `t(X) * Y` for a large number of observations.
+ *
+ * The all-reduce is performed once over the entire `output`, after the local contribution is complete.
+ * We do not compute the local contribution in chunks, as each chunk would require another pass through `left` or `right`;
+ * this is much more expensive than any savings from overlapping communication with computation.
+ * Without such overlap, splitting the all-reduce into chunks would only add more collective operations.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left Row slice of `A` on the current process.
+ * The number of columns should be the same across all processes.
+ * @param right Row slice of `B` on the current process.
+ * This should have the same number of rows as `left`, and the number of columns should be the same across all processes.
+ * @param comm Communicator for the current process.
+ * @param[out] output Pointer to an array of length equal to `left.ncol() * right.ncol()`.
+ * On output, this stores the product `t(A) * B` on all processes.
+ * @param row_major Whether to store the product in row-major format.
+ * If false, the product is stored in column-major format.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void multiply_distributed_transpose_with_matrix(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Communicator<Output_>& comm,
+    Output_* const output,
+    const bool row_major,
+    const MultiplyDistributedOptions& options
+) {
+    auto tleft = tatami::make_DelayedTranspose(tatami::wrap_shared_ptr(&left));
+    multiply_with_matrix(*tleft, right, output, row_major, options.multiply);
+
+    // All processes have the same output dimensions, so the all-reduce has the same length everywhere.
+    comm.start_all_reduce_sum(output, sanisizer::product<std::size_t>(left.ncol(), right.ncol()));
+    comm.wait();
+}
+
+/**
+ * Compute the product of `A` and `B`, where `A` is partitioned by row across multiple processes and `B` is available on all processes.
+ * Each process computes the product of its row slice `left` with `right` using `multiply_with_matrix_to_ordered_row_blocks()`,
+ * and the results are concatenated across processes with an all-gather.
+ *
+ * The local product is streamed in blocks of `MultiplyWithMatrixToRowBlocksOptions::ordered_block_size` rows, requiring only a single pass through `left`.
+ * The rows of each block are then all-gathered in chunks of `MultiplyDistributedOptions::chunk_size` rows.
+ * Each all-gather is started as soon as its chunk is complete, and is overlapped with the copying of the next chunk and the computation of the next block.
+ * Processes with fewer rows in `left` will contribute empty blocks to the later all-gathers, so that all processes perform the same number of collective operations.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left Row slice of `A` on the current process.
+ * Slices should be ordered by rank, i.e., the rows on rank 0 come first, followed by those on rank 1, etc.
+ * @param right The RHS matrix `B`, which should be the same on all processes.
+ * The number of rows should be equal to the number of columns in `left`.
+ * @param comm Communicator for the current process.
+ * @param[out] output Pointer to an array of length equal to the product of the total number of rows of `A` and `right.ncol()`.
+ * On output, this stores the product `A * B` on all processes.
+ * @param row_major Whether to store the product in row-major format.
+ * If false, the product is stored in column-major format.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void multiply_distributed_with_matrix(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Communicator<Output_>& comm,
+    Output_* const output,
+    const bool row_major,
+    const MultiplyDistributedOptions& options
+) {
+    const auto out_NC = sanisizer::cast<std::size_t>(right.ncol());
+    const auto local_NR = sanisizer::cast<std::size_t>(left.nrow());
+    const auto all_NR = comm.all_gather_counts(local_NR);
+    const auto nranks = all_NR.size();
+
+    std::vector<std::size_t> offsets;
+    offsets.reserve(nranks);
+    std::size_t total_NR = 0, max_NR = 0;
+    for (const auto n : all_NR) {
+        offsets.push_back(total_NR);
+        total_NR = sanisizer::sum<std::size_t>(total_NR, n);
+        max_NR = std::max(max_NR, n);
+    }
+
+    // All processes need to perform the same number of all-gathers, so we use the largest slice to define the number of rounds.
+    const std::size_t chunk_size = std::max(options.chunk_size, 1);
+    const std::size_t num_rounds = (max_NR ? (max_NR - 1) / chunk_size + 1 : 0);
+    const auto max_chunk = std::min(chunk_size, max_NR);
+
+    // Double-buffering the local and gathered chunks so that we can compute the next chunk while the previous one is in flight.
+    std::vector<Output_> local[2], gathered[2];
+    for (int b = 0; b < 2; ++b) {
+        local[b].resize(sanisizer::product<typename std::vector<Output_>::size_type>(std::min(chunk_size, local_NR), out_NC));
+        gathered[b].resize(sanisizer::product<typename std::vector<Output_>::size_type>(sanisizer::product<std::size_t>(max_chunk, nranks), out_NC));
+    }
+    std::vector<std::size_t> counts[2];
+
+    auto chunk_rows = [&](const std::size_t n, const std::size_t round) -> std::size_t {
+        const auto start = round * chunk_size;
+        return (start < n ? std::min(chunk_size, n - start) : 0);
+    };
+
+    auto unpack = [&](const Output_* chunk, const std::size_t round) -> void {
+        for (I<decltype(nranks)> q = 0; q < nranks; ++q) {
+            const auto nrows = chunk_rows(all_NR[q], round);
+            const auto first = offsets[q] + round * chunk_size;
+            if (row_major) {
+                std::copy_n(chunk, sanisizer::product_unsafe<std::size_t>(nrows, out_NC), output + sanisizer::product_unsafe<std::size_t>(first, out_NC));
+            } else {
+                transpose_tile<false>(chunk, nrows, out_NC, out_NC, output + first, total_NR);
+            }
+            chunk += sanisizer::product_unsafe<std::size_t>(nrows, out_NC);
+        }
+    };
+
+    int current = 0;
+    std::size_t round = 0;
+    auto start_round = [&](const Output_* contribution) -> void {
+        if (round) {
+            comm.wait();
+            unpack(gathered[1 - current].data(), round - 1);
+        }
+
+        auto& cur_counts = counts[current];
+        cur_counts.clear();
+        for (const auto n : all_NR) {
+            cur_counts.push_back(sanisizer::product_unsafe<std::size_t>(chunk_rows(n, round), out_NC));
+        }
+        comm.start_all_gather(contribution, cur_counts, gathered[current].data());
+
+        ++round;
+        current = 1 - current;
+    };
+
+    // The computed blocks need not align with the chunks, so we fill each chunk across one or more blocks.
+    // A large 'ordered_block_size' is still efficient for the computation while 'chunk_size' keeps the messages small.
+    std::size_t filled = 0;
+    multiply_with_matrix_to_ordered_row_blocks<Output_>(
+        left,
+        right,
+        [&](LeftIndex_, LeftIndex_ length, const Output_* block) -> void {
+            // The block is only valid for the duration of the callback, so we need to copy it to a buffer that persists during the all-gather.
+            std::size_t remaining = length;
+            while (remaining) {
+                const auto needed = chunk_rows(local_NR, round);
+                const auto taken = std::min(needed - filled, remaining);
+                std::copy_n(block, sanisizer::product_unsafe<std::size_t>(taken, out_NC), local[current].data() + sanisizer::product_unsafe<std::size_t>(filled, out_NC));
+                block += sanisizer::product_unsafe<std::size_t>(taken, out_NC);
+                remaining -= taken;
+                filled += taken;
+                if (filled == needed) {
+                    start_round(local[current].data());
+                    filled = 0;
+                }
+            }
+        },
+        options.row_blocks
+    );
+
+    // Participating in the remaining rounds for the processes with larger slices.
+    while (round < num_rounds) {
+        start_round(local[current].data());
+    }
+
+    if (round) {
+        comm.wait();
+        unpack(gathered[1 - current].data(), round - 1);
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,601 @@
+#ifndef TATAMI_MULT_EPILOGUE_HPP
+#define TATAMI_MULT_EPILOGUE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "single_vector/dispatch.hpp"
+#include "multiple_vectors/dispatch.hpp"
+#include "dense_matrix/dispatch.hpp"
+#include "sparse_matrix/dispatch.hpp"
+#include "row_blocks.hpp"
+#include "utils.hpp"
+
+/**
+ * @file epilogue.hpp
+ * @brief Multiplication with scaling, accumulation and an elementwise epilogue.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @cond
+ */
+// A nullptr 'epilogue' is treated as the identity, which allows the overloads without an epilogue to skip any separate pass over the output.
+template<class Epilogue_, typename Output_, typename ... Position_>
+Output_ apply_epilogue(Epilogue_& epilogue, const Output_ value, const Position_... position) {
+    if constexpr(std::is_same<Epilogue_, std::nullptr_t>::value) {
+        return value;
+    } else {
+        return epilogue(position..., value);
+    }
+}
+
+template<typename Output_, class Epilogue_, typename ... Position_>
+void update_output(Output_& current, const Output_ product, const double alpha, const double beta, Epilogue_& epilogue, const Position_... position) {
+    Output_ value = static_cast<Output_>(alpha) * product;
+    if (beta != 0) {
+        // Following the usual GEMM convention, the existing contents are not read when beta = 0.
+        // This means that 'output' can be uninitialized or contain NaNs without affecting the result.
+        value += static_cast<Output_>(beta) * current;
+    }
+    current = apply_epilogue(epilogue, value, position...);
+}
+
+// Replacing the existing contents of the output with 'beta * output', so that the column-based kernels can accumulate the product on top of it.
+// Again, the existing contents are not read if beta = 0.
+template<typename Output_, typename Length_>
+void scale_existing_output(Output_* const output, const Length_ length, const double beta) {
+    if (beta == 0) {
+        std::fill_n(output, length, 0);
+    } else if (beta != 1) {
+        const Output_ mult = beta;
+        for (Length_ i = 0; i < length; ++i) {
+            output[i] *= mult;
+        }
+    }
+}
+
+// The column-based kernels accumulate each output entry across the entire common dimension, so the epilogue can only be applied once the product is complete.
+// We pre-scale 'output' by beta and accumulate 'alpha * left * right' directly into it via the *_range() kernels,
+// and then the epilogue is applied while adding the per-thread partial results in reduce_partial_output_vectors().
+// If alpha is not 1, it is applied to copies of the RHS vectors, which are only as long as the common dimension.
+template<typename Value_, typename Index_, typename RightVectors_, class GetRightVector_, class GetOutputVector_, class Epilogue_>
+void update_column_with_multiple_vectors(
+    const tatami::Matrix<Value_, Index_>& left,
+    const RightVectors_ right_vectors,
+    GetRightVector_ get_right_vector,
+    GetOutputVector_ get_output_vector,
+    Epilogue_& epilogue,
+    const double alpha,
+    const double beta,
+    const MultiplyDenseColumnWithMultipleVectorsOptions& dense_options,
+    const MultiplySparseColumnWithMultipleVectorsOptions& sparse_options
+) {
+    const auto NR = left.nrow();
+    const auto NC = left.ncol();
+    for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
+        scale_existing_output(get_output_vector(rv), NR, beta);
+    }
+
+    typedef I<decltype(get_output_vector(0)[0])> Output;
+    auto finalize = [&]() {
+        if constexpr(std::is_same<Epilogue_, std::nullptr_t>::value) {
+            return nullptr;
+        } else {
+            return [&](const RightVectors_ rv, const std::size_t r, const Output value) -> Output {
+                return epilogue(rv, static_cast<Index_>(r), value);
+            };
+        }
+    }();
+
+    auto run = [&](auto get_scaled_vector) -> void {
+        if (left.is_sparse()) {
+            multiply_sparse_column_with_multiple_vectors_range(left, static_cast<Index_>(0), NC, right_vectors, get_scaled_vector, get_output_vector, sparse_options, finalize);
+        } else {
+            multiply_dense_column_with_multiple_vectors_range(left, static_cast<Index_>(0), NC, right_vectors, get_scaled_vector, get_output_vector, dense_options, finalize);
+        }
+    };
+
+    if (alpha == 1) {
+        run(get_right_vector);
+        return;
+    }
+
+    auto scaled = sanisizer::create<std::vector<std::vector<Output> > >(right_vectors);
+    const Output mult = alpha;
+    for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
+        auto& current = scaled[rv];
+        tatami::resize_container_to_Index_size(current, NC);
+        const auto rptr = get_right_vector(rv);
+        for (Index_ c = 0; c < NC; ++c) {
+            current[c] = mult * static_cast<Output>(rptr[c]);
+        }
+    }
+    run([&](const RightVectors_ rv) -> const Output* {
+        return scaled[rv].data();
+    });
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Options for `multiply_with_single_vector_and_update()`.
+ */
+struct MultiplyWithSingleVectorAndUpdateOptions {
+    /**
+     * Scaling factor for the matrix-vector product.
+     */
+    double alpha = 1;
+
+    /**
+     * Scaling factor for the existing contents of the output array.
+     * If zero, the existing contents are ignored.
+     */
+    double beta = 0;
+
+    /**
+     * Options for the matrix-vector multiplication.
+     * If `left` prefers row access, only `MultiplyWithSingleVectorOptions::dense_row` or `MultiplyWithSingleVectorOptions::sparse_row` is used.
+     */
+    MultiplyWithSingleVectorOptions single_vector;
+};
+
+/**
+ * Set the number of threads to use in `multiply_with_single_vector_and_update()`.
+ *
+ * @param options Options to be set.
+ * @param num_threads Number of threads, should be positive.
+ */
+inline void set_num_threads(MultiplyWithSingleVectorAndUpdateOptions& options, int num_threads) {
+    set_num_threads(options.single_vector, num_threads);
+}
+
+/**
+ * Compute `output = epilogue(alpha * left * right + beta * output)` for a matrix `left` and vector `right`, where `epilogue` is applied to each element.
+ *
+ * If `left` prefers row access, the update and `epilogue` are fused into `multiply_dense_row_with_single_vector()` or `multiply_sparse_row_with_single_vector()`,
+ * such that they are applied to each entry of `output` as soon as the corresponding dot product is computed.
+ * This avoids an extra pass over `output` after the multiplication.
+ *
+ * If `left` prefers column access, each entry of the product is only complete after the entire common dimension has been traversed.
+ * In this case, `output` is first scaled by `beta` and `alpha * left * right` is accumulated directly into it by the column-based kernels,
+ * using the options in `MultiplyWithSingleVectorOptions::dense_column` or `MultiplyWithSingleVectorOptions::sparse_column`.
+ * `epilogue` is then applied to each entry while the per-thread partial results are being combined, so no temporary copy of `output` is required.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam Right_ Numeric type of the RHS vector.
+ * @tparam Output_ Numeric type of the output array.
+ * @tparam Epilogue_ Function to apply to each element of the output.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[in,out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On input, this should contain the existing values to be scaled by `MultiplyWithSingleVectorAndUpdateOptions::beta`;
+ * this may be uninitialized if `beta = 0`.
+ * On output, this stores the updated values.
+ * @param epilogue Function that accepts an `Index_` specifying the row of `left` and an `Output_` containing the updated value for that row,
+ * and returns the value to be stored in `output`.
+ * This function should be thread-safe.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename Value_, typename Index_, typename Right_, typename Output_, class Epilogue_>
+void multiply_with_single_vector_and_update(
+    const tatami::Matrix<Value_, Index_>& left,
+    const Right_* const right,
+    Output_* const output,
+    Epilogue_ epilogue,
+    const MultiplyWithSingleVectorAndUpdateOptions& options
+) {
+    if (left.prefer_rows()) {
+        // The row-based kernels complete each dot product in a single step, so we can update each output entry as soon as its product is available.
+        auto store = [&](const Index_ r, const Output_ prod) -> void {
+            update_output(output[r], prod, options.alpha, options.beta, epilogue, r);
+        };
+        SingleVectorWorkspace<Value_, Index_, Output_> workspace;
+        if (left.is_sparse()) {
+            multiply_sparse_row_with_single_vector_internal<accumulators_>(left, right, store, options.single_vector.sparse_row, workspace);
+        } else {
+            multiply_dense_row_with_single_vector_internal<accumulators_>(left, right, store, options.single_vector.dense_row, workspace);
+        }
+        return;
+    }
+
+    // A single vector is just a special case of multiple vectors,
+    // where a primary block size of 1 reduces the multiple-vector column kernels to the single-vector algorithm.
+    MultiplyDenseColumnWithMultipleVectorsOptions dense_options;
+    dense_options.num_threads = options.single_vector.dense_column.num_threads;
+    dense_options.primary_block_size = 1;
+    MultiplySparseColumnWithMultipleVectorsOptions sparse_options;
+    sparse_options.num_threads = options.single_vector.sparse_column.num_threads;
+    sparse_options.block_size = 1;
+    sparse_options.pattern = options.single_vector.sparse_column.pattern;
+
+    auto vector_epilogue = [&]() {
+        if constexpr(std::is_same<Epilogue_, std::nullptr_t>::value) {
+            return nullptr;
+        } else {
+            return [&](int, const Index_ r, const Output_ value) -> Output_ {
+                return epilogue(r, value);
+            };
+        }
+    }();
+
+    update_column_with_multiple_vectors(
+        left,
+        1,
+        [&](int) -> const Right_* {
+            return right;
+        },
+        [&](int) -> Output_* {
+            return output;
+        },
+        vector_epilogue,
+        options.alpha,
+        options.beta,
+        dense_options,
+        sparse_options
+    );
+}
+
+/**
+ * Compute `output = alpha * left * right + beta * output` for a matrix `left` and vector `right`.
+ * This is equivalent to calling the other `multiply_with_single_vector_and_update()` overload with an identity `epilogue`.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam Right_ Numeric type of the RHS vector.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[in,out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On input, this should contain the existing values to be scaled by `MultiplyWithSingleVectorAndUpdateOptions::beta`;
+ * this may be uninitialized if `beta = 0`.
+ * On output, this stores the updated values.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename Value_, typename Index_, typename Right_, typename Output_>
+void multiply_with_single_vector_and_update(
+    const tatami::Matrix<Value_, Index_>& left,
+    const Right_* const right,
+    Output_* const output,
+    const MultiplyWithSingleVectorAndUpdateOptions& options
+) {
+    multiply_with_single_vector_and_update<accumulators_>(left, right, output, nullptr, options);
+}
+
+/**
+ * @brief Options for `multiply_with_multiple_vectors_and_update()`.
+ */
+struct MultiplyWithMultipleVectorsAndUpdateOptions {
+    /**
+     * Scaling factor for the matrix-vector products.
+     */
+    double alpha = 1;
+
+    /**
+     * Scaling factor for the existing contents of the output arrays.
+     * If zero, the existing contents are ignored.
+     */
+    double beta = 0;
+
+    /**
+     * Options for the matrix-vector multiplication.
+     * If `left` prefers row access, only `MultiplyWithMultipleVectorsOptions::dense_row` or `MultiplyWithMultipleVectorsOptions::sparse_row` is used.
+     */
+    MultiplyWithMultipleVectorsOptions multiple_vectors;
+};
+
+/**
+ * Set the number of threads to use in `multiply_with_multiple_vectors_and_update()`.
+ *
+ * @param options Options to be set.
+ * @param num_threads Number of threads, should be positive.
+ */
+inline void set_num_threads(MultiplyWithMultipleVectorsAndUpdateOptions& options, int num_threads) {
+    set_num_threads(options.multiple_vectors, num_threads);
+}
+
+/**
+ * Compute `output[i] = epilogue(alpha * left * right[i] + beta * output[i])` for a matrix `left` and vectors `right`, where `epilogue` is applied to each element.
+ *
+ * If `left` prefers row access, the update and `epilogue` are fused into `multiply_dense_row_with_multiple_vectors()` or `multiply_sparse_row_with_multiple_vectors()`,
+ * such that they are applied to each entry of `output` as soon as the corresponding dot product is computed.
+ * This avoids an extra pass over `output` after the multiplication.
+ *
+ * If `left` prefers column access, `output` is first scaled by `beta` and `alpha * left * right[i]` is accumulated directly into it by the column-based kernels,
+ * using the options in `MultiplyWithMultipleVectorsOptions::dense_column` or `MultiplyWithMultipleVectorsOptions::sparse_column`.
+ * `epilogue` is then applied to each entry while the per-thread partial results are being combined, see `multiply_with_single_vector_and_update()` for details.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam Right_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output array.
+ * @tparam Epilogue_ Function to apply to each element of the output.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Vector of pointers, each of which points to an array of length `left.ncol()`.
+ * Each entry contains a RHS vector with which to multiply `left`.
+ * @param[in,out] output Vector of pointers, each of which points to an array of length `left.nrow()`.
+ * On input, each array should contain the existing values to be scaled by `MultiplyWithMultipleVectorsAndUpdateOptions::beta`;
+ * these may be uninitialized if `beta = 0`.
+ * On output, the `i`-th entry stores the updated values for `right[i]`.
+ * @param epilogue Function that accepts a `std::size_t` specifying the index of the vector in `right`,
+ * an `Index_` specifying the row of `left`, and an `Output_` containing the updated value;
+ * and returns the value to be stored in `output`.
+ * This function should be thread-safe.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename Value_, typename Index_, typename Right_, typename Output_, class Epilogue_>
+void multiply_with_multiple_vectors_and_update(
+    const tatami::Matrix<Value_, Index_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    Epilogue_ epilogue,
+    const MultiplyWithMultipleVectorsAndUpdateOptions& options
+) {
+    const std::size_t num_vectors = right.size();
+
+    if (left.prefer_rows()) {
+        // The row-based kernels complete each dot product in a single step, so we can update each output entry as soon as its product is available.
+        auto get_right_vector = [&](const std::size_t v) -> const Right_* {
+            return right[v];
+        };
+        auto store = [&](const std::size_t v, const Index_ r, const Output_ prod) -> void {
+            update_output(output[v][r], prod, options.alpha, options.beta, epilogue, v, r);
+        };
+        if (left.is_sparse()) {
+            multiply_sparse_row_with_multiple_vectors_internal<accumulators_, Output_>(left, static_cast<Index_>(0), left.ncol(), num_vectors, get_right_vector, store, options.multiple_vectors.sparse_row);
+        } else {
+            multiply_dense_row_with_multiple_vectors_internal<accumulators_, Output_>(left, static_cast<Index_>(0), left.ncol(), num_vectors, get_right_vector, nullptr, store, options.multiple_vectors.dense_row);
+        }
+        return;
+    }
+
+    update_column_with_multiple_vectors(
+        left,
+        num_vectors,
+        [&](const std::size_t v) -> const Right_* {
+            return right[v];
+        },
+        [&](const std::size_t v) -> Output_* {
+            return output[v];
+        },
+        epilogue,
+        options.alpha,
+        options.beta,
+        options.multiple_vectors.dense_column,
+        options.multiple_vectors.sparse_column
+    );
+}
+
+/**
+ * Compute `output[i] = alpha * left * right[i] + beta * output[i]` for a matrix `left` and vectors `right`.
+ * This is equivalent to calling the other `multiply_with_multiple_vectors_and_update()` overload with an identity `epilogue`.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam Right_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Vector of pointers, each of which points to an array of length `left.ncol()`.
+ * Each entry contains a RHS vector with which to multiply `left`.
+ * @param[in,out] output Vector of pointers, each of which points to an array of length `left.nrow()`.
+ * On input, each array should contain the existing values to be scaled by `MultiplyWithMultipleVectorsAndUpdateOptions::beta`;
+ * these may be uninitialized if `beta = 0`.
+ * On output, the `i`-th entry stores the updated values for `right[i]`.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename Value_, typename Index_, typename Right_, typename Output_>
+void multiply_with_multiple_vectors_and_update(
+    const tatami::Matrix<Value_, Index_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplyWithMultipleVectorsAndUpdateOptions& options
+) {
+    multiply_with_multiple_vectors_and_update<accumulators_>(left, right, output, nullptr, options);
+}
+
+/**
+ * @brief Options for `multiply_with_matrix_and_update()`.
+ */
+struct MultiplyWithMatrixAndUpdateOptions {
+    /**
+     * Scaling factor for the matrix product.
+     */
+    double alpha = 1;
+
+    /**
+     * Scaling factor for the existing contents of the output array.
+     * If zero, the existing contents are ignored.
+     */
+    double beta = 0;
+
+    /**
+     * Options to pass to `multiply_with_matrix_to_row_blocks()`, if `left` prefers row access.
+     */
+    MultiplyWithMatrixToRowBlocksOptions row_blocks;
+
+    /**
+     * Options to pass to `multiply_with_dense_matrix()`, if `left` prefers column access and `right` is dense.
+     */
+    MultiplyWithDenseMatrixOptions dense_matrix;
+
+    /**
+     * Options to pass to `multiply_with_sparse_matrix()`, if `left` prefers column access and `right` is sparse.
+     */
+    MultiplyWithSparseMatrixOptions sparse_matrix;
+};
+
+/**
+ * Set the number of threads to use in `multiply_with_matrix_and_update()`.
+ *
+ * @param options Options to be set.
+ * @param num_threads Number of threads, should be positive.
+ */
+inline void set_num_threads(MultiplyWithMatrixAndUpdateOptions& options, int num_threads) {
+    options.row_blocks.num_threads = num_threads;
+    set_num_threads(options.dense_matrix, num_threads);
+    set_num_threads(options.sparse_matrix, num_threads);
+}
+
+/**
+ * Compute `output = epilogue(alpha * left * right + beta * output)` for two matrices `left` and `right`, where `epilogue` is applied to each element.
+ *
+ * If `left` prefers row access, the product is computed by `multiply_with_matrix_to_row_blocks()`
+ * and each block of output rows is used to update `output` while the block is still in cache.
+ * This avoids an extra pass over `output` after the multiplication.
+ * The blocks are filled by the same computations as `multiply_dense_row_with_dense_row_matrix_to_row_output()` and friends, so the epilogue is effectively fused into their final write.
+ *
+ * If `left` prefers column access, the product is computed by `multiply_with_dense_matrix()` or `multiply_with_sparse_matrix()` and then used to update `output` in a separate pass.
+ * If `beta = 0`, the product is computed directly in `output`; otherwise, a temporary array of the same size as `output` is allocated to hold the product.
+ * (Unlike `multiply_with_multiple_vectors_and_update()`, the matrix kernels do not yet accumulate into existing output.)
+ * The separate pass is skipped entirely for the overload without an epilogue if `alpha = 1` and `beta = 0`.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ * @tparam Epilogue_ Function to apply to each element of the output.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right RHS matrix to be multiplied.
+ * `right.nrow()` and `left.ncol()` should be equal.
+ * @param[in,out] output Pointer to an array of length equal to `left.nrow() * right.ncol()`.
+ * On input, this should contain the existing values to be scaled by `MultiplyWithMatrixAndUpdateOptions::beta`;
+ * this may be uninitialized if `beta = 0`.
+ * On output, this stores the updated values in either row- or column-major format depending on `output_row_major`.
+ * @param output_row_major Whether `output` is in row-major format.
+ * @param epilogue Function that accepts a `LeftIndex_` specifying the row, a `RightIndex_` specifying the column, and an `Output_` containing the updated value;
+ * and returns the value to be stored in `output`.
+ * This function should be thread-safe.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_, class Epilogue_>
+void multiply_with_matrix_and_update(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Output_* const output,
+    const bool output_row_major,
+    Epilogue_ epilogue,
+    const MultiplyWithMatrixAndUpdateOptions& options
+) {
+    const auto left_NR = left.nrow();
+    const auto right_NC = right.ncol();
+
+    auto update_block = [&](const LeftIndex_ start, const LeftIndex_ length, const Output_* const block) -> void {
+        for (LeftIndex_ lr = 0; lr < length; ++lr) {
+            const LeftIndex_ r = start + lr;
+            const auto bptr = block + sanisizer::product_unsafe<std::size_t>(lr, right_NC);
+            if (output_row_major) {
+                const auto optr = output + sanisizer::product_unsafe<std::size_t>(r, right_NC);
+                for (RightIndex_ c = 0; c < right_NC; ++c) {
+                    update_output(optr[c], bptr[c], options.alpha, options.beta, epilogue, r, c);
+                }
+            } else {
+                for (RightIndex_ c = 0; c < right_NC; ++c) {
+                    update_output(output[sanisizer::nd_offset<std::size_t>(r, left_NR, c)], bptr[c], options.alpha, options.beta, epilogue, r, c);
+                }
+            }
+        }
+    };
+
+    if (left.prefer_rows()) {
+        multiply_with_matrix_to_row_blocks<Output_>(left, right, update_block, options.row_blocks);
+        return;
+    }
+
+    // The column-based matrix kernels zero their output before accumulating, so we can't pre-scale 'output' by beta as in update_column_with_multiple_vectors().
+    // Instead, we apply the update and epilogue in a separate pass over the completed product. If beta = 0, the product is computed in 'output' directly;
+    // otherwise, we need a temporary array of the same size as 'output' to hold the product while the existing contents are still required.
+    std::vector<Output_> tmp;
+    Output_* product = output;
+    if (options.beta != 0) {
+        tmp.resize(sanisizer::product<I<decltype(tmp.size())> >(left_NR, right_NC));
+        product = tmp.data();
+    }
+
+    if (right.is_sparse()) {
+        multiply_with_sparse_matrix(left, right, product, output_row_major, options.sparse_matrix);
+    } else {
+        multiply_with_dense_matrix(left, right, product, output_row_major, options.dense_matrix);
+    }
+
+    if constexpr(std::is_same<Epilogue_, std::nullptr_t>::value) {
+        if (options.alpha == 1 && options.beta == 0) {
+            return;
+        }
+    }
+
+    if (output_row_major) {
+        tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
+            update_block(start, length, product + sanisizer::product_unsafe<std::size_t>(start, right_NC));
+        }, left_NR, options.row_blocks.num_threads);
+    } else {
+        tatami::parallelize([&](int, RightIndex_ start, RightIndex_ length) -> void {
+            for (RightIndex_ c = start, end = start + length; c < end; ++c) {
+                const auto offset = sanisizer::product_unsafe<std::size_t>(c, left_NR);
+                const auto pptr = product + offset;
+                const auto optr = output + offset;
+                for (LeftIndex_ r = 0; r < left_NR; ++r) {
+                    update_output(optr[r], pptr[r], options.alpha, options.beta, epilogue, r, c);
+                }
+            }
+        }, right_NC, options.row_blocks.num_threads);
+    }
+}
+
+/**
+ * Compute `output = alpha * left * right + beta * output` for two matrices `left` and `right`.
+ * This is equivalent to calling the other `multiply_with_matrix_and_update()` overload with an identity `epilogue`.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right RHS matrix to be multiplied.
+ * `right.nrow()` and `left.ncol()` should be equal.
+ * @param[in,out] output Pointer to an array of length equal to `left.nrow() * right.ncol()`.
+ * On input, this should contain the existing values to be scaled by `MultiplyWithMatrixAndUpdateOptions::beta`;
+ * this may be uninitialized if `beta = 0`.
+ * On output, this stores the updated values in either row- or column-major format depending on `output_row_major`.
+ * @param output_row_major Whether `output` is in row-major format.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void multiply_with_matrix_and_update(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplyWithMatrixAndUpdateOptions& options
+) {
+    multiply_with_matrix_and_update(left, right, output, output_row_major, nullptr, options);
+}
+
+}
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef TATAMI_MULT_INCREMENTAL_HPP
+#define TATAMI_MULT_INCREMENTAL_HPP
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "tatami_mult.hpp"
+#include "partial.hpp"
+#include "utils.hpp"
+
+/**
+ * @file incremental.hpp
+ * @brief Update an existing product when rows or columns are appended to the LHS matrix.
+ *
+ * This header is not included by `tatami_mult.hpp` and should be included separately.
+ */
+
+namespace tatami_mult {
+
+/**
+ * Update the product of a matrix `X` and multiple vectors after new rows are appended to `X`.
+ * Only the product of the new rows is computed, so the cost scales with the number of new rows rather than the size of `X`.
+ *
+ * This function can also be used to update `t(X) * v` after new columns are appended to `X`,
+ * by passing a `tatami::DelayedTranspose` of the new columns as `new_rows`.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param new_rows Matrix containing the rows that were appended to `X`, e.g., a `tatami::DelayedSubsetBlock` of the updated `X`.
+ * `new_rows.ncol()` should be equal to the number of columns of `X`.
+ * @param previous_rows Number of rows of `X` before the new rows were appended.
+ * @param[in] right Vector of pointers, each of which points to an array of length `new_rows.ncol()`.
+ * Each entry contains an RHS vector with which to multiply `X`.
+ * @param[in,out] output Vector of length equal to `right.size()`.
+ * Each entry is a pointer to an array of length `previous_rows + new_rows.nrow()`.
+ * On input, the first `previous_rows` entries of each array should contain the previous product for the corresponding RHS vector.
+ * On output, the remaining entries are filled with the product of `new_rows` and the RHS vector.
+ * @param options Further options, passed to `multiply_with_multiple_vectors()`.
+ */
+template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void update_product_for_appended_rows(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& new_rows,
+    const LeftIndex_ previous_rows,
+    const std::vector<RightValue_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplyWithMultipleVectorsOptions& options
+) {
+    std::vector<Output_*> shifted;
+    shifted.reserve(output.size());
+    for (const auto optr : output) {
+        shifted.push_back(optr + previous_rows);
+    }
+    multiply_with_multiple_vectors<accumulators_>(new_rows, right, shifted, options);
+}
+
+/**
+ * Update the product of matrices `X` and `right` after new rows are appended to `X`.
+ * Only the product of the new rows is computed, so the cost of the multiplication scales with the number of new rows rather than the size of `X`.
+ *
+ * For row-major output, the product of the new rows is directly stored after the existing contents.
+ * For column-major output, the existing columns are first moved to their new positions in `output`,
+ * which is cheap compared to the multiplication but still proportional to the size of the previous product.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param new_rows Matrix containing the rows that were appended to `X`, e.g., a `tatami::DelayedSubsetBlock` of the updated `X`.
+ * @param previous_rows Number of rows of `X` before the new rows were appended.
+ * @param right RHS matrix to be multiplied.
+ * `right.nrow()` and `new_rows.ncol()` should be equal.
+ * @param[in,out] output Pointer to an array of length equal to `(previous_rows + new_rows.nrow()) * right.ncol()`.
+ * On input, the first `previous_rows * right.ncol()` entries should contain the previous product in the format specified by `output_row_major`,
+ * e.g., as produced by `multiply_with_matrix()` before the array was resized to accommodate the new rows.
+ * On output, this stores the updated product of `X` and `right` in the same format.
+ * @param output_row_major Whether `output` is in row-major format.
+ * If false, `output` is assumed to be in column-major format.
+ * @param options Further options, passed to `multiply_with_matrix()`.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void update_product_for_appended_rows(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& new_rows,
+    const LeftIndex_ previous_rows,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplyWithMatrixOptions& options
+) {
+    const auto added = sanisizer::cast<std::size_t>(new_rows.nrow());
+    const auto previous = sanisizer::cast<std::size_t>(previous_rows);
+    const auto right_NC = sanisizer::cast<std::size_t>(right.ncol());
+    if (output_row_major) {
+        multiply_with_matrix(new_rows, right, output + sanisizer::product<std::size_t>(previous, right_NC), true, options);
+        return;
+    }
+
+    // Moving the existing columns to their new positions, starting from the last column so that nothing is overwritten before it is moved.
+    // Each column only moves towards the end of the array, hence the use of std::copy_backward.
+    const auto total = sanisizer::sum<std::size_t>(previous, added);
+    if (added) {
+        for (std::size_t c = right_NC; c > 1; --c) {
+            const auto src = output + sanisizer::product_unsafe<std::size_t>(c - 1, previous);
+            std::copy_backward(src, src + previous, output + sanisizer::product_unsafe<std::size_t>(c - 1, total) + previous);
+        }
+    }
+
+    std::vector<Output_> tmp(sanisizer::product<typename std::vector<Output_>::size_type>(added, right_NC));
+    multiply_with_matrix(new_rows, right, tmp.data(), false, options);
+    for (std::size_t c = 0; c < right_NC; ++c) {
+        std::copy_n(
+            tmp.data() + sanisizer::product_unsafe<std::size_t>(c, added),
+            added,
+            output + sanisizer::nd_offset<std::size_t>(previous, total, c)
+        );
+    }
+}
+
+/**
+ * Update the product of a matrix `X` and multiple vectors after new columns are appended to `X` and new entries are appended to each vector.
+ * This adds the contribution of the new columns to the existing product via `multiply_partial_with_multiple_vectors()`,
+ * so the cost scales with the number of new columns rather than the size of `X`.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param new_columns Matrix containing the columns that were appended to `X`, e.g., a `tatami::DelayedSubsetBlock` of the updated `X`.
+ * @param[in] new_right Vector of pointers, each of which points to an array of length `new_columns.ncol()`.
+ * Each array contains the entries that were appended to the corresponding RHS vector.
+ * @param[in,out] output Vector of length equal to `new_right.size()`.
+ * Each entry is a pointer to an array of length `new_columns.nrow()` containing the previous product for the corresponding RHS vector.
+ * On output, this stores the updated product.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void update_product_for_appended_columns(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& new_columns,
+    const std::vector<RightValue_*>& new_right,
+    const std::vector<Output_*>& output,
+    const MultiplyWithMultipleVectorsOptions& options
+) {
+    multiply_partial_with_multiple_vectors<accumulators_>(new_columns, static_cast<LeftIndex_>(0), new_columns.ncol(), new_right, output, options);
+}
+
+/**
+ * Update the product of matrices `X` and `Y` after new columns are appended to `X` and the same number of new rows are appended to `Y`.
+ * This adds the rank-\f$k\f$ contribution of the new columns and rows to the existing product via `multiply_partial_with_matrix()`,
+ * so the cost scales with the number of new columns rather than the size of `X`.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param new_columns Matrix containing the columns that were appended to `X`, e.g., a `tatami::DelayedSubsetBlock` of the updated `X`.
+ * @param new_right_rows Matrix containing the rows that were appended to `Y`.
+ * `new_right_rows.nrow()` and `new_columns.ncol()` should be equal.
+ * @param[in,out] output Pointer to an array of length equal to `new_columns.nrow() * new_right_rows.ncol()`, containing the previous product.
+ * On output, this stores the updated product.
+ * @param output_row_major Whether `output` is in row-major format.
+ * If false, `output` is assumed to be in column-major format.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void update_product_for_appended_columns(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& new_columns,
+    const tatami::Matrix<RightValue_, RightIndex_>& new_right_rows,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplyPartialWithMatrixOptions& options
+) {
+    multiply_partial_with_matrix(new_columns, new_right_rows, static_cast<LeftIndex_>(0), new_columns.ncol(), output, output_row_major, options);
+}
+
+}
+
+#endif
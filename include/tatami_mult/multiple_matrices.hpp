@@ -0,0 +1,176 @@
+#ifndef TATAMI_MULT_MULTIPLE_MATRICES_HPP
+#define TATAMI_MULT_MULTIPLE_MATRICES_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "dense_matrix/dispatch.hpp"
+#include "sparse_matrix/dispatch.hpp"
+#include "row_blocks.hpp"
+#include "utils.hpp"
+
+/**
+ * @file multiple_matrices.hpp
+ * @brief Any matrix LHS, multiple matrices RHS.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `multiply_with_multiple_matrices()`.
+ */
+struct MultiplyWithMultipleMatricesOptions {
+    /**
+     * Options to pass to `multiply_with_matrix_to_row_blocks()`, if `left` prefers row access.
+     */
+    MultiplyWithMatrixToRowBlocksOptions row_blocks;
+
+    /**
+     * Options to pass to `multiply_with_dense_matrix()`, if `left` prefers column access and the combined RHS matrix is dense.
+     */
+    MultiplyWithDenseMatrixOptions dense_matrix;
+
+    /**
+     * Options to pass to `multiply_with_sparse_matrix()`, if `left` prefers column access and the combined RHS matrix is sparse.
+     */
+    MultiplyWithSparseMatrixOptions sparse_matrix;
+};
+
+/**
+ * Set the number of threads to use in `multiply_with_multiple_matrices()`.
+ *
+ * @param options Options to be set.
+ * @param num_threads Number of threads, should be positive.
+ */
+inline void set_num_threads(MultiplyWithMultipleMatricesOptions& options, int num_threads) {
+    options.row_blocks.num_threads = num_threads;
+    set_num_threads(options.dense_matrix, num_threads);
+    set_num_threads(options.sparse_matrix, num_threads);
+}
+
+/**
+ * Multiply a single LHS matrix by each of multiple RHS matrices, with only one pass through the LHS.
+ * This is more efficient than repeated calls to `multiply_with_matrix()` when `left` is expensive to extract, e.g., if it is file-backed.
+ *
+ * The RHS matrices are combined by column into a single `tatami::DelayedBind` matrix that is realized into memory.
+ * If `left` prefers row access, this function uses `multiply_with_matrix_to_row_blocks()` and scatters each block of output rows into the output arrays.
+ * This only requires `num_threads` blocks of output rows to be held in memory at any given time.
+ * Otherwise, it calls `multiply_with_dense_matrix()` or `multiply_with_sparse_matrix()` to compute the combined product in a temporary array,
+ * which is then split into the output arrays.
+ * In either case, `left` is only iterated over once.
+ *
+ * Note that the temporary array for column access has the same size as all of the output arrays combined, effectively doubling the memory usage for the products.
+ * This is because each LHS column contributes to every entry of the combined product, so the entire product must be held in memory until all LHS columns are processed,
+ * and the column-based kernels require it to be stored in a single contiguous array.
+ * If memory is limited, users can instead call `multiply_with_matrix()` separately for each RHS matrix, at the cost of multiple passes through `left`.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right Vector of pointers to the RHS matrices.
+ * Each matrix should have number of rows equal to `left.ncol()`.
+ * @param[out] output Vector of length equal to `right.size()`.
+ * Each entry is a pointer to an array of length `left.nrow() * right[i]->ncol()`.
+ * On output, the `i`-th entry stores the product of `left` and `right[i]` in either row- or column-major format depending on `output_row_major`.
+ * @param output_row_major Whether to store the matrix products in row-major format in `output`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void multiply_with_multiple_matrices(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<std::shared_ptr<const tatami::Matrix<RightValue_, RightIndex_> > >& right,
+    const std::vector<Output_*>& output,
+    const bool output_row_major,
+    const MultiplyWithMultipleMatricesOptions& options
+) {
+    const auto num_right = right.size();
+    if (num_right == 0) {
+        return;
+    }
+
+    const auto left_NR = left.nrow();
+    std::vector<RightIndex_> offsets;
+    offsets.reserve(num_right + 1);
+    offsets.push_back(0);
+    for (const auto& r : right) {
+        offsets.push_back(sanisizer::sum<RightIndex_>(offsets.back(), r->ncol()));
+    }
+    const RightIndex_ combined_NC = offsets.back();
+
+    auto combined = tatami::make_DelayedBind(right, false);
+
+    // Copying rows [start, start + length) of the combined product, stored in 'block' with the specified row stride, into each output array.
+    auto scatter = [&](const LeftIndex_ start, const LeftIndex_ length, const Output_* const block, const std::size_t stride) -> void {
+        for (I<decltype(num_right)> j = 0; j < num_right; ++j) {
+            const RightIndex_ offset = offsets[j];
+            const RightIndex_ right_NC = offsets[j + 1] - offset;
+            const auto curout = output[j];
+
+            if (output_row_major) {
+                for (LeftIndex_ lr = 0; lr < length; ++lr) {
+                    std::copy_n(
+                        block + sanisizer::nd_offset<std::size_t>(offset, stride, lr),
+                        right_NC,
+                        curout + sanisizer::product_unsafe<std::size_t>(start + lr, right_NC)
+                    );
+                }
+            } else {
+                for (LeftIndex_ lr = 0; lr < length; ++lr) {
+                    const auto bptr = block + sanisizer::nd_offset<std::size_t>(offset, stride, lr);
+                    for (RightIndex_ c = 0; c < right_NC; ++c) {
+                        curout[sanisizer::nd_offset<std::size_t>(start + lr, left_NR, c)] = bptr[c];
+                    }
+                }
+            }
+        }
+    };
+
+    if (left.prefer_rows()) {
+        multiply_with_matrix_to_row_blocks<Output_>(
+            left,
+            *combined,
+            [&](const LeftIndex_ start, const LeftIndex_ length, const Output_* const block) -> void {
+                scatter(start, length, block, combined_NC);
+            },
+            options.row_blocks
+        );
+        return;
+    }
+
+    // The column-based kernels accumulate into the entire output array for each LHS column, so we need a temporary array for the combined product.
+    // We compute it in the same layout as 'output' so that each column-major output array is a contiguous slice of the temporary.
+    std::vector<Output_> tmp;
+    tmp.resize(sanisizer::product<I<decltype(tmp.size())> >(left_NR, combined_NC));
+    if (combined->is_sparse()) {
+        multiply_with_sparse_matrix(left, *combined, tmp.data(), output_row_major, options.sparse_matrix);
+    } else {
+        multiply_with_dense_matrix(left, *combined, tmp.data(), output_row_major, options.dense_matrix);
+    }
+
+    if (output_row_major) {
+        tatami::parallelize([&](int, const LeftIndex_ start, const LeftIndex_ length) -> void {
+            scatter(start, length, tmp.data() + sanisizer::product_unsafe<std::size_t>(start, combined_NC), combined_NC);
+        }, left_NR, options.row_blocks.num_threads);
+    } else {
+        for (I<decltype(num_right)> j = 0; j < num_right; ++j) {
+            std::copy_n(
+                tmp.data() + sanisizer::product_unsafe<std::size_t>(offsets[j], left_NR),
+                sanisizer::product_unsafe<std::size_t>(offsets[j + 1] - offsets[j], left_NR),
+                output[j]
+            );
+        }
+    }
+}
+
+}
+
+#endif
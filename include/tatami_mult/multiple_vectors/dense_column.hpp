@@ -121,44 +121,25 @@ void multiply_dense_column_with_multiple_vectors_internal(
         }
     }
 }
-/**
- * @endcond
- */
 
-/**
- * @tparam LeftValue_ Numeric type of the LHS matrix value.
- * @tparam LeftIndex_ Integer type of the LHS matrix index.
- * @tparam RightVectors_ Integer type of the number of RHS vectors.
- * @tparam GetRightVector_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
- * @tparam GetOutput_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
- * 
- * @param left LHS matrix to be multiplied.
- * This function is optimized for dense matrices that prefer column access, but will work with all matrices.
- * @param right_vectors Number of RHS vectors.
- * @param get_right_vector Function that accepts a `RightVectors_` in `[0, num_right)` and returns a pointer to an array of length `left.ncol()`.
- * The array referenced by `get_right_vector(i)` represents the `i`-th RHS vector with which to multiply `left`.
- * This function should be thread-safe.
- * @param get_output_vector Function that accepts a `RightVectors_` in `[0, num_right)` and returns a pointer to an array of length `left.nrow()`.
- * On output, the array referenced by `get_output_vector(i)` stores the product of `left` with the `i`-th RHS vector.
- * @param options Further options.
- */
-template<typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutput_>
-void multiply_dense_column_with_multiple_vectors(
+// Adding the contribution of the columns of 'left' in '[common_start, common_start + common_length)' to the existing contents of the output vectors.
+// This is also used by multiply_partial_with_multiple_vectors() to process a slice of the common dimension.
+// If provided, 'finalize' is applied to each output entry after all contributions are added, see reduce_partial_output_vectors().
+template<typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_, class Finalize_ = std::nullptr_t>
+void multiply_dense_column_with_multiple_vectors_range(
     const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ common_start,
+    const LeftIndex_ common_length,
     const RightVectors_ right_vectors,
     GetRightVector_ get_right_vector,
-    GetOutput_ get_output_vector,
-    const MultiplyDenseColumnWithMultipleVectorsOptions& options
+    GetOutputVector_ get_output_vector,
+    const MultiplyDenseColumnWithMultipleVectorsOptions& options,
+    Finalize_ finalize = nullptr
 ) {
     const auto left_NR = left.nrow();
-    const auto common_dim = left.ncol();
-    for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
-        std::fill_n(get_output_vector(rv), left_NR, 0);
-    }
-
     const bool do_parallel = options.num_threads > 1;
     typedef I<decltype(get_output_vector(0)[0])> Output;
-    std::optional<std::vector<std::optional<std::vector<std::vector<Output> > > > > tmp_results;
+    std::optional<std::vector<std::optional<std::vector<Output> > > > tmp_results;
     if (do_parallel) {
         tmp_results.emplace(sanisizer::cast<I<decltype(tmp_results->size())> >(options.num_threads - 1));
     }
@@ -167,7 +148,7 @@ void multiply_dense_column_with_multiple_vectors(
         if (!do_parallel || t == 0) {
             multiply_dense_column_with_multiple_vectors_internal(
                 left,
-                start,
+                static_cast<LeftIndex_>(common_start + start),
                 length,
                 left_NR,
                 right_vectors,
@@ -177,39 +158,80 @@ void multiply_dense_column_with_multiple_vectors(
             );
 
         } else {
-            std::vector<std::vector<Output> > tmp_output;
-            tmp_output.reserve(right_vectors);
-            for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
-                tmp_output.emplace_back(tatami::cast_Index_to_container_size<std::vector<Output> >(left_NR));
-            }
+            // Storing all partial outputs contiguously for reduce_partial_output_vectors().
+            std::vector<Output> tmp_output(sanisizer::product<typename std::vector<Output>::size_type>(right_vectors, left_NR));
             multiply_dense_column_with_multiple_vectors_internal(
                 left,
-                start,
+                static_cast<LeftIndex_>(common_start + start),
                 length,
                 left_NR,
                 right_vectors,
                 get_right_vector,
                 [&](const RightVectors_ rv) -> Output* {
-                    return tmp_output[rv].data();
+                    return tmp_output.data() + sanisizer::product_unsafe<std::size_t>(rv, left_NR);
                 },
                 options
             );
             (*tmp_results)[t - 1] = std::move(tmp_output);
         }
-    }, common_dim, options.num_threads);
+    }, common_length, options.num_threads);
 
-    if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
-                const auto& tmpvec = tmp[rv];
-                const auto outptr = get_output_vector(rv);
-                for (LeftIndex_ lr = 0; lr < left_NR; ++lr) {
-                    outptr[lr] += tmpvec[lr];
-                }
-            }
-        }
+    // If we're not parallelizing, 'num_used' is no greater than 1 so the partial results are never requested.
+    reduce_partial_output_vectors(
+        right_vectors,
+        get_output_vector,
+        left_NR,
+        [&](const int u) -> const Output* {
+            return (*tmp_results)[u - 1]->data();
+        },
+        num_used,
+        options.num_threads,
+        std::move(finalize)
+    );
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightVectors_ Integer type of the number of RHS vectors.
+ * @tparam GetRightVector_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
+ * @tparam GetOutput_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
+ * 
+ * @param left LHS matrix to be multiplied.
+ * This function is optimized for dense matrices that prefer column access, but will work with all matrices.
+ * @param right_vectors Number of RHS vectors.
+ * @param get_right_vector Function that accepts a `RightVectors_` in `[0, num_right)` and returns a pointer to an array of length `left.ncol()`.
+ * The array referenced by `get_right_vector(i)` represents the `i`-th RHS vector with which to multiply `left`.
+ * This function should be thread-safe.
+ * @param get_output_vector Function that accepts a `RightVectors_` in `[0, num_right)` and returns a pointer to an array of length `left.nrow()`.
+ * On output, the array referenced by `get_output_vector(i)` stores the product of `left` with the `i`-th RHS vector.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutput_>
+void multiply_dense_column_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightVectors_ right_vectors,
+    GetRightVector_ get_right_vector,
+    GetOutput_ get_output_vector,
+    const MultiplyDenseColumnWithMultipleVectorsOptions& options
+) {
+    const auto left_NR = left.nrow();
+    for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
+        std::fill_n(get_output_vector(rv), left_NR, 0);
     }
+
+    multiply_dense_column_with_multiple_vectors_range(
+        left,
+        static_cast<LeftIndex_>(0),
+        left.ncol(),
+        right_vectors,
+        std::move(get_right_vector),
+        std::move(get_output_vector),
+        options
+    );
 }
 
 /**
@@ -49,29 +49,40 @@ struct MultiplyDenseRowWithMultipleVectorsOptions {
 /**
  * @cond
  */
-template<std::size_t accumulators_, bool use_local_buffer_, typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_>
+// If 'use_local_buffer_ = false', the partial dot products are accumulated directly in the arrays returned by 'get_output_vector'.
+// Otherwise, they are accumulated in thread-local buffers and each completed dot product is passed to 'store(v, r, value)' for vector 'v' and row 'r'.
+// Only the columns of 'left' in '[common_start, common_start + common_dim)' are used, and 'get_right_vector(v)' should point to the RHS entry for 'common_start'.
+template<std::size_t accumulators_, bool use_local_buffer_, typename Output_, typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_, class Store_>
 void multiply_dense_row_with_multiple_vectors_blocked_internal(
     const tatami::Matrix<LeftValue_, LeftIndex_>& left,
     const LeftIndex_ start,
     const LeftIndex_ length,
+    const LeftIndex_ common_start,
     const LeftIndex_ common_dim,
     const RightVectors_ right_vectors,
     GetRightVector_ get_right_vector,
     GetOutputVector_ get_output_vector,
+    Store_ store,
     const MultiplyDenseRowWithMultipleVectorsOptions& options
 ) {
-    auto ext = tatami::consecutive_extractor<false>(left, true, start, length);
+    auto ext = tatami::consecutive_extractor<false>(left, true, start, length, common_start, common_dim);
+
+    constexpr bool convert = convert_small_integer_left<LeftValue_, I<decltype(get_right_vector(0)[0])> >;
+    typedef typename std::conditional<convert, Output_, LeftValue_>::type LeftStored;
+    std::vector<LeftValue_> raw_buffer;
+    if constexpr(convert) {
+        tatami::resize_container_to_Index_size(raw_buffer, common_dim);
+    }
 
     const LeftIndex_ max_block_rows = sanisizer::min(length, options.primary_block_size);
-    std::vector<std::vector<LeftValue_> > left_buffers;
+    std::vector<std::vector<LeftStored> > left_buffers;
     left_buffers.reserve(max_block_rows);
     for (LeftIndex_ lr = 0; lr < max_block_rows; ++lr) {
-        left_buffers.emplace_back(tatami::cast_Index_to_container_size<std::vector<LeftValue_> >(common_dim));
+        left_buffers.emplace_back(tatami::cast_Index_to_container_size<std::vector<LeftStored> >(common_dim));
     }
-    auto left_ptrs = tatami::create_container_of_Index_size<std::vector<const LeftValue_*> >(max_block_rows);
+    auto left_ptrs = tatami::create_container_of_Index_size<std::vector<const LeftStored*> >(max_block_rows);
 
-    typedef I<decltype(get_output_vector(0)[0])> Output;
-    typename std::conditional<use_local_buffer_, std::vector<std::vector<Output> >, bool>::type tmp_output;
+    typename std::conditional<use_local_buffer_, std::vector<std::vector<Output_> >, bool>::type tmp_output;
     if constexpr(!use_local_buffer_) {
         // Zeroing all of the buffers if we're operating on a single thread,
         // as we're computing partial dot products and we need to start from zero.
@@ -86,7 +97,7 @@ void multiply_dense_row_with_multiple_vectors_blocked_internal(
         const RightVectors_ max_block_cols = sanisizer::min(right_vectors, options.primary_block_size);
         tmp_output.reserve(max_block_cols);
         for (RightVectors_ rc = 0; rc < max_block_cols; ++rc) {
-            tmp_output.emplace_back(tatami::cast_Index_to_container_size<std::vector<Output> >(max_block_rows));
+            tmp_output.emplace_back(tatami::cast_Index_to_container_size<std::vector<Output_> >(max_block_rows));
         }
     }
 
@@ -94,7 +105,7 @@ void multiply_dense_row_with_multiple_vectors_blocked_internal(
     while (lr < length) {
         const LeftIndex_ lr_num = sanisizer::min(options.primary_block_size, length - lr);
         for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-            left_ptrs[lr_counter] = ext->fetch(left_buffers[lr_counter].data());
+            left_ptrs[lr_counter] = fetch_dense_converted<convert>(*ext, raw_buffer, left_buffers[lr_counter]);
         }
 
         RightVectors_ rc = 0;
@@ -130,7 +141,9 @@ void multiply_dense_row_with_multiple_vectors_blocked_internal(
             if constexpr(use_local_buffer_) {
                 for (RightVectors_ rc_counter = 0; rc_counter < rc_num; ++rc_counter) {
                     auto& src = tmp_output[rc_counter];
-                    std::copy_n(src.begin(), lr_num, get_output_vector(rc + rc_counter) + start + lr);
+                    for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
+                        store(rc + rc_counter, start + lr + lr_counter, src[lr_counter]);
+                    }
                     std::fill_n(src.begin(), lr_num, 0);
                 }
             }
@@ -144,6 +157,67 @@ void multiply_dense_row_with_multiple_vectors_blocked_internal(
  * @endcond
  */
 
+/**
+ * @cond
+ */
+// Each completed dot product is passed to 'store(v, r, value)' for vector 'v' and row 'r', e.g., to apply an epilogue without another pass over the output.
+// If 'get_output_vector' is not a nullptr, the single-threaded blocked path accumulates the partial dot products directly in the output arrays instead.
+// Only the columns of 'left' in '[common_start, common_start + common_dim)' are used, e.g., by multiply_partial_with_multiple_vectors(),
+// in which case 'get_right_vector(v)' should point to the RHS entry for 'common_start'.
+template<std::size_t accumulators_, typename Output_, typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_, class Store_>
+void multiply_dense_row_with_multiple_vectors_internal(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ common_start,
+    const LeftIndex_ common_dim,
+    const RightVectors_ right_vectors,
+    GetRightVector_ get_right_vector,
+    GetOutputVector_ get_output_vector,
+    Store_ store,
+    const MultiplyDenseRowWithMultipleVectorsOptions& options
+) {
+    const auto left_NR = left.nrow();
+
+    if (options.primary_block_size == 1) {
+        tatami::parallelize([&](int, const LeftIndex_ start, const LeftIndex_ length) -> void {
+            auto lext = tatami::consecutive_extractor<false>(left, true, start, length, common_start, common_dim);
+            constexpr bool convert = convert_small_integer_left<LeftValue_, I<decltype(get_right_vector(0)[0])> >;
+            auto lbuffer = tatami::create_container_of_Index_size<std::vector<typename std::conditional<convert, Output_, LeftValue_>::type> >(common_dim);
+            std::vector<LeftValue_> raw_buffer;
+            if constexpr(convert) {
+                tatami::resize_container_to_Index_size(raw_buffer, common_dim);
+            }
+
+            for (LeftIndex_ lr = 0; lr < length; ++lr) {
+                const auto lptr = fetch_dense_converted<convert>(*lext, raw_buffer, lbuffer);
+                for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
+                    store(rv, start + lr, dense_dot_product<accumulators_>(
+                        common_dim, // Implicit cast to std::size_t is safe, as per the tatami contract.
+                        lptr,
+                        get_right_vector(rv),
+                        static_cast<Output_>(0)
+                    ));
+                }
+            }
+        }, left_NR, options.num_threads);
+        return;
+    } 
+
+    constexpr bool has_output = !std::is_same<GetOutputVector_, std::nullptr_t>::value;
+    const bool do_parallel = options.num_threads > 1;
+    tatami::parallelize([&](int, const LeftIndex_ start, const LeftIndex_ length) -> void {
+        if constexpr(has_output) {
+            if (!do_parallel) {
+                multiply_dense_row_with_multiple_vectors_blocked_internal<accumulators_, false, Output_>(left, start, length, common_start, common_dim, right_vectors, get_right_vector, get_output_vector, store, options);
+                return;
+            }
+        }
+        multiply_dense_row_with_multiple_vectors_blocked_internal<accumulators_, true, Output_>(left, start, length, common_start, common_dim, right_vectors, get_right_vector, get_output_vector, store, options);
+    }, left_NR, options.num_threads);
+}
+/**
+ * @endcond
+ */
+
 /**
  * @tparam accumulators_ Number of accumulators for computing the dot product,
  * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
@@ -172,37 +246,19 @@ void multiply_dense_row_with_multiple_vectors(
     GetOutputVector_ get_output_vector,
     const MultiplyDenseRowWithMultipleVectorsOptions& options
 ) {
-    const auto left_NR = left.nrow();
-    const auto common_dim = left.ncol();
     typedef I<decltype(get_output_vector(0)[0])> Output;
-
-    if (options.primary_block_size == 1) {
-        tatami::parallelize([&](int, const LeftIndex_ start, const LeftIndex_ length) -> void {
-            auto lext = tatami::consecutive_extractor<false>(left, true, start, length);
-            auto lbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(common_dim);
-            for (LeftIndex_ lr = 0; lr < length; ++lr) {
-                const auto lptr = lext->fetch(lbuffer.data());
-                for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
-                    get_output_vector(rv)[start + lr] = dense_dot_product<accumulators_>(
-                        common_dim, // Implicit cast to std::size_t is safe, as per the tatami contract.
-                        lptr,
-                        get_right_vector(rv),
-                        static_cast<Output>(0)
-                    );
-                }
-            }
-        }, left_NR, options.num_threads);
-        return;
-    } 
-
-    const bool do_parallel = options.num_threads > 1;
-    tatami::parallelize([&](int, const LeftIndex_ start, const LeftIndex_ length) -> void {
-        if (!do_parallel) {
-            multiply_dense_row_with_multiple_vectors_blocked_internal<accumulators_, false>(left, start, length, common_dim, right_vectors, get_right_vector, get_output_vector, options);
-        } else {
-            multiply_dense_row_with_multiple_vectors_blocked_internal<accumulators_, true>(left, start, length, common_dim, right_vectors, get_right_vector, get_output_vector, options);
-        }
-    }, left_NR, options.num_threads);
+    multiply_dense_row_with_multiple_vectors_internal<accumulators_, Output>(
+        left,
+        static_cast<LeftIndex_>(0),
+        left.ncol(),
+        right_vectors,
+        get_right_vector,
+        get_output_vector,
+        [&](const RightVectors_ rv, const LeftIndex_ r, const Output value) -> void {
+            get_output_vector(rv)[r] = value;
+        },
+        options
+    );
 }
 
 /**
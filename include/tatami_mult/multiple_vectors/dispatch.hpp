@@ -89,6 +89,18 @@ inline void set_sparse_block_size(MultiplyWithMultipleVectorsOptions& options, i
     options.sparse_column.block_size = block_size;
 }
 
+/**
+ * Specify whether the LHS matrix is a pattern matrix in all multiplication functions involving a sparse LHS and multiple vectors RHS.
+ * See `MultiplySparseRowWithMultipleVectorsOptions::pattern` for details.
+ *
+ * @param options Options to be set.
+ * @param pattern Whether all non-zero values in the LHS matrix are equal to 1.
+ */
+inline void set_sparse_pattern(MultiplyWithMultipleVectorsOptions& options, bool pattern) {
+    options.sparse_row.pattern = pattern;
+    options.sparse_column.pattern = pattern;
+}
+
 /**
  * This function delegates to `multiply_sparse_row_with_multiple_vectors()`,
  * `multiply_sparse_column_with_multiple_vectors()`,
@@ -35,6 +35,14 @@ struct MultiplySparseColumnWithMultipleVectorsOptions {
      * See the \f$B\f$ parameter in the @ref sparse-blocking "Blocking for sparse matrices" section for more details.
      */
     int block_size = 16;
+
+    /**
+     * Whether `left` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values are not extracted and the multiplication only uses the indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `left` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -51,7 +59,9 @@ void multiply_sparse_column_with_multiple_vectors_internal(
     GetOutputVector_ get_output_vector,
     const MultiplySparseColumnWithMultipleVectorsOptions& options
 ) {
-    auto ext = tatami::consecutive_extractor<true>(left, false, start, length);
+    tatami::Options opt;
+    opt.sparse_extract_value = !options.pattern;
+    auto ext = tatami::consecutive_extractor<true>(left, false, start, length, opt);
     typedef I<decltype(get_output_vector(0)[0])> Output;
 
     if (options.block_size == 1) {
@@ -66,8 +76,14 @@ void multiply_sparse_column_with_multiple_vectors_internal(
             for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
                 const auto optr = get_output_vector(rv);
                 const Output mult = get_right_vector(rv)[start + cd];
-                for (LeftIndex_ x = 0; x < range.number; ++x) {
-                    optr[range.index[x]] += mult * static_cast<Output>(range.value[x]); 
+                if (options.pattern) {
+                    for (LeftIndex_ x = 0; x < range.number; ++x) {
+                        optr[range.index[x]] += mult;
+                    }
+                } else {
+                    for (LeftIndex_ x = 0; x < range.number; ++x) {
+                        optr[range.index[x]] += mult * static_cast<Output>(range.value[x]); 
+                    }
                 }
             }
         }
@@ -117,8 +133,14 @@ void multiply_sparse_column_with_multiple_vectors_internal(
                     for (LeftIndex_ cd_counter = 0; cd_counter < cd_num; ++cd_counter) {
                         const auto& currange = left_ranges[cd_counter];
                         const Output mult = rightvec[cd_base + cd_counter];
-                        for (LeftIndex_ x = 0; x < currange.number; ++x) {
-                            outvec[currange.index[x]] += mult * static_cast<Output>(currange.value[x]);
+                        if (options.pattern) {
+                            for (LeftIndex_ x = 0; x < currange.number; ++x) {
+                                outvec[currange.index[x]] += mult;
+                            }
+                        } else {
+                            for (LeftIndex_ x = 0; x < currange.number; ++x) {
+                                outvec[currange.index[x]] += mult * static_cast<Output>(currange.value[x]);
+                            }
                         }
                     }
                 }
@@ -133,8 +155,14 @@ void multiply_sparse_column_with_multiple_vectors_internal(
                     for (LeftIndex_ cd_counter = 0; cd_counter < cd_num; ++cd_counter) {
                         const auto& currange = left_ranges[cd_counter];
                         const Output mult = rightvec[left_non_empty[cd_counter]];
-                        for (LeftIndex_ x = 0; x < currange.number; ++x) {
-                            outvec[currange.index[x]] += mult * static_cast<Output>(currange.value[x]);
+                        if (options.pattern) {
+                            for (LeftIndex_ x = 0; x < currange.number; ++x) {
+                                outvec[currange.index[x]] += mult;
+                            }
+                        } else {
+                            for (LeftIndex_ x = 0; x < currange.number; ++x) {
+                                outvec[currange.index[x]] += mult * static_cast<Output>(currange.value[x]);
+                            }
                         }
                     }
                 }
@@ -144,46 +172,25 @@ void multiply_sparse_column_with_multiple_vectors_internal(
         }
     }
 }
-/**
- * @endcond
- */
 
-/**
- * Overload of `multiply_sparse_column_with_multiple_vectors()` that uses a vector of pointers to represent the RHS and output vectors.
- *
- * @tparam LeftValue_ Numeric type of the LHS matrix value.
- * @tparam LeftIndex_ Integer type of the LHS matrix index.
- * @tparam RightVectors_ Integer type of the number of RHS vectors.
- * @tparam GetRightVector_ Functor that accepts a `RightIndex_` and returns a pointer to a numeric (typically floating-point) array.
- * @tparam GetOutputVector_ Functor that accepts a `RightIndex_` and returns a pointer to a numeric (typically floating-point) array.
- * 
- * @param left LHS matrix to be multiplied.
- * This function is optimized for sparse matrices that prefer column access, but will work with all matrices.
- * @param right_vectors Number of RHS vectors.
- * @param get_right_vector Function that accepts a `RightIndex_` in `[0, right_vectors)` and returns a pointer to an array of length `left.ncol()`.
- * The array referenced by `get_right_vector(i)` represents the `i`-th RHS vector with which to multiply `left`.
- * This function should be thread-safe.
- * @param get_output_vector Function that accepts a `RightIndex_` in `[0, right_vectors)` and returns a pointer to an array of length `left.nrow()`.
- * On output, the array referenced by by `get_output_vector(i)` stores the product `left * right[i]`.
- * @param options Further options.
- */
-template<typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_>
-void multiply_sparse_column_with_multiple_vectors(
+// Adding the contribution of the columns of 'left' in '[common_start, common_start + common_length)' to the existing contents of the output vectors.
+// This is also used by multiply_partial_with_multiple_vectors() to process a slice of the common dimension.
+// If provided, 'finalize' is applied to each output entry after all contributions are added, see reduce_partial_output_vectors().
+template<typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_, class Finalize_ = std::nullptr_t>
+void multiply_sparse_column_with_multiple_vectors_range(
     const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ common_start,
+    const LeftIndex_ common_length,
     const RightVectors_ right_vectors,
     GetRightVector_ get_right_vector,
     GetOutputVector_ get_output_vector,
-    const MultiplySparseColumnWithMultipleVectorsOptions& options
+    const MultiplySparseColumnWithMultipleVectorsOptions& options,
+    Finalize_ finalize = nullptr
 ) {
     const auto left_NR = left.nrow();
-    const auto common_dim = left.ncol();
-    for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
-        std::fill_n(get_output_vector(rv), left_NR, 0);
-    }
-
     const bool do_parallel = options.num_threads > 1;
     typedef I<decltype(get_output_vector(0)[0])> Output;
-    std::optional<std::vector<std::optional<std::vector<std::vector<Output> > > > > tmp_results;
+    std::optional<std::vector<std::optional<std::vector<Output> > > > tmp_results;
     if (do_parallel) {
         tmp_results.emplace(sanisizer::cast<I<decltype(tmp_results->size())> >(options.num_threads - 1));
     }
@@ -192,7 +199,7 @@ void multiply_sparse_column_with_multiple_vectors(
         if (!do_parallel || t == 0) {
             multiply_sparse_column_with_multiple_vectors_internal(
                 left,
-                start,
+                static_cast<LeftIndex_>(common_start + start),
                 length,
                 left_NR,
                 right_vectors,
@@ -202,39 +209,82 @@ void multiply_sparse_column_with_multiple_vectors(
             );
 
         } else {
-            std::vector<std::vector<Output> > tmp_output;
-            tmp_output.reserve(right_vectors);
-            for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
-                tmp_output.emplace_back(tatami::cast_Index_to_container_size<std::vector<Output> >(left_NR));
-            }
+            // Storing all partial outputs contiguously for reduce_partial_output_vectors().
+            std::vector<Output> tmp_output(sanisizer::product<typename std::vector<Output>::size_type>(right_vectors, left_NR));
             multiply_sparse_column_with_multiple_vectors_internal(
                 left,
-                start,
+                static_cast<LeftIndex_>(common_start + start),
                 length,
                 left_NR,
                 right_vectors,
                 get_right_vector,
                 [&](const RightVectors_ rv) -> Output* {
-                    return tmp_output[rv].data();
+                    return tmp_output.data() + sanisizer::product_unsafe<std::size_t>(rv, left_NR);
                 },
                 options
             );
             (*tmp_results)[t - 1] = std::move(tmp_output);
         }
-    }, common_dim, options.num_threads);
+    }, common_length, options.num_threads);
 
-    if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
-                const auto& tmpvec = tmp[rv];
-                const auto outptr = get_output_vector(rv);
-                for (LeftIndex_ lr = 0; lr < left_NR; ++lr) {
-                    outptr[lr] += tmpvec[lr];
-                }
-            }
-        }
+    // If we're not parallelizing, 'num_used' is no greater than 1 so the partial results are never requested.
+    reduce_partial_output_vectors(
+        right_vectors,
+        get_output_vector,
+        left_NR,
+        [&](const int u) -> const Output* {
+            return (*tmp_results)[u - 1]->data();
+        },
+        num_used,
+        options.num_threads,
+        std::move(finalize)
+    );
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Overload of `multiply_sparse_column_with_multiple_vectors()` that uses a vector of pointers to represent the RHS and output vectors.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightVectors_ Integer type of the number of RHS vectors.
+ * @tparam GetRightVector_ Functor that accepts a `RightIndex_` and returns a pointer to a numeric (typically floating-point) array.
+ * @tparam GetOutputVector_ Functor that accepts a `RightIndex_` and returns a pointer to a numeric (typically floating-point) array.
+ * 
+ * @param left LHS matrix to be multiplied.
+ * This function is optimized for sparse matrices that prefer column access, but will work with all matrices.
+ * @param right_vectors Number of RHS vectors.
+ * @param get_right_vector Function that accepts a `RightIndex_` in `[0, right_vectors)` and returns a pointer to an array of length `left.ncol()`.
+ * The array referenced by `get_right_vector(i)` represents the `i`-th RHS vector with which to multiply `left`.
+ * This function should be thread-safe.
+ * @param get_output_vector Function that accepts a `RightIndex_` in `[0, right_vectors)` and returns a pointer to an array of length `left.nrow()`.
+ * On output, the array referenced by by `get_output_vector(i)` stores the product `left * right[i]`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_>
+void multiply_sparse_column_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightVectors_ right_vectors,
+    GetRightVector_ get_right_vector,
+    GetOutputVector_ get_output_vector,
+    const MultiplySparseColumnWithMultipleVectorsOptions& options
+) {
+    const auto left_NR = left.nrow();
+    for (RightVectors_ rv = 0; rv < right_vectors; ++rv) {
+        std::fill_n(get_output_vector(rv), left_NR, 0);
     }
+
+    multiply_sparse_column_with_multiple_vectors_range(
+        left,
+        static_cast<LeftIndex_>(0),
+        left.ncol(),
+        right_vectors,
+        std::move(get_right_vector),
+        std::move(get_output_vector),
+        options
+    );
 }
 
 /**
@@ -35,44 +35,61 @@ struct MultiplySparseRowWithMultipleVectorsOptions {
      * See the \f$B\f$ parameter in the @ref sparse-blocking "Blocking for sparse matrices" section for more details.
      */
     int block_size = 16;
+
+    /**
+     * Whether `left` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values are not extracted and the multiplication only uses the indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `left` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
- * @tparam accumulators_ Number of accumulators for computing the dot product,
- * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
- * @tparam LeftValue_ Numeric type of the LHS matrix value.
- * @tparam LeftIndex_ Integer type of the LHS matrix index.
- * @tparam RightVectors_ Integer type of the number of RHS vectors.
- * @tparam GetRightVector_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
- * @tparam GetOutputVector_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
- * 
- * @param left LHS matrix to be multiplied.
- * This function is optimized for sparse matrices that prefer row access, but will work with all matrices.
- * @param right_vectors Number of RHS vectors.
- * @param get_right_vector Function that accepts a `RightVectors_` in `[0, right_vectors)` and returns a pointer to an array of length `left.ncol()`.
- * The array referenced by `get_right_vector(i)` represents the `i`-th RHS vector with which to multiply `left`.
- * This function should be thread-safe.
- * @param get_output_vector Function that accepts a `RightVectors_` in `[0, right_vectors)` and returns a pointer to an array of length `left.nrow()`.
- * On output, the array referenced by by `get_output_vector(i)` stores the product `left * right[i]`.
- * This function should be thread-safe.
- * @param options Further options.
+ * @cond
  */
-template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_>
-void multiply_sparse_row_with_multiple_vectors(
+// Each dot product is passed to 'store(v, r, value)' for vector 'v' and row 'r' as soon as it is computed,
+// e.g., to apply an epilogue without another pass over the output.
+// Only the columns of 'left' in '[common_start, common_start + common_dim)' are used, e.g., by multiply_partial_with_multiple_vectors().
+// The extracted indices still refer to the full set of columns, so 'get_right_vector(v)' should point to the start of the full RHS vector.
+template<std::size_t accumulators_, typename Output_, typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, class Store_>
+void multiply_sparse_row_with_multiple_vectors_internal(
     const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ common_start,
+    const LeftIndex_ common_dim,
     const RightVectors_ right_vectors,
     GetRightVector_ get_right_vector,
-    GetOutputVector_ get_output_vector,
+    Store_ store,
     const MultiplySparseRowWithMultipleVectorsOptions& options
 ) {
     const auto left_NR = left.nrow();
-    const auto common_dim = left.ncol();
     const auto right_NC = right_vectors; // using an alias just for consistent terminology.
-    typedef I<decltype(get_output_vector(0)[0])> Output;;
+
+    tatami::Options opt;
+    opt.sparse_extract_value = !options.pattern;
+
+    // Pattern matrices only need a gather-sum of the RHS vector at the indices of each LHS row.
+    auto compute_dot = [&](const tatami::SparseRange<LeftValue_, LeftIndex_>& range, const auto rightvec) -> Output_ {
+        if (options.pattern) {
+            return sparse_pattern_dot_product<accumulators_>(
+                range.number, // Implicit cast to size_t is safe, as per the tatami contract.
+                range.index,
+                rightvec,
+                static_cast<Output_>(0)
+            );
+        }
+        return sparse_dot_product<accumulators_>(
+            range.number, // Implicit cast to size_t is safe, as per the tatami contract.
+            range.value,
+            range.index,
+            rightvec,
+            static_cast<Output_>(0)
+        );
+    };
 
     if (options.block_size == 1) {
         tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-            auto ext = tatami::consecutive_extractor<true>(left, true, start, length);
+            auto ext = tatami::consecutive_extractor<true>(left, true, start, length, common_start, common_dim, opt);
             auto vbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(common_dim);
             auto ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(common_dim);
 
@@ -80,26 +97,20 @@ void multiply_sparse_row_with_multiple_vectors(
                 const auto range = ext->fetch(vbuffer.data(), ibuffer.data());
                 if (range.number == 0) {
                     for (RightVectors_ rv = 0; rv < right_NC; ++rv) {
-                        get_output_vector(rv)[start + lr] = 0;
+                        store(rv, start + lr, static_cast<Output_>(0));
                     }
                     continue;
                 }
 
                 for (RightVectors_ rv = 0; rv < right_NC; ++rv) {
-                    get_output_vector(rv)[start + lr] = sparse_dot_product<accumulators_>(
-                        range.number, // Implicit cast to size_t is safe, as per the tatami contract.
-                        range.value,
-                        range.index,
-                        get_right_vector(rv),
-                        static_cast<Output>(0)
-                    );
+                    store(rv, start + lr, compute_dot(range, get_right_vector(rv)));
                 }
             }
         }, left_NR, options.num_threads);
 
     } else {
         tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-            auto ext = tatami::consecutive_extractor<true>(left, true, start, length);
+            auto ext = tatami::consecutive_extractor<true>(left, true, start, length, common_start, common_dim, opt);
 
             std::vector<std::vector<LeftValue_> > left_vbuffers;
             std::vector<std::vector<LeftIndex_> > left_ibuffers;
@@ -118,7 +129,7 @@ void multiply_sparse_row_with_multiple_vectors(
             LeftIndex_ lr = 0;
             while (lr < length) {
                 // No point skipping the LHS rows with no structural non-zeros.
-                // We still need to set the corresponding entry of 'outvec' to zero, so we'd end up having to loop through the LHS rows anyway.
+                // We still need to set the corresponding entry of the output to zero, so we'd end up having to loop through the LHS rows anyway.
                 // We might as well just let it be set to zero naturally in the existing loop below.
                 const LeftIndex_ lr_num = sanisizer::min(options.block_size, length - lr);
                 for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
@@ -127,16 +138,8 @@ void multiply_sparse_row_with_multiple_vectors(
 
                 for (RightVectors_ rv = 0; rv < right_NC; ++rv) {
                     const auto rightvec = get_right_vector(rv);
-                    const auto outvec = get_output_vector(rv);
                     for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-                        const auto& currange = left_ranges[lr_counter];
-                        outvec[start + lr + lr_counter] = sparse_dot_product<accumulators_>(
-                            currange.number, // Implicit cast of range.number to size_t is safe, as per the tatami contract.
-                            currange.value,
-                            currange.index,
-                            rightvec,
-                            static_cast<Output>(0)
-                        );
+                        store(rv, start + lr + lr_counter, compute_dot(left_ranges[lr_counter], rightvec));
                     }
                 }
 
@@ -145,6 +148,51 @@ void multiply_sparse_row_with_multiple_vectors(
         }, left_NR, options.num_threads);
     }
 }
+/**
+ * @endcond
+ */
+
+/**
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightVectors_ Integer type of the number of RHS vectors.
+ * @tparam GetRightVector_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
+ * @tparam GetOutputVector_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
+ * 
+ * @param left LHS matrix to be multiplied.
+ * This function is optimized for sparse matrices that prefer row access, but will work with all matrices.
+ * @param right_vectors Number of RHS vectors.
+ * @param get_right_vector Function that accepts a `RightVectors_` in `[0, right_vectors)` and returns a pointer to an array of length `left.ncol()`.
+ * The array referenced by `get_right_vector(i)` represents the `i`-th RHS vector with which to multiply `left`.
+ * This function should be thread-safe.
+ * @param get_output_vector Function that accepts a `RightVectors_` in `[0, right_vectors)` and returns a pointer to an array of length `left.nrow()`.
+ * On output, the array referenced by by `get_output_vector(i)` stores the product `left * right[i]`.
+ * This function should be thread-safe.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_>
+void multiply_sparse_row_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightVectors_ right_vectors,
+    GetRightVector_ get_right_vector,
+    GetOutputVector_ get_output_vector,
+    const MultiplySparseRowWithMultipleVectorsOptions& options
+) {
+    typedef I<decltype(get_output_vector(0)[0])> Output;
+    multiply_sparse_row_with_multiple_vectors_internal<accumulators_, Output>(
+        left,
+        static_cast<LeftIndex_>(0),
+        left.ncol(),
+        right_vectors,
+        std::move(get_right_vector),
+        [&](const RightVectors_ rv, const LeftIndex_ r, const Output value) -> void {
+            get_output_vector(rv)[r] = value;
+        },
+        options
+    );
+}
 
 /**
  * Overload of `multiply_sparse_row_with_multiple_vectors()` that uses a vector of pointers to represent the RHS and output vectors.
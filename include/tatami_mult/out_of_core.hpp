@@ -0,0 +1,277 @@
+#ifndef TATAMI_MULT_OUT_OF_CORE_HPP
+#define TATAMI_MULT_OUT_OF_CORE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+
+/**
+ * @file out_of_core.hpp
+ * @brief Tiled multiplication of matrices that are too large to fit in memory.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `multiply_out_of_core_to_tiles()` and `multiply_out_of_core()`.
+ */
+struct MultiplyOutOfCoreOptions {
+    /**
+     * Maximum number of elements in each tile of the output matrix.
+     * The tile is as square as possible, subject to the dimensions of the output matrix.
+     * Larger tiles reduce the total amount of data extracted from `left` and `right` but increase memory usage.
+     * This should be positive.
+     */
+    std::size_t output_tile_size = 4194304;
+
+    /**
+     * Number of elements of the common dimension to process at once.
+     * Each step holds one tile of `left` with this many columns and one tile of `right` with this many rows.
+     * Non-positive values are treated as 1.
+     * Different block sizes may slightly change the results for floating-point types due to changes in the order of summations.
+     */
+    int common_block_size = 1024;
+
+    /**
+     * Number of threads to use.
+     * Different numbers of threads will not change the results.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @cond
+ */
+// Extracting a block of a matrix into a row-major tile.
+// If the matrix prefers columns, we extract the block in column-major format and transpose it afterwards.
+template<typename Value_, typename Index_>
+void extract_dense_tile(
+    const tatami::Matrix<Value_, Index_>& matrix,
+    const Index_ row_start,
+    const Index_ row_length,
+    const Index_ col_start,
+    const Index_ col_length,
+    std::vector<Value_>& work,
+    Value_* const tile
+) {
+    if (matrix.prefer_rows()) {
+        auto ext = tatami::consecutive_extractor<false>(matrix, true, row_start, row_length, col_start, col_length);
+        for (Index_ r = 0; r < row_length; ++r) {
+            const auto dest = tile + sanisizer::product_unsafe<std::size_t>(r, col_length);
+            const auto ptr = ext->fetch(dest);
+            if (ptr != dest) {
+                std::copy_n(ptr, col_length, dest);
+            }
+        }
+
+    } else {
+        auto ext = tatami::consecutive_extractor<false>(matrix, false, col_start, col_length, row_start, row_length);
+        for (Index_ c = 0; c < col_length; ++c) {
+            const auto dest = work.data() + sanisizer::product_unsafe<std::size_t>(c, row_length);
+            const auto ptr = ext->fetch(dest);
+            if (ptr != dest) {
+                std::copy_n(ptr, row_length, dest);
+            }
+        }
+        transpose_tile<false>(work.data(), col_length, row_length, row_length, tile, col_length);
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Compute the product of `left` and `right` when neither can be realized in memory, e.g., for large matrices in HDF5 files.
+ * The output matrix is partitioned into tiles, and each tile is computed by iterating over blocks of the common dimension.
+ * For each block, the corresponding tiles of `left` and `right` are extracted with **tatami**'s block extractors and multiplied into the output tile.
+ * Once a tile is complete, it is passed to `callback`.
+ *
+ * Each output tile requires a pass through its rows of `left` and its columns of `right`.
+ * For an \f$m\f$-by-\f$k\f$ LHS and a \f$k\f$-by-\f$n\f$ RHS with \f$b_m\f$-by-\f$b_n\f$ output tiles,
+ * the total number of extracted elements is \f$mkn/b_n + mkn/b_m\f$.
+ * This is minimized for a fixed output tile size \f$S = b_m b_n\f$ by setting \f$b_m = b_n = \sqrt{S}\f$,
+ * which is the classic I/O-optimal schedule for matrix multiplication.
+ * If either output dimension is smaller than \f$\sqrt{S}\f$, the other dimension of the tile is extended to use the full budget.
+ * Memory usage is approximately \f$S + (b_m + b_n) b_k\f$ elements where \f$b_k\f$ is `MultiplyOutOfCoreOptions::common_block_size`.
+ *
+ * Within each step, the extraction of `right` and the extraction and multiplication of `left` are parallelized across rows of the tiles.
+ * Zeros in `left` are skipped so sparse LHS matrices are handled with reasonable efficiency, though all tiles are stored in dense form.
+ * This is done regardless of the representation of `left`, so a zero in `left` will not propagate any non-finite values in the corresponding row of `right`,
+ * i.e., \f$0 \times \infty\f$ and \f$0 \times \mathrm{NaN}\f$ are treated as zero.
+ * This is consistent with the sparse kernels used by `multiply_with_matrix()` but may differ from its dense kernels for a dense `left`.
+ *
+ * @tparam Output_ Numeric type of the output array.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Callback_ Function to process each output tile.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right RHS matrix to be multiplied.
+ * The number of rows in this matrix should be equal to the number of columns in `left`.
+ * @param callback Function that accepts five arguments - `row_start`, a `LeftIndex_` specifying the first row of the tile;
+ * `row_length`, a `LeftIndex_` specifying the number of rows in the tile;
+ * `col_start`, a `RightIndex_` specifying the first column of the tile;
+ * `col_length`, a `RightIndex_` specifying the number of columns in the tile;
+ * and `tile`, a `const Output_*` pointing to an array of length `row_length * col_length`.
+ * The array contains the corresponding block of the product of `left` and `right` in row-major format.
+ * This array is only valid for the duration of the call, and should be copied if its contents are required afterwards.
+ * Tiles are reported serially in row-major order of the tiles, i.e., all tiles for the first set of rows are reported before those of the next set of rows.
+ * @param options Further options.
+ */
+template<typename Output_ = double, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, class Callback_>
+void multiply_out_of_core_to_tiles(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Callback_ callback,
+    const MultiplyOutOfCoreOptions& options
+) {
+    const LeftIndex_ left_NR = left.nrow();
+    const LeftIndex_ common_dim = left.ncol();
+    const RightIndex_ right_NC = right.ncol();
+    if (left_NR == 0 || right_NC == 0) {
+        return;
+    }
+
+    // Choosing square output tiles where possible, see the function documentation.
+    const std::size_t budget = std::max<std::size_t>(options.output_tile_size, 1);
+    const std::size_t side = std::max<std::size_t>(std::sqrt(static_cast<double>(budget)), 1);
+    const RightIndex_ tile_cols = sanisizer::min(right_NC, std::max<std::size_t>(side, budget / sanisizer::cast<std::size_t>(left_NR)));
+    const LeftIndex_ tile_rows = sanisizer::min(left_NR, std::max<std::size_t>(budget / sanisizer::cast<std::size_t>(tile_cols), 1));
+    const LeftIndex_ max_common = sanisizer::min(common_dim, std::max(options.common_block_size, 1));
+
+    std::vector<Output_> out_tile(sanisizer::product<typename std::vector<Output_>::size_type>(tile_rows, tile_cols));
+    std::vector<RightValue_> right_tile(sanisizer::product<typename std::vector<RightValue_>::size_type>(max_common, tile_cols));
+
+    LeftIndex_ row_start = 0;
+    while (row_start < left_NR) {
+        const LeftIndex_ row_length = sanisizer::min(tile_rows, left_NR - row_start);
+
+        RightIndex_ col_start = 0;
+        while (col_start < right_NC) {
+            const RightIndex_ col_length = sanisizer::min(tile_cols, right_NC - col_start);
+            std::fill_n(out_tile.data(), sanisizer::product_unsafe<std::size_t>(row_length, col_length), 0);
+
+            LeftIndex_ common_start = 0;
+            while (common_start < common_dim) {
+                const LeftIndex_ common_length = sanisizer::min(max_common, common_dim - common_start);
+
+                tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
+                    std::vector<RightValue_> work;
+                    if (!right.prefer_rows()) {
+                        sanisizer::resize(work, sanisizer::product<std::size_t>(length, col_length));
+                    }
+                    extract_dense_tile(
+                        right,
+                        static_cast<RightIndex_>(common_start + start),
+                        static_cast<RightIndex_>(length),
+                        col_start,
+                        col_length,
+                        work,
+                        right_tile.data() + sanisizer::product_unsafe<std::size_t>(start, col_length)
+                    );
+                }, common_length, options.num_threads);
+
+                tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
+                    const auto tile_size = sanisizer::product<std::size_t>(length, common_length);
+                    std::vector<LeftValue_> left_tile(tile_size), work;
+                    if (!left.prefer_rows()) {
+                        sanisizer::resize(work, tile_size);
+                    }
+                    extract_dense_tile(left, row_start + start, length, common_start, common_length, work, left_tile.data());
+
+                    for (LeftIndex_ r = 0; r < length; ++r) {
+                        const auto lptr = left_tile.data() + sanisizer::product_unsafe<std::size_t>(r, common_length);
+                        const auto optr = out_tile.data() + sanisizer::product_unsafe<std::size_t>(start + r, col_length);
+                        for (LeftIndex_ k = 0; k < common_length; ++k) {
+                            const Output_ mult = lptr[k];
+                            if (mult == 0) { // see the comments about non-finite values in the function documentation.
+                                continue;
+                            }
+                            const auto rptr = right_tile.data() + sanisizer::product_unsafe<std::size_t>(k, col_length);
+                            for (RightIndex_ c = 0; c < col_length; ++c) {
+                                optr[c] += mult * static_cast<Output_>(rptr[c]);
+                            }
+                        }
+                    }
+                }, row_length, options.num_threads);
+
+                common_start += common_length;
+            }
+
+            callback(row_start, row_length, col_start, col_length, static_cast<const Output_*>(out_tile.data()));
+            col_start += col_length;
+        }
+
+        row_start += row_length;
+    }
+}
+
+/**
+ * Compute the product of `left` and `right` when neither can be realized in memory, storing the result in an array.
+ * This calls `multiply_out_of_core_to_tiles()` and copies each tile into `output`.
+ * Each element of `output` is written exactly once and is never read, so `output` does not need to be initialized.
+ * This is useful when `output` is a memory-mapped file, as it avoids zeroing the file beforehand or reading back any pages.
+ *
+ * @tparam Output_ Numeric type of the output array.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right RHS matrix to be multiplied.
+ * The number of rows in this matrix should be equal to the number of columns in `left`.
+ * @param[out] output Pointer to an array of length equal to `left.nrow() * right.ncol()`.
+ * On output, this stores the product of `left` and `right`.
+ * @param row_major Whether to store the product in row-major format.
+ * If false, the product is stored in column-major format.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void multiply_out_of_core(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Output_* const output,
+    const bool row_major,
+    const MultiplyOutOfCoreOptions& options
+) {
+    const auto left_NR = left.nrow();
+    const auto right_NC = right.ncol();
+    multiply_out_of_core_to_tiles<Output_>(
+        left,
+        right,
+        [&](LeftIndex_ row_start, LeftIndex_ row_length, RightIndex_ col_start, RightIndex_ col_length, const Output_* tile) -> void {
+            if (row_major) {
+                for (LeftIndex_ r = 0; r < row_length; ++r) {
+                    std::copy_n(
+                        tile + sanisizer::product_unsafe<std::size_t>(r, col_length),
+                        col_length,
+                        output + sanisizer::nd_offset<std::size_t>(col_start, right_NC, row_start + r)
+                    );
+                }
+            } else {
+                transpose_tile<false>(
+                    tile,
+                    row_length,
+                    col_length,
+                    col_length,
+                    output + sanisizer::nd_offset<std::size_t>(row_start, left_NR, col_start),
+                    left_NR
+                );
+            }
+        },
+        options
+    );
+}
+
+}
+
+#endif
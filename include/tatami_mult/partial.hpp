@@ -0,0 +1,249 @@
+#ifndef TATAMI_MULT_PARTIAL_HPP
+#define TATAMI_MULT_PARTIAL_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+#include "multiple_vectors/dispatch.hpp"
+#include "epilogue.hpp"
+
+/**
+ * @file partial.hpp
+ * @brief Accumulate the contribution of a slice of the common dimension.
+ */
+
+namespace tatami_mult {
+
+/**
+ * Add the contribution of a slice of the common dimension to an existing product of a matrix `left` and multiple vectors `right`.
+ * Specifically, for each `i`, this computes `output[i] += left[, s] * right[i][s]` where `s` is the sequence `common_start, ..., common_start + common_length - 1`.
+ * Calling this function on consecutive slices that span the common dimension yields the same result as `multiply_with_multiple_vectors()`,
+ * up to differences in floating-point round-off error.
+ *
+ * This allows the product to be split across multiple processes (e.g., each process handles a slice of the columns of `left`, followed by a sum of the outputs),
+ * resumed after an interruption (by recording the slices that have already been processed),
+ * or updated when new columns are added to `left` (by processing only the new columns).
+ *
+ * The slice is processed with the same kernels as `multiply_with_multiple_vectors()`, restricted to the corresponding block of columns of `left`.
+ * For row-based kernels, each dot product over the slice is added to the existing entry of `output`;
+ * for column-based kernels, the contributions of the columns are accumulated directly into `output` without needing to zero it first.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightVectors_ Integer type of the number of RHS vectors.
+ * @tparam GetRightVector_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
+ * @tparam GetOutputVector_ Functor that accepts a `RightVectors_` and returns a pointer to a numeric (typically floating-point) array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param common_start Start of the slice of the common dimension, i.e., the first column of `left`.
+ * @param common_length Length of the slice of the common dimension.
+ * `common_start + common_length` should be no greater than `left.ncol()`.
+ * @param right_vectors Number of RHS vectors.
+ * @param get_right_vector Function that accepts a `RightVectors_` in `[0, right_vectors)` and returns a pointer to an array of length `left.ncol()`.
+ * The array referenced by `get_right_vector(i)` represents the `i`-th RHS vector, though only the entries in `[common_start, common_start + common_length)` are accessed.
+ * This function should be thread-safe.
+ * @param get_output_vector Function that accepts a `RightVectors_` in `[0, right_vectors)` and returns a pointer to an array of length `left.nrow()`.
+ * On input, the array referenced by `get_output_vector(i)` should contain the existing product for the `i`-th RHS vector, or zeros if no slices have been processed yet.
+ * On output, the contribution of the slice is added to each entry.
+ * This function should be thread-safe.
+ * @param options Further options.
+ * The options for the kernel corresponding to the sparsity and preferred access of `left` are used.
+ */
+template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightVectors_, typename GetRightVector_, typename GetOutputVector_>
+void multiply_partial_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ common_start,
+    const LeftIndex_ common_length,
+    const RightVectors_ right_vectors,
+    GetRightVector_ get_right_vector,
+    GetOutputVector_ get_output_vector,
+    const MultiplyWithMultipleVectorsOptions& options
+) {
+    const bool sparse = left.is_sparse();
+    typedef I<decltype(get_output_vector(0)[0])> Output;
+
+    if (left.prefer_rows()) {
+        auto store = [&](const RightVectors_ rv, const LeftIndex_ r, const Output value) -> void {
+            get_output_vector(rv)[r] += value;
+        };
+
+        if (sparse) {
+            multiply_sparse_row_with_multiple_vectors_internal<accumulators_, Output>(
+                left,
+                common_start,
+                common_length,
+                right_vectors,
+                get_right_vector,
+                store,
+                options.sparse_row
+            );
+        } else {
+            // Dense blocks are extracted contiguously, so the RHS vectors need to start at the beginning of the slice.
+            multiply_dense_row_with_multiple_vectors_internal<accumulators_, Output>(
+                left,
+                common_start,
+                common_length,
+                right_vectors,
+                [&](const RightVectors_ rv) -> decltype(get_right_vector(rv)) {
+                    return get_right_vector(rv) + common_start;
+                },
+                nullptr,
+                store,
+                options.dense_row
+            );
+        }
+        return;
+    }
+
+    if (sparse) {
+        multiply_sparse_column_with_multiple_vectors_range(left, common_start, common_length, right_vectors, get_right_vector, get_output_vector, options.sparse_column);
+    } else {
+        multiply_dense_column_with_multiple_vectors_range(left, common_start, common_length, right_vectors, get_right_vector, get_output_vector, options.dense_column);
+    }
+}
+
+/**
+ * Overload of `multiply_partial_with_multiple_vectors()` that uses a vector of pointers to represent the RHS and output vectors.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param common_start Start of the slice of the common dimension, i.e., the first column of `left`.
+ * @param common_length Length of the slice of the common dimension.
+ * `common_start + common_length` should be no greater than `left.ncol()`.
+ * @param[in] right Vector of pointers, each of which points to an array of length `left.ncol()`.
+ * Each entry contains an RHS vector with which to multiply `left`.
+ * @param[in,out] output Vector of length equal to `right.size()`.
+ * Each entry is a pointer to an array of length `left.nrow()` containing the existing product for the corresponding RHS vector.
+ * On output, the contribution of the slice is added to each array.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void multiply_partial_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ common_start,
+    const LeftIndex_ common_length,
+    const std::vector<RightValue_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplyWithMultipleVectorsOptions& options
+) {
+    const auto right_vectors = right.size();
+    typedef I<decltype(right_vectors)> RightVectors;
+    multiply_partial_with_multiple_vectors<accumulators_>(
+        left,
+        common_start,
+        common_length,
+        right_vectors,
+        [&](const RightVectors rv) -> const RightValue_* {
+            return right[rv];
+        },
+        [&](const RightVectors rv) -> Output_* {
+            return output[rv];
+        },
+        options
+    );
+}
+
+/**
+ * @brief Options for `multiply_partial_with_matrix()`.
+ */
+struct MultiplyPartialWithMatrixOptions {
+    /**
+     * Options to pass to `multiply_with_matrix_to_row_blocks()`, if `left` prefers row access.
+     */
+    MultiplyWithMatrixToRowBlocksOptions row_blocks;
+
+    /**
+     * Options to pass to `multiply_with_dense_matrix()`, if `left` prefers column access and `right` is dense.
+     */
+    MultiplyWithDenseMatrixOptions dense_matrix;
+
+    /**
+     * Options to pass to `multiply_with_sparse_matrix()`, if `left` prefers column access and `right` is sparse.
+     */
+    MultiplyWithSparseMatrixOptions sparse_matrix;
+};
+
+/**
+ * Set the number of threads to use in `multiply_partial_with_matrix()`.
+ *
+ * @param options Options to be set.
+ * @param num_threads Number of threads, should be positive.
+ */
+inline void set_num_threads(MultiplyPartialWithMatrixOptions& options, int num_threads) {
+    options.row_blocks.num_threads = num_threads;
+    set_num_threads(options.dense_matrix, num_threads);
+    set_num_threads(options.sparse_matrix, num_threads);
+}
+
+/**
+ * Add the contribution of a slice of the common dimension to an existing product of two matrices `left` and `right`.
+ * Specifically, this computes `output += left[, s] * right[s, ]` where `s` is the sequence `common_start, ..., common_start + common_length - 1`.
+ * Calling this function on consecutive slices that span the common dimension yields the same result as `multiply_with_matrix()`,
+ * up to differences in floating-point round-off error.
+ *
+ * The slices of `left` and `right` are represented by `tatami::DelayedSubsetBlock` views,
+ * which are multiplied by `multiply_with_matrix_and_update()` with `beta = 1`.
+ * If `left` prefers row access, each block of output rows is added to `output` as it is computed;
+ * otherwise, a temporary array of the same size as `output` is allocated to hold the contribution of the slice.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right RHS matrix to be multiplied.
+ * `right.nrow()` and `left.ncol()` should be equal.
+ * @param common_start Start of the slice of the common dimension, i.e., the first column of `left` and the first row of `right`.
+ * @param common_length Length of the slice of the common dimension.
+ * `common_start + common_length` should be no greater than `left.ncol()`.
+ * @param[in,out] output Pointer to an array of length equal to `left.nrow() * right.ncol()`.
+ * On input, this should contain the existing product, or zeros if no slices have been processed yet.
+ * On output, the contribution of the slice is added to each entry.
+ * @param output_row_major Whether `output` is in row-major format.
+ * If false, `output` is assumed to be in column-major format.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void multiply_partial_with_matrix(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    const LeftIndex_ common_start,
+    const LeftIndex_ common_length,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplyPartialWithMatrixOptions& options
+) {
+    const auto left_slice = tatami::make_DelayedSubsetBlock<LeftValue_, LeftIndex_>(tatami::wrap_shared_ptr(&left), common_start, common_length, false);
+    const auto right_slice = tatami::make_DelayedSubsetBlock<RightValue_, RightIndex_>(
+        tatami::wrap_shared_ptr(&right),
+        static_cast<RightIndex_>(common_start),
+        static_cast<RightIndex_>(common_length),
+        true
+    );
+
+    MultiplyWithMatrixAndUpdateOptions update_options;
+    update_options.beta = 1;
+    update_options.row_blocks = options.row_blocks;
+    update_options.dense_matrix = options.dense_matrix;
+    update_options.sparse_matrix = options.sparse_matrix;
+
+    multiply_with_matrix_and_update(*left_slice, *right_slice, output, output_row_major, update_options);
+}
+
+}
+
+#endif
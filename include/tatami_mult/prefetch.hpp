@@ -0,0 +1,390 @@
+#ifndef TATAMI_MULT_PREFETCH_HPP
+#define TATAMI_MULT_PREFETCH_HPP
+
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+/**
+ * @file prefetch.hpp
+ * @brief Prefetching of rows/columns in a separate thread.
+ *
+ * This header is not included by `tatami_mult.hpp` and should be included separately.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `PrefetchedMatrix`.
+ */
+struct PrefetchOptions {
+    /**
+     * Number of buffers in the ring for each extractor, i.e., the maximum number of rows/columns that can be prefetched before they are requested.
+     * Larger values can smooth over variable I/O latencies at the cost of more memory.
+     * Values less than 1 are treated as 1.
+     */
+    int num_buffers = 4;
+
+    /**
+     * Minimum number of rows/columns that an oracle must predict for its extractor to be prefetched.
+     * Each prefetching extractor starts its own I/O thread, and the multiplication functions may construct many short-lived extractors,
+     * e.g., one per block or tile; for these, the cost of starting a thread is not recovered by overlapping I/O with computation.
+     * Extractors with fewer predictions are passed through to the underlying matrix without any prefetching.
+     * Setting this to zero will prefetch all oracle-aware extractors.
+     */
+    std::size_t min_predictions = 32;
+};
+
+/**
+ * @cond
+ */
+class PrefetchRing {
+public:
+    PrefetchRing(const std::size_t total, const int num_buffers) : my_total(total), my_num_buffers(num_buffers) {}
+
+    ~PrefetchRing() {
+        stop();
+    }
+
+    // Start this after all slots have been allocated by the owner.
+    template<class Fill_>
+    void start(Fill_ fill) {
+        my_thread = std::thread([this, fill]() mutable -> void {
+            for (std::size_t k = 0; k < my_total; ++k) {
+                {
+                    std::unique_lock lck(my_mutex);
+                    my_cv.wait(lck, [&]() -> bool { return my_stop || my_produced - my_consumed < static_cast<std::size_t>(my_num_buffers); });
+                    if (my_stop) {
+                        return;
+                    }
+                }
+
+                try {
+                    fill(k % my_num_buffers);
+                } catch (...) {
+                    std::lock_guard lck(my_mutex);
+                    my_error = std::current_exception();
+                    my_cv.notify_all();
+                    return;
+                }
+
+                {
+                    std::lock_guard lck(my_mutex);
+                    ++my_produced;
+                }
+                my_cv.notify_all();
+            }
+        });
+    }
+
+    template<class Consume_>
+    void consume(Consume_ consume) {
+        {
+            std::unique_lock lck(my_mutex);
+            my_cv.wait(lck, [&]() -> bool { return my_produced > my_consumed || my_error; });
+            if (my_produced == my_consumed) {
+                std::rethrow_exception(my_error);
+            }
+        }
+
+        // Safe to read without the lock, as the producer will not touch this slot until 'my_consumed' is incremented.
+        consume(my_consumed % my_num_buffers);
+
+        {
+            std::lock_guard lck(my_mutex);
+            ++my_consumed;
+        }
+        my_cv.notify_all();
+    }
+
+    void stop() {
+        if (my_thread.joinable()) {
+            {
+                std::lock_guard lck(my_mutex);
+                my_stop = true;
+            }
+            my_cv.notify_all();
+            my_thread.join();
+        }
+    }
+
+private:
+    std::size_t my_total;
+    int my_num_buffers;
+
+    std::mutex my_mutex;
+    std::condition_variable my_cv;
+    std::size_t my_produced = 0, my_consumed = 0;
+    bool my_stop = false;
+    std::exception_ptr my_error;
+    std::thread my_thread;
+};
+
+template<typename Value_, typename Index_>
+class PrefetchedDenseExtractor final : public tatami::OracularDenseExtractor<Value_, Index_> {
+public:
+    PrefetchedDenseExtractor(
+        std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > inner,
+        const std::size_t total,
+        const Index_ extent,
+        const PrefetchOptions& options
+    ) :
+        my_inner(std::move(inner)),
+        my_extent(extent),
+        my_ring(total, options.num_buffers)
+    {
+        my_slots.reserve(options.num_buffers);
+        for (int b = 0; b < options.num_buffers; ++b) {
+            my_slots.emplace_back(tatami::cast_Index_to_container_size<std::vector<Value_> >(my_extent));
+        }
+
+        my_ring.start([this](const int b) -> void {
+            auto& slot = my_slots[b];
+            auto ptr = my_inner->fetch(slot.data());
+            if (ptr != slot.data()) {
+                std::copy_n(ptr, my_extent, slot.data());
+            }
+        });
+    }
+
+    ~PrefetchedDenseExtractor() {
+        my_ring.stop(); // must stop before the slots are destroyed.
+    }
+
+    const Value_* fetch(const Index_, Value_* const buffer) {
+        // We copy into the caller's buffer so that the returned pointer is not invalidated by the next prefetch.
+        my_ring.consume([&](const int b) -> void {
+            std::copy_n(my_slots[b].data(), my_extent, buffer);
+        });
+        return buffer;
+    }
+
+private:
+    std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > my_inner;
+    Index_ my_extent;
+    std::vector<std::vector<Value_> > my_slots;
+    PrefetchRing my_ring;
+};
+
+template<typename Value_, typename Index_>
+class PrefetchedSparseExtractor final : public tatami::OracularSparseExtractor<Value_, Index_> {
+public:
+    PrefetchedSparseExtractor(
+        std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > inner,
+        const std::size_t total,
+        const Index_ extent,
+        const PrefetchOptions& options
+    ) :
+        my_inner(std::move(inner)),
+        my_ring(total, options.num_buffers)
+    {
+        my_slots.reserve(options.num_buffers);
+        for (int b = 0; b < options.num_buffers; ++b) {
+            my_slots.emplace_back(extent);
+        }
+
+        my_ring.start([this](const int b) -> void {
+            auto& slot = my_slots[b];
+            auto range = my_inner->fetch(slot.value.data(), slot.index.data());
+            slot.number = range.number;
+            slot.has_value = (range.value != NULL);
+            if (slot.has_value && range.value != slot.value.data()) {
+                std::copy_n(range.value, range.number, slot.value.data());
+            }
+            slot.has_index = (range.index != NULL);
+            if (slot.has_index && range.index != slot.index.data()) {
+                std::copy_n(range.index, range.number, slot.index.data());
+            }
+        });
+    }
+
+    ~PrefetchedSparseExtractor() {
+        my_ring.stop(); // must stop before the slots are destroyed.
+    }
+
+    tatami::SparseRange<Value_, Index_> fetch(const Index_, Value_* const vbuffer, Index_* const ibuffer) {
+        tatami::SparseRange<Value_, Index_> output;
+        my_ring.consume([&](const int b) -> void {
+            const auto& slot = my_slots[b];
+            output.number = slot.number;
+            if (slot.has_value) {
+                std::copy_n(slot.value.data(), slot.number, vbuffer);
+                output.value = vbuffer;
+            }
+            if (slot.has_index) {
+                std::copy_n(slot.index.data(), slot.number, ibuffer);
+                output.index = ibuffer;
+            }
+        });
+        return output;
+    }
+
+private:
+    struct Slot {
+        Slot(const Index_ extent) :
+            value(tatami::cast_Index_to_container_size<std::vector<Value_> >(extent)),
+            index(tatami::cast_Index_to_container_size<std::vector<Index_> >(extent)) {}
+        std::vector<Value_> value;
+        std::vector<Index_> index;
+        Index_ number = 0;
+        bool has_value = false, has_index = false;
+    };
+
+    std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > my_inner;
+    std::vector<Slot> my_slots;
+    PrefetchRing my_ring;
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Matrix that prefetches rows/columns in a separate thread.
+ *
+ * This wraps an existing `tatami::Matrix` so that each oracle-aware extractor runs a dedicated I/O thread.
+ * The I/O thread uses the oracle to fetch upcoming rows/columns from the underlying matrix into a ring of buffers,
+ * while the calling thread performs computations on the rows/columns that were previously fetched.
+ * This allows I/O and computation to overlap, which is most useful when the underlying matrix is file-backed (e.g., HDF5) or otherwise slow to extract.
+ *
+ * All multiplication functions in this library use oracle-aware extractors to iterate over the LHS matrix,
+ * so a `PrefetchedMatrix` can be supplied as the LHS to any of them.
+ * Each oracle-aware extractor has its own I/O thread, so each of the `num_threads` workers in a multiplication will have at least one I/O thread.
+ * Some functions construct a new extractor for each block of rows/columns, in which case a new I/O thread is started for each block;
+ * extractors for fewer than `PrefetchOptions::min_predictions` rows/columns are not prefetched, to avoid paying the thread creation cost for little overlap.
+ * Extractors without an oracle are passed through to the underlying matrix without any prefetching.
+ *
+ * For in-memory matrices, prefetching is unlikely to be beneficial as each row/column is copied into the caller's buffer.
+ *
+ * @tparam Value_ Numeric type of the matrix value.
+ * @tparam Index_ Integer type of the matrix index.
+ */
+template<typename Value_, typename Index_>
+class PrefetchedMatrix final : public tatami::Matrix<Value_, Index_> {
+public:
+    /**
+     * @param matrix Pointer to the underlying matrix.
+     * @param options Further options.
+     */
+    PrefetchedMatrix(std::shared_ptr<const tatami::Matrix<Value_, Index_> > matrix, const PrefetchOptions& options) :
+        my_matrix(std::move(matrix)), my_options(options)
+    {
+        // The ring needs at least one slot, otherwise the I/O thread would never be allowed to fill anything.
+        if (my_options.num_buffers < 1) {
+            my_options.num_buffers = 1;
+        }
+    }
+
+private:
+    std::shared_ptr<const tatami::Matrix<Value_, Index_> > my_matrix;
+    PrefetchOptions my_options;
+
+    typedef std::shared_ptr<const tatami::Oracle<Index_> > OraclePtr;
+
+    // Short-lived extractors are not worth the cost of starting an I/O thread, see PrefetchOptions::min_predictions.
+    template<class Inner_>
+    std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > wrap_dense(const OraclePtr& oracle, const Index_ extent, Inner_ inner) const {
+        const std::size_t total = oracle->total();
+        if (total < my_options.min_predictions) {
+            return inner;
+        }
+        return std::make_unique<PrefetchedDenseExtractor<Value_, Index_> >(std::move(inner), total, extent, my_options);
+    }
+
+    template<class Inner_>
+    std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > wrap_sparse(const OraclePtr& oracle, const Index_ extent, Inner_ inner) const {
+        const std::size_t total = oracle->total();
+        if (total < my_options.min_predictions) {
+            return inner;
+        }
+        return std::make_unique<PrefetchedSparseExtractor<Value_, Index_> >(std::move(inner), total, extent, my_options);
+    }
+
+    Index_ full_extent(const bool row) const {
+        return (row ? my_matrix->ncol() : my_matrix->nrow());
+    }
+
+public:
+    /**
+     * @cond
+     */
+    Index_ nrow() const { return my_matrix->nrow(); }
+
+    Index_ ncol() const { return my_matrix->ncol(); }
+
+    bool is_sparse() const { return my_matrix->is_sparse(); }
+
+    double is_sparse_proportion() const { return my_matrix->is_sparse_proportion(); }
+
+    bool prefer_rows() const { return my_matrix->prefer_rows(); }
+
+    double prefer_rows_proportion() const { return my_matrix->prefer_rows_proportion(); }
+
+    bool uses_oracle(const bool) const { return true; }
+
+public:
+    std::unique_ptr<tatami::MyopicDenseExtractor<Value_, Index_> > dense(const bool row, const tatami::Options& opt) const {
+        return my_matrix->dense(row, opt);
+    }
+
+    std::unique_ptr<tatami::MyopicDenseExtractor<Value_, Index_> > dense(const bool row, const Index_ block_start, const Index_ block_length, const tatami::Options& opt) const {
+        return my_matrix->dense(row, block_start, block_length, opt);
+    }
+
+    std::unique_ptr<tatami::MyopicDenseExtractor<Value_, Index_> > dense(const bool row, tatami::VectorPtr<Index_> indices_ptr, const tatami::Options& opt) const {
+        return my_matrix->dense(row, std::move(indices_ptr), opt);
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<Value_, Index_> > sparse(const bool row, const tatami::Options& opt) const {
+        return my_matrix->sparse(row, opt);
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<Value_, Index_> > sparse(const bool row, const Index_ block_start, const Index_ block_length, const tatami::Options& opt) const {
+        return my_matrix->sparse(row, block_start, block_length, opt);
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<Value_, Index_> > sparse(const bool row, tatami::VectorPtr<Index_> indices_ptr, const tatami::Options& opt) const {
+        return my_matrix->sparse(row, std::move(indices_ptr), opt);
+    }
+
+public:
+    std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > dense(const bool row, OraclePtr oracle, const tatami::Options& opt) const {
+        return wrap_dense(oracle, full_extent(row), my_matrix->dense(row, oracle, opt));
+    }
+
+    std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > dense(const bool row, OraclePtr oracle, const Index_ block_start, const Index_ block_length, const tatami::Options& opt) const {
+        return wrap_dense(oracle, block_length, my_matrix->dense(row, oracle, block_start, block_length, opt));
+    }
+
+    std::unique_ptr<tatami::OracularDenseExtractor<Value_, Index_> > dense(const bool row, OraclePtr oracle, tatami::VectorPtr<Index_> indices_ptr, const tatami::Options& opt) const {
+        const Index_ extent = indices_ptr->size();
+        return wrap_dense(oracle, extent, my_matrix->dense(row, oracle, std::move(indices_ptr), opt));
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > sparse(const bool row, OraclePtr oracle, const tatami::Options& opt) const {
+        return wrap_sparse(oracle, full_extent(row), my_matrix->sparse(row, oracle, opt));
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > sparse(const bool row, OraclePtr oracle, const Index_ block_start, const Index_ block_length, const tatami::Options& opt) const {
+        return wrap_sparse(oracle, block_length, my_matrix->sparse(row, oracle, block_start, block_length, opt));
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<Value_, Index_> > sparse(const bool row, OraclePtr oracle, tatami::VectorPtr<Index_> indices_ptr, const tatami::Options& opt) const {
+        const Index_ extent = indices_ptr->size();
+        return wrap_sparse(oracle, extent, my_matrix->sparse(row, oracle, std::move(indices_ptr), opt));
+    }
+    /**
+     * @endcond
+     */
+};
+
+}
+
+#endif
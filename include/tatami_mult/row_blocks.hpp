@@ -0,0 +1,363 @@
+#ifndef TATAMI_MULT_ROW_BLOCKS_HPP
+#define TATAMI_MULT_ROW_BLOCKS_HPP
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <ostream>
+#include <type_traits>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "dense_matrix/utils.hpp"
+#include "dense_matrix/dense_row/row_to_row.hpp"
+#include "dense_matrix/sparse_row/row_to_row.hpp"
+#include "sparse_matrix/utils.hpp"
+#include "sparse_matrix/dense_row/row_to_row.hpp"
+#include "sparse_matrix/sparse_row/row_to_row.hpp"
+#include "utils.hpp"
+
+/**
+ * @file row_blocks.hpp
+ * @brief Any matrix LHS, any matrix RHS, row-major output in blocks of rows.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `multiply_with_matrix_to_row_blocks()`.
+ */
+struct MultiplyWithMatrixToRowBlocksOptions {
+    /**
+     * Number of threads to use.
+     * Different numbers of threads will not change the results.
+     */
+    int num_threads = 1;
+
+    /**
+     * Block size, i.e., the number of output rows in each block that is passed to the callback.
+     * Each thread holds one block at a time, so the amount of in-flight output memory is equal to `num_threads * block_size * right.ncol()`.
+     * For dense matrices, this is also used as the \f$B\f$ parameter in the @ref dense-blocking "Blocking for dense matrices" section.
+     * Non-positive values are treated as 1.
+     */
+    int block_size = 16;
+
+    /**
+     * Secondary block size, i.e., the number of RHS columns to be processed in each block.
+     * This is only used if both `left` and `right` are dense.
+     * See the \f$C\f$ parameter in the @ref dense-blocking "Blocking for dense matrices" section for more details.
+     * Different secondary block sizes will not change the results.
+     */
+    int secondary_block_size = 64;
+
+    /**
+     * Number of output rows to buffer in `multiply_with_matrix_to_ordered_row_blocks()` and `multiply_with_matrix_to_stream()`.
+     * All threads cooperate to fill this buffer before it is passed to the callback,
+     * so the amount of in-flight output memory is equal to `ordered_block_size * right.ncol()`, regardless of the number of threads.
+     * Larger values reduce the number of synchronization points between threads.
+     * Each round also creates a new extractor for each thread's subset of rows in `left`,
+     * so small values incur repeated setup costs (and re-reading of any partially consumed chunks) for file-backed matrices.
+     * Non-positive values are treated as 1.
+     */
+    int ordered_block_size = 1024;
+};
+
+/**
+ * @cond
+ */
+template<typename Output_, typename LeftIndex_, typename RightColumns_, class Setup_, class Callback_>
+void stream_row_blocks(
+    const LeftIndex_ left_NR,
+    const RightColumns_ right_columns,
+    Setup_ setup,
+    Callback_& callback,
+    const MultiplyWithMatrixToRowBlocksOptions& options
+) {
+    const int block_size = std::max(options.block_size, 1); // ensure that each block makes progress.
+    tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
+        auto compute = setup(start, length);
+
+        const LeftIndex_ max_block_rows = sanisizer::min(length, block_size);
+        std::vector<Output_> block;
+        block.resize(sanisizer::product<I<decltype(block.size())> >(max_block_rows, right_columns));
+
+        LeftIndex_ lr = 0;
+        while (lr < length) {
+            const LeftIndex_ lr_num = sanisizer::min(block_size, length - lr);
+            std::fill_n(block.data(), sanisizer::product_unsafe<std::size_t>(lr_num, right_columns), 0);
+            compute(lr_num, block.data());
+            callback(start + lr, lr_num, static_cast<const Output_*>(block.data()));
+            lr += lr_num;
+        }
+    }, left_NR, options.num_threads);
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @cond
+ */
+template<typename Output_, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, class Stream_>
+void dispatch_row_blocks(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Stream_ stream,
+    const MultiplyWithMatrixToRowBlocksOptions& options
+) {
+    const auto common_dim = left.ncol();
+    const auto right_NC = right.ncol();
+    const int block_size = std::max(options.block_size, 1);
+
+    // We re-use the per-block computations of the row-to-row kernels, so the results are the same as those in multiply_with_matrix().
+    if (right.is_sparse()) {
+        auto right_vbuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(common_dim);
+        auto right_ibuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightIndex_> > >(common_dim);
+        auto right_ranges = tatami::create_container_of_Index_size<std::vector<tatami::SparseRange<RightValue_, RightIndex_> > >(common_dim);
+        populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, false, options.num_threads);
+
+        if (left.is_sparse()) {
+            MultiplySparseRowWithSparseRowMatrixToRowOutputOptions kopt;
+            kopt.num_threads = options.num_threads;
+            const auto right_dense = densify_sparse_buffers(common_dim, right_NC, right_vbuffers, right_ibuffers, right_ranges, kopt.dense_threshold, kopt.num_threads);
+
+            stream([&](const LeftIndex_ start, const LeftIndex_ length) {
+                return setup_sparse_row_with_sparse_row_matrix_to_row_blocks<Output_>(left, start, length, right_NC, right_ranges, right_dense);
+            });
+
+        } else {
+            MultiplyDenseRowWithSparseRowMatrixToRowOutputOptions kopt;
+            kopt.num_threads = options.num_threads;
+            kopt.block_size = block_size;
+            const auto right_dense = densify_sparse_buffers(common_dim, right_NC, right_vbuffers, right_ibuffers, right_ranges, kopt.dense_threshold, kopt.num_threads);
+
+            // If there are any empty RHS rows, we only iterate over the non-empty ones in the loop for each LHS block.
+            auto right_non_empty = filter_non_empty_sparse(
+                right_ranges,
+                [&](RightIndex_) -> void {}
+            );
+
+            stream([&](const LeftIndex_ start, const LeftIndex_ length) {
+                return setup_dense_row_with_sparse_row_matrix_to_row_blocks<Output_>(left, start, length, right_NC, right_ranges, right_dense, right_non_empty, kopt);
+            });
+        }
+
+    } else {
+        auto right_buffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(common_dim);
+        auto right_ptrs = tatami::create_container_of_Index_size<std::vector<const RightValue_*> >(common_dim);
+        populate_dense_buffers(true, common_dim, right_NC, right, right_buffers, right_ptrs, options.num_threads);
+        auto get_right_row = [&](const LeftIndex_ cd) -> const RightValue_* {
+            return right_ptrs[cd];
+        };
+
+        if (left.is_sparse()) {
+            stream([&](const LeftIndex_ start, const LeftIndex_ length) {
+                return setup_sparse_row_with_dense_row_matrix_to_row_blocks<Output_>(left, start, length, right_NC, get_right_row);
+            });
+
+        } else {
+            MultiplyDenseRowWithDenseRowMatrixToRowOutputOptions kopt;
+            kopt.num_threads = options.num_threads;
+            kopt.primary_block_size = block_size;
+            kopt.secondary_block_size = options.secondary_block_size;
+            stream([&](const LeftIndex_ start, const LeftIndex_ length) {
+                return setup_dense_row_with_dense_row_matrix_to_row_blocks<Output_>(left, start, length, right_NC, get_right_row, kopt);
+            });
+        }
+    }
+}
+
+template<typename Output_, typename LeftIndex_, typename RightColumns_, class Setup_, class Callback_>
+void stream_ordered_row_blocks(
+    const LeftIndex_ left_NR,
+    const RightColumns_ right_columns,
+    Setup_ setup,
+    Callback_& callback,
+    const MultiplyWithMatrixToRowBlocksOptions& options
+) {
+    const int ordered_block_size = std::max(options.ordered_block_size, 1); // ensure that each round makes progress.
+    const int block_size = std::max(options.block_size, 1);
+    const LeftIndex_ max_rows = sanisizer::min(left_NR, ordered_block_size);
+    std::vector<Output_> buffer(sanisizer::product<typename std::vector<Output_>::size_type>(max_rows, right_columns));
+
+    // Each round fills a contiguous set of rows in the shared buffer before passing it to the callback on the calling thread.
+    // This guarantees that the callback sees the rows in order, e.g., for sequential writes to a file.
+    LeftIndex_ done = 0;
+    while (done < left_NR) {
+        const LeftIndex_ num = sanisizer::min(ordered_block_size, left_NR - done);
+
+        tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
+            auto compute = setup(done + start, length);
+            LeftIndex_ lr = 0;
+            while (lr < length) {
+                const LeftIndex_ lr_num = sanisizer::min(block_size, length - lr);
+                const auto block = buffer.data() + sanisizer::product_unsafe<std::size_t>(start + lr, right_columns);
+                std::fill_n(block, sanisizer::product_unsafe<std::size_t>(lr_num, right_columns), 0);
+                compute(lr_num, block);
+                lr += lr_num;
+            }
+        }, num, options.num_threads);
+
+        const auto bptr = static_cast<const Output_*>(buffer.data());
+        if constexpr(std::is_same<I<decltype(callback(done, num, bptr))>, bool>::value) {
+            if (!callback(done, num, bptr)) {
+                return;
+            }
+        } else {
+            callback(done, num, bptr);
+        }
+        done += num;
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Compute the product of `left` and `right` in row-major format, emitting each block of completed output rows through `callback`.
+ * This avoids the need to allocate an array for the entire product, e.g., when the results are to be written to disk or reduced on the fly.
+ *
+ * This function will iterate over the rows of `left`, realizing them into memory as needed.
+ * It will also realize all of `right` into memory for fast repeated accesses.
+ * Dense and sparse matrices are handled with the same algorithms as `multiply_dense_row_with_dense_row_matrix_to_row_output()`,
+ * `multiply_sparse_row_with_dense_row_matrix_to_row_output()`, `multiply_dense_row_with_sparse_row_matrix_to_row_output()`
+ * and `multiply_sparse_row_with_sparse_row_matrix_to_row_output()`.
+ *
+ * @tparam Output_ Numeric type of the output array.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Callback_ Function to process each block of output rows.
+ *
+ * @param left LHS matrix to be multiplied.
+ * This function is optimized for matrices that prefer row access, but will work with all matrices.
+ * @param right RHS matrix to be multiplied.
+ * This function is optimized for matrices that prefer row access, but will work with all matrices.
+ * The number of rows in this matrix should be equal to the number of columns in `left`.
+ * @param callback Function that accepts three arguments - `start`, a `LeftIndex_` specifying the first row of the block;
+ * `length`, a `LeftIndex_` specifying the number of rows in the block;
+ * and `block`, a `const Output_*` pointing to an array of length `length * right.ncol()`.
+ * The array contains rows `[start, start + length)` of the product of `left` and `right` in row-major format.
+ * This array is only valid for the duration of the call, and should be copied if its contents are required afterwards.
+ * Each thread will call `callback` on its blocks in order of increasing `start`,
+ * but if `MultiplyWithMatrixToRowBlocksOptions::num_threads > 1`, this function may be called concurrently by different threads and should be thread-safe.
+ * @param options Further options.
+ */
+template<typename Output_ = double, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, class Callback_>
+void multiply_with_matrix_to_row_blocks(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Callback_ callback,
+    const MultiplyWithMatrixToRowBlocksOptions& options
+) {
+    const auto left_NR = left.nrow();
+    const auto right_NC = right.ncol();
+    dispatch_row_blocks<Output_>(
+        left,
+        right,
+        [&](auto setup) -> void {
+            stream_row_blocks<Output_>(left_NR, right_NC, std::move(setup), callback, options);
+        },
+        options
+    );
+}
+
+
+/**
+ * Compute the product of `left` and `right` in row-major format, emitting blocks of completed output rows through `callback` in order of increasing row index.
+ * This is similar to `multiply_with_matrix_to_row_blocks()` except that `callback` is always called serially on the calling thread,
+ * and each call contains the rows immediately following those of the previous call.
+ * This is useful for writing the product sequentially to a file-backed destination when it is too large to fit in memory;
+ * each row of the output is written exactly once, without the need to zero the destination beforehand or to read back any part of it.
+ *
+ * The output is computed in rounds of `MultiplyWithMatrixToRowBlocksOptions::ordered_block_size` rows.
+ * In each round, all threads cooperate to fill a buffer with the corresponding rows of the product, which is then passed to `callback`.
+ * Threads are idle while `callback` is running, so any expensive I/O should be buffered by the caller.
+ *
+ * @tparam Output_ Numeric type of the output array.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Callback_ Function to process each block of output rows.
+ *
+ * @param left LHS matrix to be multiplied.
+ * This function is optimized for matrices that prefer row access, but will work with all matrices.
+ * @param right RHS matrix to be multiplied.
+ * This function is optimized for matrices that prefer row access, but will work with all matrices.
+ * The number of rows in this matrix should be equal to the number of columns in `left`.
+ * @param callback Function that accepts three arguments, as described for `multiply_with_matrix_to_row_blocks()`.
+ * Each block contains no more than `MultiplyWithMatrixToRowBlocksOptions::ordered_block_size` rows.
+ * If `callback` returns a `bool`, a false value stops the iteration so that no further rows of the product are computed.
+ * @param options Further options.
+ */
+template<typename Output_ = double, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, class Callback_>
+void multiply_with_matrix_to_ordered_row_blocks(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    Callback_ callback,
+    const MultiplyWithMatrixToRowBlocksOptions& options
+) {
+    const auto left_NR = left.nrow();
+    const auto right_NC = right.ncol();
+    dispatch_row_blocks<Output_>(
+        left,
+        right,
+        [&](auto setup) -> void {
+            stream_ordered_row_blocks<Output_>(left_NR, right_NC, std::move(setup), callback, options);
+        },
+        options
+    );
+}
+
+/**
+ * Compute the product of `left` and `right` and write it to `stream` as a row-major array of `Output_` values in native binary format.
+ * This calls `multiply_with_matrix_to_ordered_row_blocks()` so that the output is written sequentially in fixed-size chunks,
+ * with memory usage bounded by `MultiplyWithMatrixToRowBlocksOptions::ordered_block_size`.
+ * If `stream` is a `std::ofstream`, the file will contain the product in the same layout as the output array of `multiply_with_matrix()` with `row_major = true`,
+ * and can subsequently be memory-mapped for random access.
+ * If a column-major layout is desired, users can instead compute the transposed product by swapping and transposing `left` and `right`.
+ *
+ * @tparam Output_ Numeric type of the output array.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right RHS matrix to be multiplied.
+ * The number of rows in this matrix should be equal to the number of columns in `left`.
+ * @param stream Output stream, typically opened in binary mode.
+ * The iteration stops as soon as the stream enters a failed state, so no further rows of the product are computed or written.
+ * Callers should check the state of `stream` (e.g., with `stream.fail()`) after this function returns.
+ * @param options Further options.
+ */
+template<typename Output_ = double, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_>
+void multiply_with_matrix_to_stream(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    std::ostream& stream,
+    const MultiplyWithMatrixToRowBlocksOptions& options
+) {
+    if (!stream) {
+        return;
+    }
+
+    const auto right_NC = right.ncol();
+    multiply_with_matrix_to_ordered_row_blocks<Output_>(
+        left,
+        right,
+        [&](LeftIndex_, LeftIndex_ length, const Output_* block) -> bool {
+            const auto num_bytes = sanisizer::product<std::streamsize>(sizeof(Output_), length, right_NC);
+            stream.write(reinterpret_cast<const char*>(block), num_bytes);
+            return static_cast<bool>(stream);
+        },
+        options
+    );
+}
+
+}
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef TATAMI_MULT_SINGLE_VECTOR_COMPRESSED_SPARSE_ROW_HPP
+#define TATAMI_MULT_SINGLE_VECTOR_COMPRESSED_SPARSE_ROW_HPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "../utils.hpp"
+#include "../sparse_dot_product.hpp"
+
+/**
+ * @file compressed_sparse_row.hpp
+ * @brief In-memory compressed sparse row LHS, single vector RHS.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `multiply_compressed_sparse_row_with_single_vector()`.
+ */
+struct MultiplyCompressedSparseRowWithSingleVectorOptions {
+    /**
+     * Number of threads to use.
+     * Different numbers of threads may slightly change the results due to differences in floating-point round-off error.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @cond
+ */
+// Finding the coordinates at which the merge path crosses the 'diagonal'-th diagonal,
+// where the path merges the row end offsets (i.e., 'pointers[1:nrow] - pointers[0]') with the natural numbers (i.e., indices of the non-zero elements).
+// We return the row at which the crossing occurs; the non-zero index is just 'diagonal - row + pointers[0]'.
+template<typename Index_, typename Pointer_>
+Index_ merge_path_search(const Pointer_ diagonal, const Index_ nrow, const Pointer_ num_non_zeros, const Pointer_* const pointers) {
+    const Pointer_ offset = pointers[0];
+    Index_ lower = (diagonal > num_non_zeros ? diagonal - num_non_zeros : 0);
+    Index_ upper = sanisizer::min(diagonal, nrow);
+    while (lower < upper) {
+        const Index_ pivot = lower + (upper - lower) / 2;
+        if (pointers[pivot + 1] - offset < diagonal - pivot) {
+            lower = pivot + 1;
+        } else {
+            upper = pivot;
+        }
+    }
+    return lower;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Multiply an in-memory compressed sparse row matrix with a single vector, using a merge-path decomposition to balance work across threads.
+ * `multiply_sparse_row_with_single_vector()` partitions the rows across threads, which is ineffective if a few rows contain most of the non-zero elements.
+ * Instead, this function considers the combined sequence of row boundaries and non-zero elements and splits it evenly across threads.
+ * Each thread then processes an equal number of rows and non-zeros, regardless of how the non-zero elements are distributed across rows.
+ * Rows that are split across threads are handled by adding each thread's partial result for its last row in a small serial pass.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam Pointer_ Integer type of the row pointers.
+ * @tparam RightValue_ Numeric type of the RHS vector.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param nrow Number of rows in the LHS matrix.
+ * @param[in] values Pointer to an array of non-zero values, ordered by row.
+ * @param[in] indices Pointer to an array of column indices for the non-zero values.
+ * @param[in] pointers Pointer to an array of length `nrow + 1`, containing the row pointers.
+ * The non-zero elements of row `r` are stored in `values` and `indices` in the interval `[pointers[r], pointers[r + 1])`.
+ * `pointers[0]` does not have to be zero, e.g., if the rows are a slice of a larger matrix.
+ * @param[in] right Pointer to an array of length equal to the number of columns of the LHS matrix,
+ * containing the RHS vector.
+ * @param[out] output Pointer to an array of length `nrow`.
+ * On output, this stores the product of the LHS matrix and `right`.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename Value_, typename Index_, typename Pointer_, typename RightValue_, typename Output_>
+void multiply_compressed_sparse_row_with_single_vector(
+    const Index_ nrow,
+    const Value_* const values,
+    const Index_* const indices,
+    const Pointer_* const pointers,
+    const RightValue_* const right,
+    Output_* const output,
+    const MultiplyCompressedSparseRowWithSingleVectorOptions& options
+) {
+    const Pointer_ offset = pointers[0];
+    const Pointer_ num_non_zeros = pointers[nrow] - offset;
+    const Pointer_ total = sanisizer::sum<Pointer_>(nrow, num_non_zeros);
+    const int num_threads = std::max(options.num_threads, 1); // partitions can be empty if there are more threads than rows + non-zeros, which is fine.
+
+    // Each partition stores the partial dot product of its last row, which is incomplete if the row continues into the next partition.
+    auto carry_rows = sanisizer::create<std::vector<Index_> >(num_threads);
+    auto carry_values = sanisizer::create<std::vector<Output_> >(num_threads);
+
+    const Pointer_ per_thread = total / num_threads;
+    const Pointer_ remainder = total % num_threads;
+    auto get_diagonal = [&](const int p) -> Pointer_ {
+        return per_thread * p + std::min(static_cast<Pointer_>(p), remainder);
+    };
+
+    tatami::parallelize([&](int, int start, int length) -> void {
+        for (int p = start, end = start + length; p < end; ++p) {
+            const Pointer_ first_diagonal = get_diagonal(p), last_diagonal = get_diagonal(p + 1);
+            Index_ row = merge_path_search(first_diagonal, nrow, num_non_zeros, pointers);
+            Pointer_ nz = first_diagonal - row + offset;
+            const Index_ last_row = merge_path_search(last_diagonal, nrow, num_non_zeros, pointers);
+            const Pointer_ last_nz = last_diagonal - last_row + offset;
+
+            // Rows before 'last_row' are completed in this partition.
+            for (; row < last_row; ++row) {
+                const Pointer_ row_end = pointers[row + 1];
+                output[row] = sparse_dot_product<accumulators_>(row_end - nz, values + nz, indices + nz, right, static_cast<Output_>(0));
+                nz = row_end;
+            }
+
+            carry_rows[p] = last_row;
+            carry_values[p] = sparse_dot_product<accumulators_>(last_nz - nz, values + nz, indices + nz, right, static_cast<Output_>(0));
+        }
+    }, num_threads, num_threads);
+
+    for (int p = 0; p < num_threads; ++p) {
+        if (carry_rows[p] < nrow) {
+            output[carry_rows[p]] += carry_values[p];
+        }
+    }
+}
+
+}
+
+#endif
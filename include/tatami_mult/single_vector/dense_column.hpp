@@ -3,13 +3,13 @@
 
 #include <cstddef>
 #include <vector>
-#include <optional>
 #include <algorithm>
 
 #include "tatami/tatami.hpp"
 #include "sanisizer/sanisizer.hpp"
 
 #include "../utils.hpp"
+#include "workspace.hpp"
 
 /**
  * @file dense_column.hpp
@@ -46,58 +46,80 @@ struct MultiplyDenseColumnWithSingleVectorOptions {
  * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
  * On output, this stores the product `left * right`.
  * @param options Further options.
+ * @param workspace Workspace whose buffers are reused across calls.
  */
 template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
 void multiply_dense_column_with_single_vector(
     const tatami::Matrix<LeftValue_, LeftIndex_>& left,
     const RightValue_* const right,
     Output_* const output,
-    const MultiplyDenseColumnWithSingleVectorOptions& options
+    const MultiplyDenseColumnWithSingleVectorOptions& options,
+    SingleVectorWorkspace<LeftValue_, LeftIndex_, Output_>& workspace
 ) {
     const auto NR = left.nrow();
     const auto NC = left.ncol();
-
-    std::optional<std::vector<std::optional<std::vector<Output_> > > > tmp_results;
-    const bool do_parallel = options.num_threads > 1;
-    if (do_parallel) {
-        tmp_results.emplace(sanisizer::cast<I<decltype(tmp_results->size())> >(options.num_threads - 1));
-    }
+    workspace.prepare(std::max(options.num_threads, 1));
     std::fill_n(output, NR, 0);
 
     const auto num_used = tatami::parallelize([&](int t, LeftIndex_ start, LeftIndex_ length) -> void {
         auto ext = tatami::consecutive_extractor<false>(left, false, start, length);
-        auto buffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(NR);
+        const auto buffer = workspace.value_buffer(t, NR);
 
-        Output_* optr;
-        std::optional<std::vector<Output_> > cur_output;
-        if (!do_parallel || t == 0) {
-            optr = output;
-        } else {
-            cur_output.emplace(tatami::cast_Index_to_container_size<std::vector<Output_> >(NR));
-            optr = cur_output->data();
+        // The first thread writes directly to the output, while all other threads accumulate into their own buffers.
+        Output_* optr = output;
+        if (t > 0) {
+            optr = workspace.output_buffer(t, NR);
+            std::fill_n(optr, NR, 0);
         }
 
         for (LeftIndex_ c = 0; c < length; ++c) {
-            auto ptr = ext->fetch(buffer.data());
+            auto ptr = ext->fetch(buffer);
             const Output_ mult = right[start + c];
             for (LeftIndex_ r = 0; r < NR; ++r) {
                 optr[r] += mult * ptr[r];
             }
         }
-
-        if (do_parallel && t > 0) {
-            (*tmp_results)[t - 1] = std::move(cur_output);            
-        }
     }, NC, options.num_threads);
 
-    if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            for (LeftIndex_ r = 0; r < NR; ++r) {
-                output[r] += tmp[r];
-            }
-        }
-    }
+    const auto partials = workspace.partial_outputs(num_used, NR);
+    reduce_partial_output_vectors(
+        1,
+        [&](int) -> Output_* {
+            return output;
+        },
+        NR,
+        [&](const int u) -> const Output_* {
+            return partials[u];
+        },
+        num_used,
+        options.num_threads
+    );
+}
+
+/**
+ * Overload that allocates a new `SingleVectorWorkspace` for each call.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vector. 
+ * @tparam Output_ Numeric type of the output array.
+ * 
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On output, this stores the product `left * right`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void multiply_dense_column_with_single_vector(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightValue_* const right,
+    Output_* const output,
+    const MultiplyDenseColumnWithSingleVectorOptions& options
+) {
+    SingleVectorWorkspace<LeftValue_, LeftIndex_, Output_> workspace;
+    multiply_dense_column_with_single_vector(left, right, output, options, workspace);
 }
 
 }
@@ -3,10 +3,12 @@
 
 #include <cstddef>
 #include <vector>
+#include <algorithm>
 
 #include "tatami/tatami.hpp"
 
 #include "../dense_dot_product.hpp"
+#include "workspace.hpp"
 
 /**
  * @file dense_row.hpp
@@ -30,6 +32,39 @@ struct MultiplyDenseRowWithSingleVectorOptions {
     int num_threads = 1;
 };
 
+/**
+ * @cond
+ */
+// Each dot product is passed to 'store(r, value)' for row 'r' as soon as it is computed, e.g., to apply an epilogue without another pass over the output.
+template<std::size_t accumulators_, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_, class Store_>
+void multiply_dense_row_with_single_vector_internal(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightValue_* const right,
+    Store_ store,
+    const MultiplyDenseRowWithSingleVectorOptions& options,
+    SingleVectorWorkspace<LeftValue_, LeftIndex_, Output_>& workspace
+) {
+    const auto NR = left.nrow();
+    const auto NC = left.ncol();
+    workspace.prepare(std::max(options.num_threads, 1));
+    tatami::parallelize([&](int t, LeftIndex_ start, LeftIndex_ length) -> void {
+        auto ext = tatami::consecutive_extractor<false>(left, true, start, length);
+        const auto buffer = workspace.value_buffer(t, NC);
+        for (LeftIndex_ r = start, end = start + length; r < end; ++r) {
+            auto ptr = ext->fetch(buffer);
+            store(r, dense_dot_product<accumulators_>(
+                NC, // tatami's contract guarantees that NC will fit in a std::size_t, so no need to protect the function call.
+                ptr,
+                right,
+                static_cast<Output_>(0)
+            ));
+        }
+    }, NR, options.num_threads);
+}
+/**
+ * @endcond
+ */
+
 /**
  * @tparam accumulators_ Number of accumulators for computing the dot product,
  * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
@@ -45,6 +80,43 @@ struct MultiplyDenseRowWithSingleVectorOptions {
  * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
  * On output, this stores the product `left * right`.
  * @param options Further options.
+ * @param workspace Workspace whose buffers are reused across calls.
+ */
+template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void multiply_dense_row_with_single_vector(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightValue_* const right,
+    Output_* const output,
+    const MultiplyDenseRowWithSingleVectorOptions& options,
+    SingleVectorWorkspace<LeftValue_, LeftIndex_, Output_>& workspace
+) {
+    multiply_dense_row_with_single_vector_internal<accumulators_>(
+        left,
+        right,
+        [&](const LeftIndex_ r, const Output_ value) -> void {
+            output[r] = value;
+        },
+        options,
+        workspace
+    );
+}
+
+/**
+ * Overload that allocates a new `SingleVectorWorkspace` for each call.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vector.
+ * @tparam Output_ Numeric type of the output array.
+ * 
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On output, this stores the product `left * right`.
+ * @param options Further options.
  */
 template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
 void multiply_dense_row_with_single_vector(
@@ -53,21 +125,8 @@ void multiply_dense_row_with_single_vector(
     Output_* const output,
     const MultiplyDenseRowWithSingleVectorOptions& options
 ) {
-    const auto NR = left.nrow();
-    const auto NC = left.ncol();
-    tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-        auto ext = tatami::consecutive_extractor<false>(left, true, start, length);
-        auto buffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(NC);
-        for (LeftIndex_ r = start, end = start + length; r < end; ++r) {
-            auto ptr = ext->fetch(buffer.data());
-            output[r] = dense_dot_product<accumulators_>(
-                NC, // tatami's contract guarantees that NC will fit in a std::size_t, so no need to protect the function call.
-                ptr,
-                right,
-                static_cast<Output_>(0)
-            );
-        }
-    }, NR, options.num_threads);
+    SingleVectorWorkspace<LeftValue_, LeftIndex_, Output_> workspace;
+    multiply_dense_row_with_single_vector<accumulators_>(left, right, output, options, workspace);
 }
 
 }
@@ -5,6 +5,7 @@
 #include "dense_column.hpp"
 #include "sparse_row.hpp"
 #include "sparse_column.hpp"
+#include "workspace.hpp"
 
 /**
  * @file dispatch.hpp
@@ -52,6 +53,18 @@ inline void set_num_threads(MultiplyWithSingleVectorOptions& options, int num_th
     options.sparse_column.num_threads = num_threads;
 }
 
+/**
+ * Specify whether the LHS matrix is a pattern matrix in all multiplication functions involving a sparse LHS and a single vector RHS.
+ * See `MultiplySparseRowWithSingleVectorOptions::pattern` for details.
+ *
+ * @param options Options to be set.
+ * @param pattern Whether all non-zero values in the LHS matrix are equal to 1.
+ */
+inline void set_sparse_pattern(MultiplyWithSingleVectorOptions& options, bool pattern) {
+    options.sparse_row.pattern = pattern;
+    options.sparse_column.pattern = pattern;
+}
+
 /**
  * This function delegates to `multiply_sparse_row_with_single_vector()`,
  * `multiply_sparse_column_with_single_vector()`,
@@ -95,6 +108,47 @@ void multiply_with_single_vector(
     }
 }
 
+/**
+ * Overload of `multiply_with_single_vector()` that reuses the buffers in `workspace` across calls.
+ * 
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam Right_ Numeric type of the RHS vector. 
+ * @tparam Output_ Numeric type of the output array.
+ * 
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On output, this stores the product `left * right`.
+ * @param options Further options.
+ * @param workspace Workspace whose buffers are reused across calls.
+ */
+template<std::size_t accumulators_ = 4, typename Value_, typename Index_, typename Right_, typename Output_>
+void multiply_with_single_vector(
+    const tatami::Matrix<Value_, Index_>& left,
+    const Right_* const right,
+    Output_* const output,
+    const MultiplyWithSingleVectorOptions& options,
+    SingleVectorWorkspace<Value_, Index_, Output_>& workspace
+) {
+    if (left.is_sparse()) {
+        if (left.prefer_rows()) {
+            multiply_sparse_row_with_single_vector<accumulators_>(left, right, output, options.sparse_row, workspace);
+        } else {
+            multiply_sparse_column_with_single_vector(left, right, output, options.sparse_column, workspace);
+        }
+    } else {
+        if (left.prefer_rows()) {
+            multiply_dense_row_with_single_vector<accumulators_>(left, right, output, options.dense_row, workspace);
+        } else {
+            multiply_dense_column_with_single_vector(left, right, output, options.dense_column, workspace);
+        }
+    }
+}
+
 /**
  * Overload that wraps `right` in a `tatami::DelayedTranspose` and calls `multiply_with_single_vector()`.
  * 
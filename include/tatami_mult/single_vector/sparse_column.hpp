@@ -2,12 +2,13 @@
 #define TATAMI_MULT_SPARSE_COLUMN_HPP
 
 #include <vector>
-#include <optional>
+#include <algorithm>
 
 #include "tatami/tatami.hpp"
 #include "sanisizer/sanisizer.hpp"
 
 #include "../utils.hpp"
+#include "workspace.hpp"
 
 /**
  * @file sparse_column.hpp
@@ -29,6 +30,14 @@ struct MultiplySparseColumnWithSingleVectorOptions {
      * Different numbers of threads may slightly change the results due to differences in floating-point round-off error.
      */
     int num_threads = 1;
+
+    /**
+     * Whether `left` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values are not extracted and the multiplication only uses the indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `left` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -44,59 +53,89 @@ struct MultiplySparseColumnWithSingleVectorOptions {
  * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
  * On output, this stores the product `left * right`.
  * @param options Further options.
+ * @param workspace Workspace whose buffers are reused across calls.
  */
 template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
 void multiply_sparse_column_with_single_vector(
     const tatami::Matrix<LeftValue_, LeftIndex_>& left,
     const RightValue_* const right,
     Output_* const output,
-    const MultiplySparseColumnWithSingleVectorOptions& options
+    const MultiplySparseColumnWithSingleVectorOptions& options,
+    SingleVectorWorkspace<LeftValue_, LeftIndex_, Output_>& workspace
 ) {
     const auto NR = left.nrow();
     const auto NC = left.ncol();
-
-    const bool do_parallel = options.num_threads > 1; 
-    std::optional<std::vector<std::optional<std::vector<Output_> > > > tmp_results;
-    if (do_parallel) {
-        tmp_results.emplace(sanisizer::cast<I<decltype(tmp_results->size())> >(options.num_threads - 1));
-    }
+    workspace.prepare(std::max(options.num_threads, 1));
     std::fill_n(output, NR, 0);
 
     const auto num_used = tatami::parallelize([&](int t, LeftIndex_ start, LeftIndex_ length) -> void {
-        auto ext = tatami::consecutive_extractor<true>(left, false, start, length);
-        auto vbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(NR);
-        auto ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(NR);
-
-        Output_* optr;
-        std::optional<std::vector<Output_> > cur_output;
-        if (!do_parallel || t == 0) {
-            optr = output;
-        } else {
-            cur_output.emplace(tatami::cast_Index_to_container_size<I<decltype(*cur_output)> >(NR));
-            optr = cur_output->data();
+        tatami::Options opt;
+        opt.sparse_extract_value = !options.pattern;
+        auto ext = tatami::consecutive_extractor<true>(left, false, start, length, opt);
+        const auto vbuffer = (options.pattern ? NULL : workspace.value_buffer(t, NR));
+        const auto ibuffer = workspace.index_buffer(t, NR);
+
+        // The first thread writes directly to the output, while all other threads accumulate into their own buffers.
+        Output_* optr = output;
+        if (t > 0) {
+            optr = workspace.output_buffer(t, NR);
+            std::fill_n(optr, NR, 0);
         }
 
         for (LeftIndex_ c = 0; c < length; ++c) {
-            auto range = ext->fetch(vbuffer.data(), ibuffer.data());
+            auto range = ext->fetch(vbuffer, ibuffer);
             const Output_ mult = right[start + c];
-            for (LeftIndex_ r = 0; r < range.number; ++r) {
-                optr[range.index[r]] += mult * range.value[r];
+            if (options.pattern) {
+                for (LeftIndex_ r = 0; r < range.number; ++r) {
+                    optr[range.index[r]] += mult;
+                }
+            } else {
+                for (LeftIndex_ r = 0; r < range.number; ++r) {
+                    optr[range.index[r]] += mult * range.value[r];
+                }
             }
         }
-
-        if (do_parallel && t > 0) {
-            (*tmp_results)[t - 1] = std::move(cur_output);            
-        }
     }, NC, options.num_threads);
 
-    if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            for (LeftIndex_ r = 0; r < NR; ++r) {
-                output[r] += tmp[r];
-            }
-        }
-    }
+    const auto partials = workspace.partial_outputs(num_used, NR);
+    reduce_partial_output_vectors(
+        1,
+        [&](int) -> Output_* {
+            return output;
+        },
+        NR,
+        [&](const int u) -> const Output_* {
+            return partials[u];
+        },
+        num_used,
+        options.num_threads
+    );
+}
+
+/**
+ * Overload that allocates a new `SingleVectorWorkspace` for each call.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vector. 
+ * @tparam Output_ Numeric type of the output array.
+ * 
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On output, this stores the product `left * right`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void multiply_sparse_column_with_single_vector(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightValue_* const right,
+    Output_* const output,
+    const MultiplySparseColumnWithSingleVectorOptions& options
+) {
+    SingleVectorWorkspace<LeftValue_, LeftIndex_, Output_> workspace;
+    multiply_sparse_column_with_single_vector(left, right, output, options, workspace);
 }
 
 }
@@ -0,0 +1,97 @@
+#ifndef TATAMI_MULT_SINGLE_VECTOR_WORKSPACE_HPP
+#define TATAMI_MULT_SINGLE_VECTOR_WORKSPACE_HPP
+
+#include <vector>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+/**
+ * @file workspace.hpp
+ * @brief Reusable workspace for products with a single vector RHS.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Reusable workspace for products with a single vector RHS.
+ *
+ * Each multiplication function involving a single vector RHS allocates its own per-thread buffers for extraction and partial results.
+ * This is negligible for a single call but becomes noticeable when many products are computed in a loop, e.g., in iterative methods.
+ * Users can instead pass a `SingleVectorWorkspace` to the overloads of these functions, which will then reuse the workspace's buffers across calls.
+ * The buffers only grow so repeated calls with the same (or smaller) LHS matrix dimensions and number of threads do not perform any further allocations.
+ *
+ * The workspace does not cache the extractors for the LHS matrix, which are still constructed in each call.
+ * Each extractor is created with an oracle for the rows/columns to be processed by its thread, and an oracle can only be traversed once;
+ * reusing an extractor across calls would require discarding the oracle, which would lose the prefetching of file-backed matrices.
+ * Extractors are also specific to a particular matrix, and the workspace cannot reliably determine whether the same matrix is being used in subsequent calls.
+ * For in-memory matrices, the cost of constructing an extractor is usually negligible compared to that of the buffer allocations.
+ *
+ * The same workspace can be used for any of the single vector functions with the same template parameters.
+ * However, a workspace should not be used in multiple concurrent calls.
+ *
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ */
+template<typename Value_, typename Index_, typename Output_>
+class SingleVectorWorkspace {
+private:
+    struct Thread {
+        std::vector<Value_> value;
+        std::vector<Index_> index;
+        std::vector<Output_> output;
+    };
+
+    std::vector<Thread> my_threads;
+    std::vector<const Output_*> my_partials;
+
+    template<class Container_>
+    static auto* grow(Container_& container, const Index_ length) {
+        if (sanisizer::is_less_than(container.size(), length)) {
+            tatami::resize_container_to_Index_size(container, length);
+        }
+        return container.data();
+    }
+
+public:
+    /**
+     * @cond
+     */
+    void prepare(const int num_threads) {
+        if (sanisizer::is_less_than(my_threads.size(), num_threads)) {
+            sanisizer::resize(my_threads, num_threads);
+        }
+    }
+
+    Value_* value_buffer(const int thread, const Index_ length) {
+        return grow(my_threads[thread].value, length);
+    }
+
+    Index_* index_buffer(const int thread, const Index_ length) {
+        return grow(my_threads[thread].index, length);
+    }
+
+    Output_* output_buffer(const int thread, const Index_ length) {
+        return grow(my_threads[thread].output, length);
+    }
+
+    // Collecting the output buffers of threads [1, num_used) for reduce_partial_output_vectors(), where the 'u'-th entry of the array is the buffer for thread 'u'.
+    // This should be called on the calling thread after the parallel section, as the workspace should not be modified concurrently.
+    const Output_* const* partial_outputs(const int num_used, const Index_ length) {
+        if (sanisizer::is_less_than(my_partials.size(), num_used)) {
+            sanisizer::resize(my_partials, num_used);
+        }
+        for (int u = 1; u < num_used; ++u) {
+            my_partials[u] = grow(my_threads[u].output, length);
+        }
+        return my_partials.data();
+    }
+    /**
+     * @endcond
+     */
+};
+
+}
+
+#endif
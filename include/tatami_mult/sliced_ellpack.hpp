@@ -0,0 +1,314 @@
+#ifndef TATAMI_MULT_SLICED_ELLPACK_HPP
+#define TATAMI_MULT_SLICED_ELLPACK_HPP
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+
+/**
+ * @file sliced_ellpack.hpp
+ * @brief Sliced ELLPACK (SELL-C-sigma) LHS for repeated products.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for the `SlicedEllpackMatrix` constructor.
+ */
+struct SlicedEllpackOptions {
+    /**
+     * Number of consecutive rows that are sorted by their number of non-zero elements before being assigned to chunks, i.e., the \f$\sigma\f$ parameter.
+     * Larger values reduce the padding within each chunk but worsen the locality of writes to the output vector.
+     * Values less than or equal to 1 disable sorting.
+     */
+    int sort_window = 256;
+
+    /**
+     * Number of threads to use for the conversion.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @brief Sparse matrix in the sliced ELLPACK (SELL-C-sigma) format.
+ *
+ * Rows are sorted by decreasing number of non-zero elements within each window of `SlicedEllpackOptions::sort_window` rows,
+ * and then grouped into chunks of `chunk_size_` consecutive rows.
+ * Within each chunk, rows are padded to the same number of non-zero elements and stored in an interleaved layout,
+ * i.e., the `j`-th non-zero element of all rows in the chunk are stored contiguously.
+ * This allows the multiplication to process all rows of a chunk with fixed-width inner loops that are easily vectorized by the compiler,
+ * rather than computing one gather-heavy dot product per row as in `multiply_sparse_row_with_single_vector()`.
+ *
+ * Conversion requires a full pass through the matrix so this is only worthwhile when the same matrix is used in many products,
+ * e.g., via `multiply_sliced_ellpack_with_single_vector()` or `multiply_sliced_ellpack_with_multiple_vectors()` in an iterative solver.
+ *
+ * @tparam Value_ Numeric type of the matrix value.
+ * @tparam Index_ Integer type of the matrix index.
+ * @tparam chunk_size_ Number of rows in each chunk, i.e., the \f$C\f$ parameter.
+ * This should be a multiple of the SIMD width for `Value_`.
+ */
+template<typename Value_, typename Index_, std::size_t chunk_size_ = 8>
+class SlicedEllpackMatrix {
+public:
+    /**
+     * @param matrix Matrix to be converted.
+     * This is typically sparse, though any matrix can be used.
+     * It does not need to outlive the `SlicedEllpackMatrix`.
+     * @param options Further options.
+     */
+    SlicedEllpackMatrix(const tatami::Matrix<Value_, Index_>& matrix, const SlicedEllpackOptions& options) : my_nrow(matrix.nrow()), my_ncol(matrix.ncol()) {
+        // First pass to count the number of non-zero elements in each row.
+        auto counts = tatami::create_container_of_Index_size<std::vector<Index_> >(my_nrow);
+        tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+            tatami::Options opt;
+            opt.sparse_extract_value = false;
+            opt.sparse_extract_index = false;
+            auto ext = tatami::consecutive_extractor<true>(matrix, true, start, length, opt);
+            for (Index_ r = start, end = start + length; r < end; ++r) {
+                counts[r] = ext->fetch(NULL, NULL).number;
+            }
+        }, my_nrow, options.num_threads);
+
+        // Sorting rows by decreasing number of non-zeros within each window.
+        const Index_ num_chunks = my_nrow / chunk_size_ + (my_nrow % chunk_size_ > 0);
+        my_permutation.resize(sanisizer::product<I<decltype(my_permutation.size())> >(num_chunks, chunk_size_), my_nrow);
+        std::iota(my_permutation.begin(), my_permutation.begin() + my_nrow, static_cast<Index_>(0));
+        if (options.sort_window > 1) {
+            for (Index_ start = 0; start < my_nrow; ) {
+                const Index_ length = sanisizer::min(my_nrow - start, options.sort_window);
+                auto pstart = my_permutation.begin() + start;
+                std::stable_sort(pstart, pstart + length, [&](Index_ l, Index_ r) -> bool { return counts[l] > counts[r]; });
+                start += length;
+            }
+        }
+
+        // Each chunk is padded to the maximum number of non-zeros of its rows.
+        sanisizer::resize(my_offsets, sanisizer::sum<std::size_t>(num_chunks, 1));
+        for (Index_ k = 0; k < num_chunks; ++k) {
+            Index_ width = 0;
+            for (std::size_t lane = 0; lane < chunk_size_; ++lane) {
+                const auto row = my_permutation[sanisizer::nd_offset<std::size_t>(lane, chunk_size_, k)];
+                if (row < my_nrow) {
+                    width = std::max(width, counts[row]);
+                }
+            }
+            my_offsets[k + 1] = sanisizer::sum<std::size_t>(my_offsets[k], sanisizer::product<std::size_t>(width, chunk_size_));
+        }
+        my_values.resize(my_offsets.back());
+        my_indices.resize(my_offsets.back());
+
+        // Storing the number of non-zeros for each lane, so that the padding can be masked out during multiplication.
+        sanisizer::resize(my_lengths, my_permutation.size());
+        for (I<decltype(my_permutation.size())> p = 0, end = my_nrow; p < end; ++p) {
+            my_lengths[p] = counts[my_permutation[p]];
+        }
+
+        // Second pass to fill each row's lane of its chunk. Padding is left as zero values at index zero.
+        auto positions = tatami::create_container_of_Index_size<std::vector<Index_> >(my_nrow);
+        for (I<decltype(my_permutation.size())> p = 0, end = my_nrow; p < end; ++p) {
+            positions[my_permutation[p]] = p;
+        }
+
+        tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+            auto ext = tatami::consecutive_extractor<true>(matrix, true, start, length);
+            auto vbuffer = tatami::create_container_of_Index_size<std::vector<Value_> >(my_ncol);
+            auto ibuffer = tatami::create_container_of_Index_size<std::vector<Index_> >(my_ncol);
+            for (Index_ r = start, end = start + length; r < end; ++r) {
+                auto range = ext->fetch(vbuffer.data(), ibuffer.data());
+                const auto pos = positions[r];
+                const std::size_t base = my_offsets[pos / chunk_size_] + pos % chunk_size_;
+                for (Index_ j = 0; j < range.number; ++j) {
+                    const std::size_t target = base + sanisizer::product_unsafe<std::size_t>(j, chunk_size_);
+                    my_values[target] = range.value[j];
+                    my_indices[target] = range.index[j];
+                }
+            }
+        }, my_nrow, options.num_threads);
+    }
+
+private:
+    Index_ my_nrow, my_ncol;
+    std::vector<Index_> my_permutation, my_lengths;
+    std::vector<std::size_t> my_offsets;
+    std::vector<Value_> my_values;
+    std::vector<Index_> my_indices;
+
+public:
+    /**
+     * @return Number of rows.
+     */
+    Index_ nrow() const {
+        return my_nrow;
+    }
+
+    /**
+     * @return Number of columns.
+     */
+    Index_ ncol() const {
+        return my_ncol;
+    }
+
+    /**
+     * @return Number of chunks.
+     */
+    Index_ num_chunks() const {
+        return my_offsets.size() - 1;
+    }
+
+    /**
+     * @return Number of stored elements, including padding.
+     * Comparing this to the number of non-zero elements indicates the overhead of the padding.
+     */
+    std::size_t num_stored() const {
+        return my_offsets.back();
+    }
+
+    /**
+     * @cond
+     */
+    // Computing the products of all rows in chunk 'k' with each of the 'num_vectors' RHS vectors in 'right', and storing them in the corresponding 'output'.
+    // All vectors are processed in a single sweep through the chunk, so each value and index is only loaded once.
+    // 'sums' should point to an array of length 'num_vectors', to be used as a workspace.
+    template<typename Right_, typename Output_>
+    void multiply_chunk(
+        const Index_ k,
+        const std::size_t num_vectors,
+        Right_* const* const right,
+        Output_* const* const output,
+        std::array<Output_, chunk_size_>* const sums
+    ) const {
+        std::fill_n(sums, num_vectors, std::array<Output_, chunk_size_>{});
+        const auto start = my_offsets[k], end = my_offsets[k + 1];
+        const auto vptr = my_values.data(), iptr = my_indices.data();
+        const auto lengths = my_lengths.data() + sanisizer::product_unsafe<std::size_t>(k, chunk_size_);
+
+        Index_ step = 0;
+        for (auto j = start; j < end; j += chunk_size_, ++step) {
+            // Padded lanes are masked out rather than relying on a zero value, as '0 * right[0]' would be NaN if 'right[0]' is not finite.
+            // Masking with a conditional select is still amenable to vectorization.
+            std::array<bool, chunk_size_> valid;
+            for (std::size_t lane = 0; lane < chunk_size_; ++lane) {
+                valid[lane] = step < lengths[lane];
+            }
+
+            for (std::size_t v = 0; v < num_vectors; ++v) {
+                const auto curright = right[v];
+                auto& cursums = sums[v];
+                for (std::size_t lane = 0; lane < chunk_size_; ++lane) {
+                    const Output_ prod = static_cast<Output_>(vptr[j + lane]) * static_cast<Output_>(curright[iptr[j + lane]]);
+                    cursums[lane] += (valid[lane] ? prod : static_cast<Output_>(0));
+                }
+            }
+        }
+
+        const auto perm = my_permutation.data() + sanisizer::product_unsafe<std::size_t>(k, chunk_size_);
+        for (std::size_t v = 0; v < num_vectors; ++v) {
+            const auto curout = output[v];
+            const auto& cursums = sums[v];
+            for (std::size_t lane = 0; lane < chunk_size_; ++lane) {
+                const auto row = perm[lane];
+                if (row < my_nrow) {
+                    curout[row] = cursums[lane];
+                }
+            }
+        }
+    }
+    /**
+     * @endcond
+     */
+};
+
+/**
+ * @brief Options for `multiply_sliced_ellpack_with_single_vector()`.
+ */
+struct MultiplySlicedEllpackWithSingleVectorOptions {
+    /**
+     * Number of threads to use.
+     * Different numbers of threads will not change the results.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam chunk_size_ Number of rows in each chunk of the LHS matrix.
+ * @tparam RightValue_ Numeric type of the RHS vector.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On output, this stores the product `left * right`.
+ * @param options Further options.
+ */
+template<typename Value_, typename Index_, std::size_t chunk_size_, typename RightValue_, typename Output_>
+void multiply_sliced_ellpack_with_single_vector(
+    const SlicedEllpackMatrix<Value_, Index_, chunk_size_>& left,
+    const RightValue_* const right,
+    Output_* const output,
+    const MultiplySlicedEllpackWithSingleVectorOptions& options
+) {
+    tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+        std::array<Output_, chunk_size_> sums;
+        for (Index_ k = start, end = start + length; k < end; ++k) {
+            left.multiply_chunk(k, 1, &right, &output, &sums);
+        }
+    }, left.num_chunks(), options.num_threads);
+}
+
+/**
+ * @brief Options for `multiply_sliced_ellpack_with_multiple_vectors()`.
+ */
+struct MultiplySlicedEllpackWithMultipleVectorsOptions {
+    /**
+     * Number of threads to use.
+     * Different numbers of threads will not change the results.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * Each chunk of `left` is multiplied with all RHS vectors in a single sweep before proceeding to the next chunk,
+ * so that each stored value and index is only loaded once for all vectors.
+ *
+ * @tparam Value_ Numeric type of the LHS matrix value.
+ * @tparam Index_ Integer type of the LHS matrix index.
+ * @tparam chunk_size_ Number of rows in each chunk of the LHS matrix.
+ * @tparam Right_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param[in] right Vector of pointers, each of which points to an array of length `left.ncol()`.
+ * Each entry contains a RHS vector with which to multiply `left`.
+ * @param[out] output Vector of pointers, each of which points to an array of length `left.nrow()`.
+ * On output, the `i`-th entry stores the product `left * right[i]`.
+ * @param options Further options.
+ */
+template<typename Value_, typename Index_, std::size_t chunk_size_, typename Right_, typename Output_>
+void multiply_sliced_ellpack_with_multiple_vectors(
+    const SlicedEllpackMatrix<Value_, Index_, chunk_size_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplySlicedEllpackWithMultipleVectorsOptions& options
+) {
+    const auto num_vectors = right.size();
+    tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+        std::vector<std::array<Output_, chunk_size_> > sums(num_vectors);
+        for (Index_ k = start, end = start + length; k < end; ++k) {
+            left.multiply_chunk(k, num_vectors, right.data(), output.data(), sums.data());
+        }
+    }, left.num_chunks(), options.num_threads);
+}
+
+}
+
+#endif
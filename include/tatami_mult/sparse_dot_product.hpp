@@ -2,6 +2,7 @@
 #define TATAMI_MULT_SPARSE_DOT_PRODUCT_H
 
 #include <cstddef>
+#include <cstdint>
 #include <array>
 #include <numeric>
 
@@ -13,7 +14,14 @@ namespace tatami_mult {
 
 template<std::size_t accumulators_, class ValueIterator_, class IndexIterator_, typename Dense_, typename Output_>
 Output_ sparse_dot_product(const std::size_t num_non_zeros, ValueIterator_ vptr, IndexIterator_ iptr, Dense_ dense, Output_ initial) {
-    if constexpr(accumulators_ == 1) {
+    if constexpr(is_small_integer<I<decltype(*vptr)> > && is_small_integer<I<decltype(dense[0])> >) {
+        std::int64_t dot = 0;
+        for (std::size_t i = 0; i < num_non_zeros; ++i) {
+            dot += static_cast<std::int64_t>(dense[*(iptr + i)]) * static_cast<std::int64_t>(*(vptr + i));
+        }
+        return initial + static_cast<Output_>(dot);
+
+    } else if constexpr(accumulators_ == 1) {
         Output_ dot = initial;
         for (std::size_t i = 0; i < num_non_zeros; ++i) {
             dot += static_cast<Output_>(dense[*(iptr + i)]) * static_cast<Output_>(*(vptr + i));
@@ -41,6 +49,35 @@ Output_ sparse_dot_product(const std::size_t num_non_zeros, ValueIterator_ vptr,
     }
 }
 
+// Dot product for a pattern-only sparse vector where all non-zero values are equal to 1, i.e., a gather-sum of 'dense'.
+template<std::size_t accumulators_, class IndexIterator_, typename Dense_, typename Output_>
+Output_ sparse_pattern_dot_product(const std::size_t num_non_zeros, IndexIterator_ iptr, Dense_ dense, Output_ initial) {
+    if constexpr(accumulators_ == 1) {
+        Output_ dot = initial;
+        for (std::size_t i = 0; i < num_non_zeros; ++i) {
+            dot += static_cast<Output_>(dense[*(iptr + i)]);
+        }
+        return dot;
+
+    } else {
+        std::array<Output_, accumulators_> dots{};
+        const std::size_t cycles = num_non_zeros / accumulators_;
+        const std::size_t remainder = num_non_zeros % accumulators_;
+
+        for (std::size_t c = 0; c < cycles; ++c) {
+            for (std::size_t a = 0; a < accumulators_; ++a) {
+                dots[a] += static_cast<Output_>(dense[*(iptr + c * accumulators_ + a)]);
+            }
+        }
+
+        for (std::size_t i = 0; i < remainder; ++i) {
+            initial += dense[*(iptr + cycles * accumulators_ + i)];
+        }
+
+        return initial + recursive_sum(dots);
+    }
+}
+
 }
 
 #endif
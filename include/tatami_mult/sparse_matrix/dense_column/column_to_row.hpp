@@ -37,6 +37,15 @@ struct MultiplyDenseColumnWithSparseColumnMatrixToRowOutputOptions {
      * See the \f$B\f$ parameter in the @ref sparse-blocking "Blocking for sparse matrices" section for more details.
      */
     int block_size = 16;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not used in the multiplication.
+     * Note that the values are still realized by `tatami::retrieve_fragmented_sparse_contents()`,
+     * so this only avoids loading them in the inner loops.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -112,8 +121,20 @@ void multiply_dense_column_with_sparse_column_matrix_to_row_output(
                     const RightIndex_ right_nnz = right_values.size();
                     for (LeftIndex_ lr = 0; lr < left_NR; ++lr) {
                         const Output_ mult = lptr[lr];
-                        for (RightIndex_ x = 0; x < right_nnz; ++x) {
-                            outptr[sanisizer::nd_offset<std::size_t>(right_indices[x], right_NC, lr)] += mult * static_cast<Output_>(right_values[x]);
+                        if (options.pattern) {
+                            for (RightIndex_ x = 0; x < right_nnz; ++x) {
+                                outptr[sanisizer::nd_offset<std::size_t>(right_indices[x], right_NC, lr)] += mult;
+                            }
+                        } else {
+                            if (options.pattern) {
+                                for (RightIndex_ x = 0; x < right_nnz; ++x) {
+                                    outptr[sanisizer::nd_offset<std::size_t>(right_indices[x], right_NC, lr)] += mult;
+                                }
+                            } else {
+                                for (RightIndex_ x = 0; x < right_nnz; ++x) {
+                                    outptr[sanisizer::nd_offset<std::size_t>(right_indices[x], right_NC, lr)] += mult * static_cast<Output_>(right_values[x]);
+                                }
+                            }
                         }
                     }
                 }
@@ -144,8 +165,14 @@ void multiply_dense_column_with_sparse_column_matrix_to_row_output(
                             const auto& right_values = rhs_data.value[actual_cd];
                             const auto& right_indices = rhs_data.index[actual_cd];
                             const RightIndex_ right_nnz = right_values.size();
-                            for (RightIndex_ x = 0; x < right_nnz; ++x) {
-                                outptr[sanisizer::nd_offset<std::size_t>(right_indices[x], right_NC, lr)] += mult * static_cast<Output_>(right_values[x]);
+                            if (options.pattern) {
+                                for (RightIndex_ x = 0; x < right_nnz; ++x) {
+                                    outptr[sanisizer::nd_offset<std::size_t>(right_indices[x], right_NC, lr)] += mult;
+                                }
+                            } else {
+                                for (RightIndex_ x = 0; x < right_nnz; ++x) {
+                                    outptr[sanisizer::nd_offset<std::size_t>(right_indices[x], right_NC, lr)] += mult * static_cast<Output_>(right_values[x]);
+                                }
                             }
                         }
                     }
@@ -179,13 +206,7 @@ void multiply_dense_column_with_sparse_column_matrix_to_row_output(
     }, cd_total, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <vector>
 #include <optional>
+#include <memory>
 
 #include "tatami/tatami.hpp"
 #include "sanisizer/sanisizer.hpp"
@@ -37,6 +38,23 @@ struct MultiplyDenseColumnWithSparseRowMatrixToRowOutputOptions {
      * See the \f$B\f$ parameter in the @ref sparse-blocking "Blocking for sparse matrices" section for more details.
      */
     int block_size = 16;
+
+    /**
+     * Whether to perform a structure-only pass over `right` to identify its non-empty rows before the multiplication.
+     * If true, only the non-empty RHS rows and the corresponding LHS columns are extracted, by supplying an oracle for only those indices to both extractors.
+     * This avoids extracting LHS columns that would be discarded, which is useful for file-backed matrices with expensive extraction.
+     * The pre-pass reads the structure of `right` twice, so it is only worthwhile if `right` is cheap to re-read and the extraction of `left` is expensive.
+     * If unset, the pre-pass is only performed if `right.uses_oracle(true)` is false (e.g., `right` is in memory) and `left.uses_oracle(false)` is true (e.g., `left` is file-backed).
+     */
+    std::optional<bool> prepass_non_empty;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not extracted and the multiplication only uses its indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -76,9 +94,25 @@ void multiply_dense_column_with_sparse_row_matrix_to_row_output(
 
     std::fill_n(output, sanisizer::product_unsafe<std::size_t>(left_NR, right_NC), 0);
 
+    const bool prepass = options.prepass_non_empty.value_or(!right.uses_oracle(true) && left.uses_oracle(false));
     const int num_used = tatami::parallelize([&](int t, LeftIndex_ start, LeftIndex_ length) -> void {
-        auto left_ext = tatami::consecutive_extractor<false>(left, false, start, length);
-        auto right_ext = tatami::consecutive_extractor<true>(right, true, start, length);
+        // Both extractors must be in sync along the common dimension, so if we skip the empty RHS rows, we must also skip the corresponding LHS columns.
+        LeftIndex_ num_fetch = length;
+        std::shared_ptr<const tatami::Oracle<LeftIndex_> > left_oracle;
+        std::shared_ptr<const tatami::Oracle<RightIndex_> > right_oracle;
+        if (prepass) {
+            auto non_empty = find_non_empty_sparse_vectors(right, true, static_cast<RightIndex_>(start), static_cast<RightIndex_>(length));
+            num_fetch = non_empty.size();
+            left_oracle.reset(new tatami::FixedVectorOracle<LeftIndex_>(std::vector<LeftIndex_>(non_empty.begin(), non_empty.end())));
+            right_oracle.reset(new tatami::FixedVectorOracle<RightIndex_>(std::move(non_empty)));
+        } else {
+            left_oracle.reset(new tatami::ConsecutiveOracle<LeftIndex_>(start, length));
+            right_oracle.reset(new tatami::ConsecutiveOracle<RightIndex_>(start, length));
+        }
+        auto left_ext = tatami::new_extractor<false, true>(left, false, std::move(left_oracle));
+        tatami::Options right_opt;
+        right_opt.sparse_extract_value = !options.pattern;
+        auto right_ext = tatami::new_extractor<true, true>(right, true, std::move(right_oracle), right_opt);
 
         std::optional<std::vector<Output_> > tmp_output;
         Output_* outptr; 
@@ -94,7 +128,7 @@ void multiply_dense_column_with_sparse_row_matrix_to_row_output(
             auto vbuffer = tatami::create_container_of_Index_size<std::vector<RightValue_> >(right_NC);
             auto ibuffer = tatami::create_container_of_Index_size<std::vector<RightIndex_> >(right_NC);
 
-            for (LeftIndex_ cd = 0; cd < length; ++cd) {
+            for (LeftIndex_ cd = 0; cd < num_fetch; ++cd) {
                 const auto lptr = left_ext->fetch(dbuffer.data());
                 const auto rrange = right_ext->fetch(vbuffer.data(), ibuffer.data());
 
@@ -105,8 +139,14 @@ void multiply_dense_column_with_sparse_row_matrix_to_row_output(
 
                 for (LeftIndex_ lr = 0; lr < left_NR; ++lr) {
                     const Output_ mult = lptr[lr];
-                    for (RightIndex_ x = 0; x < rrange.number; ++x) {
-                        outptr[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_NC, lr)] += mult * static_cast<Output_>(rrange.value[x]);
+                    if (options.pattern) {
+                        for (RightIndex_ x = 0; x < rrange.number; ++x) {
+                            outptr[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_NC, lr)] += mult;
+                        }
+                    } else {
+                        for (RightIndex_ x = 0; x < rrange.number; ++x) {
+                            outptr[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_NC, lr)] += mult * static_cast<Output_>(rrange.value[x]);
+                        }
                     }
                 }
             }
@@ -118,7 +158,7 @@ void multiply_dense_column_with_sparse_row_matrix_to_row_output(
             std::vector<std::vector<RightIndex_> > right_ibuffers;
             std::vector<tatami::SparseRange<RightValue_, RightIndex_> > right_ranges;
             {
-                const LeftIndex_ max_block_cols = sanisizer::min(length, options.block_size);
+                const LeftIndex_ max_block_cols = sanisizer::min(num_fetch, options.block_size);
                 left_dbuffers.reserve(max_block_cols);
                 right_vbuffers.reserve(max_block_cols);
                 right_ibuffers.reserve(max_block_cols);
@@ -132,7 +172,7 @@ void multiply_dense_column_with_sparse_row_matrix_to_row_output(
             }
 
             LeftIndex_ cd = 0;
-            while (cd < length) {
+            while (cd < num_fetch) {
                 // Only processing LHS columns if the corresponding RHS row has some structural non-zeros.
                 // If not, we just skip it altogether; no need to zero or do anything else, as we're skipping the corresponding RHS row too.
                 LeftIndex_ cd_num = 0;
@@ -154,14 +194,20 @@ void multiply_dense_column_with_sparse_row_matrix_to_row_output(
                     if (sanisizer::is_equal(cd_num, options.block_size)) {
                         break;
                     }
-                } while (cd < length);
+                } while (cd < num_fetch);
 
                 for (LeftIndex_ lr = 0; lr < left_NR; ++lr) {
                     for (LeftIndex_ cd_counter = 0; cd_counter < cd_num; ++cd_counter) {
                         const auto mult = left_ptrs[cd_counter][lr];
                         const auto rrange = right_ranges[cd_counter];
-                        for (RightIndex_ x = 0; x < rrange.number; ++x) {
-                            outptr[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_NC, lr)] += mult * static_cast<Output_>(rrange.value[x]);
+                        if (options.pattern) {
+                            for (RightIndex_ x = 0; x < rrange.number; ++x) {
+                                outptr[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_NC, lr)] += mult;
+                            }
+                        } else {
+                            for (RightIndex_ x = 0; x < rrange.number; ++x) {
+                                outptr[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_NC, lr)] += mult * static_cast<Output_>(rrange.value[x]);
+                            }
                         }
                     }
                 }
@@ -174,13 +220,7 @@ void multiply_dense_column_with_sparse_row_matrix_to_row_output(
     }, common_dim, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
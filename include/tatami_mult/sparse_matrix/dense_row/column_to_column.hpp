@@ -10,6 +10,7 @@
 #include "../utils.hpp"
 #include "../../utils.hpp"
 #include "../../sparse_dot_product.hpp"
+#include "../../dense_dot_product.hpp"
 
 /**
  * @file column_to_column.hpp
@@ -37,6 +38,24 @@ struct MultiplyDenseRowWithSparseColumnMatrixToColumnOutputOptions {
      * See the \f$C\f$ parameter in the @ref sparse-blocking "Blocking for sparse matrices" section for more details.
      */
     int block_size = 1;
+
+    /**
+     * Minimum proportion of non-zero elements in a RHS column for it to be stored densely after realization.
+     * Dense-enough columns are then multiplied with `dense_dot_product()`, avoiding the indirect look-ups of the sparse representation.
+     * The default of 1 only stores columns without any structural zeros densely, so the results are the same as if the dense storage was not used.
+     * Smaller values may be faster, e.g., at 0.5, a dense column uses no more memory than its sparse counterpart with similarly-sized values and indices.
+     * However, the structural zeros of each dense column will then be multiplied explicitly, so any non-finite values in `left` may propagate to more entries of the output.
+     * Values greater than 1 disable the dense storage altogether.
+     */
+    double dense_threshold = 1;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not extracted and the multiplication only uses its indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -74,7 +93,8 @@ void multiply_dense_row_with_sparse_column_matrix_to_column_output(
     auto right_vbuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(right_NC);
     auto right_ibuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightIndex_> > >(right_NC);
     auto right_ranges = tatami::create_container_of_Index_size<std::vector<tatami::SparseRange<RightValue_, RightIndex_> > >(right_NC);
-    populate_sparse_buffers(false, right_NC, common_dim, right, right_vbuffers, right_ibuffers, right_ranges, options.num_threads);
+    populate_sparse_buffers(false, right_NC, common_dim, right, right_vbuffers, right_ibuffers, right_ranges, options.pattern, options.num_threads);
+    const auto right_dense = densify_sparse_buffers(right_NC, common_dim, right_vbuffers, right_ibuffers, right_ranges, options.dense_threshold, options.num_threads);
 
     // If there are any empty RHS columns, we only iterate over the non-empty ones in the loop for each LHS row.
     auto right_non_empty = filter_non_empty_sparse(
@@ -84,6 +104,30 @@ void multiply_dense_row_with_sparse_column_matrix_to_column_output(
         }
     );
 
+    // Dense RHS columns use a dense dot product, otherwise we use a sparse dot product against the dense LHS row.
+    auto compute_dot = [&](const RightIndex_ rc, const LeftValue_* const lptr) -> Output_ {
+        const auto& rdense = right_dense[rc];
+        if (!rdense.empty()) {
+            return dense_dot_product<accumulators_>(common_dim, rdense.data(), lptr, static_cast<Output_>(0));
+        }
+        const auto& rrange = right_ranges[rc];
+        if (options.pattern) {
+            return sparse_pattern_dot_product<accumulators_>(
+                rrange.number, // Implicit cast to size_t is safe, as per the tatami contract.
+                rrange.index,
+                lptr,
+                static_cast<Output_>(0)
+            );
+        }
+        return sparse_dot_product<accumulators_>(
+            rrange.number, // Implicit cast to size_t is safe, as per the tatami contract.
+            rrange.value,
+            rrange.index,
+            lptr,
+            static_cast<Output_>(0)
+        );
+    };
+
     if (options.block_size == 1) {
         tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
             auto ext = tatami::consecutive_extractor<false>(left, true, start, length);
@@ -93,14 +137,7 @@ void multiply_dense_row_with_sparse_column_matrix_to_column_output(
                 const auto lptr = ext->fetch(dbuffer.data());
 
                 auto loop_body = [&](RightIndex_ rc) -> void {
-                    const auto rrange = right_ranges[rc];
-                    output[sanisizer::nd_offset<std::size_t>(start + lr, left_NR, rc)] = sparse_dot_product<accumulators_>(
-                        rrange.number, // Implicit cast to size_t is safe, as per the tatami contract.
-                        rrange.value,
-                        rrange.index,
-                        lptr,
-                        static_cast<Output_>(0)
-                    );
+                    output[sanisizer::nd_offset<std::size_t>(start + lr, left_NR, rc)] = compute_dot(rc, lptr);
                 };
 
                 if (right_non_empty.has_value()) {
@@ -139,15 +176,8 @@ void multiply_dense_row_with_sparse_column_matrix_to_column_output(
             // This aims to keep the entirety of the dense LHS block in cache across multiple RHS columns, provided common_dim is small.
             // If we did it the other way around, it would just be the same as the block_size == 1 case, but with more looping overhead. 
             auto loop_body = [&](RightIndex_ rc) -> void {
-                const auto rrange = right_ranges[rc];
                 for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-                    output[sanisizer::nd_offset<std::size_t>(start + lr + lr_counter, left_NR, rc)] = sparse_dot_product<accumulators_>(
-                        rrange.number, // Implicit cast of range.number to size_t is safe, as per the tatami contract.
-                        rrange.value,
-                        rrange.index,
-                        lptrs[lr_counter],
-                        static_cast<Output_>(0)
-                    );
+                    output[sanisizer::nd_offset<std::size_t>(start + lr + lr_counter, left_NR, rc)] = compute_dot(rc, lptrs[lr_counter]);
                 }
             };
 
@@ -10,6 +10,7 @@
 #include "../utils.hpp"
 #include "../../utils.hpp"
 #include "../../sparse_dot_product.hpp"
+#include "../../dense_dot_product.hpp"
 
 /**
  * @file column_to_row.hpp
@@ -37,6 +38,24 @@ struct MultiplyDenseRowWithSparseColumnMatrixToRowOutputOptions {
      * See the \f$C\f$ parameter in the @ref sparse-blocking "Blocking for sparse matrices" section for more details.
      */
     int block_size = 1;
+
+    /**
+     * Minimum proportion of non-zero elements in a RHS column for it to be stored densely after realization.
+     * Dense-enough columns are then multiplied with `dense_dot_product()`, avoiding the indirect look-ups of the sparse representation.
+     * The default of 1 only stores columns without any structural zeros densely, so the results are the same as if the dense storage was not used.
+     * Smaller values may be faster, e.g., at 0.5, a dense column uses no more memory than its sparse counterpart with similarly-sized values and indices.
+     * However, the structural zeros of each dense column will then be multiplied explicitly, so any non-finite values in `left` may propagate to more entries of the output.
+     * Values greater than 1 disable the dense storage altogether.
+     */
+    double dense_threshold = 1;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not extracted and the multiplication only uses its indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -74,7 +93,32 @@ void multiply_dense_row_with_sparse_column_matrix_to_row_output(
     auto right_vbuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(right_NC);
     auto right_ibuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightIndex_> > >(right_NC);
     auto right_ranges = tatami::create_container_of_Index_size<std::vector<tatami::SparseRange<RightValue_, RightIndex_> > >(right_NC);
-    populate_sparse_buffers(false, right_NC, common_dim, right, right_vbuffers, right_ibuffers, right_ranges, options.num_threads);
+    populate_sparse_buffers(false, right_NC, common_dim, right, right_vbuffers, right_ibuffers, right_ranges, options.pattern, options.num_threads);
+    const auto right_dense = densify_sparse_buffers(right_NC, common_dim, right_vbuffers, right_ibuffers, right_ranges, options.dense_threshold, options.num_threads);
+
+    // Dense RHS columns use a dense dot product, otherwise we use a sparse dot product against the dense LHS row.
+    auto compute_dot = [&](const RightIndex_ rc, const LeftValue_* const lptr) -> Output_ {
+        const auto& rdense = right_dense[rc];
+        if (!rdense.empty()) {
+            return dense_dot_product<accumulators_>(common_dim, rdense.data(), lptr, static_cast<Output_>(0));
+        }
+        const auto& rrange = right_ranges[rc];
+        if (options.pattern) {
+            return sparse_pattern_dot_product<accumulators_>(
+                rrange.number, // Implicit cast to size_t is safe, as per the tatami contract.
+                rrange.index,
+                lptr,
+                static_cast<Output_>(0)
+            );
+        }
+        return sparse_dot_product<accumulators_>(
+            rrange.number, // Implicit cast to size_t is safe, as per the tatami contract.
+            rrange.value,
+            rrange.index,
+            lptr,
+            static_cast<Output_>(0)
+        );
+    };
 
     if (options.block_size == 1) {
         tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
@@ -87,14 +131,7 @@ void multiply_dense_row_with_sparse_column_matrix_to_row_output(
                 // No point looping over the non-empty RHS columns, as we still need to zero the output columns corresponding to empty RHS columns.
                 // So, we might as well handle the zeroing in the same loop and save ourselves the trouble.
                 for (RightIndex_ rc = 0; rc < right_NC; ++rc) {
-                    const auto rrange = right_ranges[rc];
-                    output[sanisizer::nd_offset<std::size_t>(rc, right_NC, start + lr)] = sparse_dot_product<accumulators_>(
-                        rrange.number, // Implicit cast to size_t is safe, as per the tatami contract.
-                        rrange.value,
-                        rrange.index,
-                        lptr,
-                        static_cast<Output_>(0)
-                    );
+                    output[sanisizer::nd_offset<std::size_t>(rc, right_NC, start + lr)] = compute_dot(rc, lptr);
                 }
             }
         }, left_NR, options.num_threads);
@@ -131,13 +168,7 @@ void multiply_dense_row_with_sparse_column_matrix_to_row_output(
                     }
 
                     for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-                        output[sanisizer::nd_offset<std::size_t>(rc, right_NC, start + lr + lr_counter)] = sparse_dot_product<accumulators_>(
-                            rrange.number, // Implicit cast to size_t is safe, as per the tatami contract.
-                            rrange.value,
-                            rrange.index,
-                            lptrs[lr_counter],
-                            static_cast<Output_>(0)
-                        );
+                        output[sanisizer::nd_offset<std::size_t>(rc, right_NC, start + lr + lr_counter)] = compute_dot(rc, lptrs[lr_counter]);
                     }
                 }
 
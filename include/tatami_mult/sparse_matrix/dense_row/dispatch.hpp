@@ -73,6 +73,20 @@ inline void set_sparse_block_size(MultiplyDenseRowWithSparseMatrixOptions& optio
     options.row_to_row.block_size = block_size;
 }
 
+/**
+ * Specify whether the RHS matrix is a pattern matrix in all multiplication functions involving a dense row-major LHS and a sparse matrix RHS.
+ * See `MultiplyDenseRowWithSparseRowMatrixToRowOutputOptions::pattern` for details.
+ *
+ * @param options Options to be set.
+ * @param pattern Whether all non-zero values in the RHS matrix are equal to 1.
+ */
+inline void set_sparse_pattern(MultiplyDenseRowWithSparseMatrixOptions& options, bool pattern) {
+    options.column_to_column.pattern = pattern;
+    options.column_to_row.pattern = pattern;
+    options.row_to_column.pattern = pattern;
+    options.row_to_row.pattern = pattern;
+}
+
 /**
  * This function will iterate over `left`, realizing rows into memory as needed.
  * It will also realize all of `right` into memory for fast repeated accesses.
@@ -40,6 +40,14 @@ struct MultiplyDenseRowWithSparseRowMatrixToColumnOutputOptions {
      * If this is set to 1, no blocking is performed.
      */
     int block_size = 16;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not extracted and the multiplication only uses its indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -75,7 +83,7 @@ void multiply_dense_row_with_sparse_row_matrix_to_column_output(
     auto right_vbuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(common_dim);
     auto right_ibuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightIndex_> > >(common_dim);
     auto right_ranges = tatami::create_container_of_Index_size<std::vector<tatami::SparseRange<RightValue_, RightIndex_> > >(common_dim);
-    populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, options.num_threads);
+    populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, options.pattern, options.num_threads);
 
     // We'll be skipping the empty RHS rows during iteration.
     auto right_non_empty = filter_non_empty_sparse(
@@ -97,8 +105,14 @@ void multiply_dense_row_with_sparse_row_matrix_to_column_output(
                 auto loop_body = [&](LeftIndex_ cd) -> void {
                     const auto rrange = right_ranges[cd];
                     const Output_ mult = lptr[cd];
-                    for (RightIndex_ x = 0; x < rrange.number; ++x) {
-                        tmp_row[rrange.index[x]] += mult * static_cast<Output_>(rrange.value[x]);
+                    if (options.pattern) {
+                        for (RightIndex_ x = 0; x < rrange.number; ++x) {
+                            tmp_row[rrange.index[x]] += mult;
+                        }
+                    } else {
+                        for (RightIndex_ x = 0; x < rrange.number; ++x) {
+                            tmp_row[rrange.index[x]] += mult * static_cast<Output_>(rrange.value[x]);
+                        }
                     }
                 };
 
@@ -179,7 +193,7 @@ void multiply_dense_row_with_sparse_row_matrix_to_column_output(
                     }
 
                     for (RightIndex_ x = 0; x < rrange.number; ++x) {
-                        const Output_ mult = rrange.value[x];
+                        const Output_ mult = (options.pattern ? 1 : rrange.value[x]);
                         for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
                             tmp_optr[sanisizer::nd_offset<std::size_t>(out_row_offset + lr_counter, out_stride, rrange.index[x])] += mult * static_cast<Output_>(colbuffer[lr_counter]);
                         }
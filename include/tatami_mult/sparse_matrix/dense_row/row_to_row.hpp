@@ -36,8 +36,108 @@ struct MultiplyDenseRowWithSparseRowMatrixToRowOutputOptions {
      * See the \f$C\f$ parameter in the @ref sparse-blocking "Blocking for sparse matrices" section for more details.
      */
     int block_size = 1;
+
+    /**
+     * Minimum proportion of non-zero elements in a RHS row for it to be stored densely after realization.
+     * Dense-enough rows are then added to the output with a contiguous loop, avoiding the indirect writes of the sparse representation.
+     * The default of 1 only stores rows without any structural zeros densely, so the results are the same as if the dense storage was not used.
+     * Smaller values may be faster, e.g., at 0.5, a dense row uses no more memory than its sparse counterpart with similarly-sized values and indices.
+     * However, the structural zeros of each dense row will then be multiplied explicitly, so any non-finite values in `left` may propagate to more entries of the output.
+     * Values greater than 1 disable the dense storage altogether.
+     */
+    double dense_threshold = 1;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not extracted and the multiplication only uses its indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
+/**
+ * @cond
+ */
+// Creating a functor that adds the product of the next 'lr_num' LHS rows in '[start, start + length)' to a row-major 'block' with 'right_columns' columns.
+// This is also used by multiply_with_matrix_to_row_blocks() to fill each block of streamed output rows.
+// 'right_dense' and 'right_non_empty' should be created from 'right_ranges' by densify_sparse_buffers() and filter_non_empty_sparse(), respectively.
+template<typename Output_, typename LeftValue_, typename LeftIndex_, typename RightColumns_, typename RightValue_, typename RightIndex_, class NonEmpty_>
+auto setup_dense_row_with_sparse_row_matrix_to_row_blocks(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ start,
+    const LeftIndex_ length,
+    const RightColumns_ right_columns,
+    const std::vector<tatami::SparseRange<RightValue_, RightIndex_> >& right_ranges,
+    const std::vector<std::vector<RightValue_> >& right_dense,
+    const NonEmpty_& right_non_empty,
+    const MultiplyDenseRowWithSparseRowMatrixToRowOutputOptions& options
+) {
+    const auto common_dim = left.ncol();
+    const LeftIndex_ max_block_rows = sanisizer::min(length, options.block_size);
+    std::vector<std::vector<LeftValue_> > lbuffers;
+    lbuffers.reserve(max_block_rows);
+    for (LeftIndex_ b = 0; b < max_block_rows; ++b) {
+        lbuffers.emplace_back(tatami::cast_Index_to_container_size<std::vector<LeftValue_> >(common_dim));
+    }
+
+    return [
+        ext = tatami::consecutive_extractor<false>(left, true, start, length),
+        lbuffers = std::move(lbuffers),
+        lptrs = tatami::create_container_of_Index_size<std::vector<const LeftValue_*> >(max_block_rows),
+        &right_ranges,
+        &right_dense,
+        &right_non_empty,
+        common_dim,
+        right_columns
+    ](const LeftIndex_ lr_num, Output_* const block) mutable -> void {
+        for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
+            lptrs[lr_counter] = ext->fetch(lbuffers[lr_counter].data());
+        }
+
+        auto loop_body = [&](LeftIndex_ cd) -> void {
+            const auto& rdense = right_dense[cd];
+            if (!rdense.empty()) {
+                for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
+                    const Output_ mult = lptrs[lr_counter][cd];
+                    const auto curout = block + sanisizer::product_unsafe<std::size_t>(lr_counter, right_columns);
+                    for (RightColumns_ rc = 0; rc < right_columns; ++rc) {
+                        curout[rc] += mult * static_cast<Output_>(rdense[rc]);
+                    }
+                }
+                return;
+            }
+
+            const auto rrange = right_ranges[cd];
+            for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
+                const Output_ mult = lptrs[lr_counter][cd];
+                if (rrange.value == NULL) { // i.e., a pattern matrix.
+                    for (RightIndex_ x = 0; x < rrange.number; ++x) {
+                        block[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_columns, lr_counter)] += mult;
+                    }
+                } else {
+                    for (RightIndex_ x = 0; x < rrange.number; ++x) {
+                        block[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_columns, lr_counter)] += mult * static_cast<Output_>(rrange.value[x]);
+                    }
+                }
+            }
+        };
+
+        if (right_non_empty.has_value()) {
+            for (const auto cd : *right_non_empty) {
+                loop_body(cd);
+            }
+        } else {
+            for (LeftIndex_ cd = 0; cd < common_dim; ++cd) {
+                loop_body(cd);
+            }
+        }
+    };
+}
+/**
+ * @endcond
+ */
+
 /**
  * This function will iterate over `left`, realizing rows into memory as needed.
  * It will also realize all of `right` into memory for fast repeated accesses.
@@ -71,7 +171,8 @@ void multiply_dense_row_with_sparse_row_matrix_to_row_output(
     auto right_vbuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(common_dim);
     auto right_ibuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightIndex_> > >(common_dim);
     auto right_ranges = tatami::create_container_of_Index_size<std::vector<tatami::SparseRange<RightValue_, RightIndex_> > >(common_dim);
-    populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, options.num_threads);
+    populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, options.pattern, options.num_threads);
+    const auto right_dense = densify_sparse_buffers(common_dim, right_NC, right_vbuffers, right_ibuffers, right_ranges, options.dense_threshold, options.num_threads);
 
     // If there are any empty RHS rows, we only iterate over the non-empty ones in the loop for each LHS row.
     auto right_non_empty = filter_non_empty_sparse(
@@ -79,113 +180,16 @@ void multiply_dense_row_with_sparse_row_matrix_to_row_output(
         [&](RightIndex_) -> void {}
     );
 
-    const bool do_parallel = options.num_threads > 1;
-    if (!do_parallel) {
-        std::fill_n(output, sanisizer::product_unsafe<std::size_t>(left_NR, right_NC), 0);
-    }
-
-    if (options.block_size == 1) {
-        tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-            auto ext = tatami::consecutive_extractor<false>(left, true, start, length);
-            auto dbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(common_dim);
-
-            std::optional<std::vector<Output_> > tmp_row;
-            if (do_parallel) {
-                tmp_row.emplace(tatami::cast_Index_to_container_size<std::vector<Output_> >(right_NC));
-            }
-
-            for (LeftIndex_ lr = 0; lr < length; ++lr) {
-                const auto lptr = ext->fetch(dbuffer.data());
-                const auto optr = output + sanisizer::product_unsafe<std::size_t>(start + lr, right_NC);
-                const auto tmp_optr = (do_parallel ? tmp_row->data() : optr);
-
-                auto loop_body = [&](LeftIndex_ cd) -> void {
-                    const auto rrange = right_ranges[cd];
-                    const Output_ mult = lptr[cd];
-                    for (RightIndex_ x = 0; x < rrange.number; ++x) {
-                        tmp_optr[rrange.index[x]] += mult * static_cast<Output_>(rrange.value[x]);
-                    }
-                };
-
-                if (right_non_empty.has_value()) {
-                    for (const auto cd : *right_non_empty) {
-                        loop_body(cd);
-                    }
-                } else {
-                    for (LeftIndex_ cd = 0; cd < common_dim; ++cd) {
-                        loop_body(cd);
-                    }
-                }
-
-                if (do_parallel) {
-                    std::copy_n(tmp_optr, right_NC, optr);
-
-                    // Technically, we only have to reset the positions at which there is at least one non-zero across all RHS rows.
-                    // However, the union of all non-zero positions across all RHS rows is probably quite dense.
-                    // It'll likely be faster to just zero the entire buffer rather than trying to zero specific positions;
-                    // for example, one 64-byte cache line contains 8 doubles, so you'd need a density below ~10% to even avoid loading every cache line.
-                    // And that's not even considering further optimizations in the memset call.
-                    std::fill_n(tmp_optr, right_NC, 0);
-                }
-            }
-        }, left_NR, options.num_threads);
-
-    } else {
-        tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-            auto ext = tatami::consecutive_extractor<false>(left, true, start, length);
-
-            const LeftIndex_ max_block_rows = sanisizer::min(length, options.block_size);
-            std::vector<std::vector<LeftValue_> > lbuffers;
-            lbuffers.reserve(max_block_rows);
-            for (LeftIndex_ b = 0; b < max_block_rows; ++b) {
-                lbuffers.emplace_back(tatami::cast_Index_to_container_size<std::vector<LeftValue_> >(common_dim));
-            }
-            auto lptrs = tatami::create_container_of_Index_size<std::vector<const LeftValue_*> >(max_block_rows);
-
-            std::optional<std::vector<Output_> > tmp_rows;
-            if (do_parallel) {
-                tmp_rows.emplace(sanisizer::product<I<decltype(tmp_rows->size())> >(max_block_rows, right_NC));
-            }
-
-            LeftIndex_ lr = 0;
-            while (lr < length) {
-                const LeftIndex_ lr_num = sanisizer::min(options.block_size, length - lr);
-                for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-                    lptrs[lr_counter] = ext->fetch(lbuffers[lr_counter].data());
-                }
-                const auto optr = output + sanisizer::product_unsafe<std::size_t>(start + lr, right_NC);
-                const auto tmp_optr = (do_parallel ? tmp_rows->data() : optr);
-
-                auto loop_body = [&](LeftIndex_ cd) -> void {
-                    const auto rrange = right_ranges[cd];
-                    for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
-                        const Output_ mult = lptrs[lr_counter][cd];
-                        for (RightIndex_ x = 0; x < rrange.number; ++x) {
-                            tmp_optr[sanisizer::nd_offset<std::size_t>(rrange.index[x], right_NC, lr_counter)] += mult * static_cast<Output_>(rrange.value[x]);
-                        }
-                    }
-                };
-
-                if (right_non_empty.has_value()) {
-                    for (const auto cd : *right_non_empty) {
-                        loop_body(cd);
-                    }
-                } else {
-                    for (LeftIndex_ cd = 0; cd < common_dim; ++cd) {
-                        loop_body(cd);
-                    }
-                }
-
-                if (do_parallel) {
-                    const auto output_size = sanisizer::product_unsafe<std::size_t>(lr_num, right_NC);
-                    std::copy_n(tmp_optr, output_size, optr);
-                    std::fill_n(tmp_optr, output_size, 0);
-                }
-
-                lr += lr_num;
-            }
-        }, left_NR, options.num_threads);
-    }
+    compute_row_blocks_to_row_output(
+        left_NR,
+        right_NC,
+        options.block_size,
+        [&](const LeftIndex_ start, const LeftIndex_ length) {
+            return setup_dense_row_with_sparse_row_matrix_to_row_blocks<Output_>(left, start, length, right_NC, right_ranges, right_dense, right_non_empty, options);
+        },
+        output,
+        options.num_threads
+    );
 }
 
 }
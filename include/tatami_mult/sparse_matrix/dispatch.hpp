@@ -65,6 +65,20 @@ inline void set_sparse_block_size(MultiplyWithSparseMatrixOptions& options, int
     set_sparse_block_size(options.sparse_row, block_size);
 }
 
+/**
+ * Specify whether the RHS matrix is a pattern matrix in all multiplication functions involving a sparse matrix RHS.
+ * See `MultiplyDenseRowWithSparseRowMatrixToRowOutputOptions::pattern` for details.
+ *
+ * @param options Options to be set.
+ * @param pattern Whether all non-zero values in the RHS matrix are equal to 1.
+ */
+inline void set_sparse_pattern(MultiplyWithSparseMatrixOptions& options, bool pattern) {
+    set_sparse_pattern(options.dense_row, pattern);
+    set_sparse_pattern(options.dense_column, pattern);
+    set_sparse_pattern(options.sparse_row, pattern);
+    set_sparse_pattern(options.sparse_column, pattern);
+}
+
 /**
  * This function delegates to `multiply_sparse_row_with_sparse_matrix()`,
  * `multiply_sparse_column_with_sparse_matrix()`,
@@ -31,6 +31,15 @@ struct MultiplySparseColumnWithSparseColumnMatrixToColumnOutputOptions {
      * Different numbers of threads may slightly change the results due to differences in floating-point round-off error.
      */
     int num_threads = 1;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not used in the multiplication.
+     * Note that the values are still realized by `tatami::retrieve_fragmented_sparse_contents()`,
+     * so this only avoids loading them in the inner loops.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -106,7 +115,7 @@ void multiply_sparse_column_with_sparse_column_matrix_to_column_output(
                 const auto& right_indices = rhs_data.index[actual_cd];
                 const RightIndex_ right_nnz = right_values.size();
                 for (RightIndex_ x = 0; x < right_nnz; ++x) {
-                    const Output_ mult = right_values[x];
+                    const Output_ mult = (options.pattern ? 1 : right_values[x]);
                     const auto idx = right_indices[x];
                     for (LeftIndex_ y = 0; y < lrange.number; ++y) {
                         outptr[sanisizer::nd_offset<std::size_t>(lrange.index[y], left_NR, idx)] += mult * static_cast<Output_>(lrange.value[y]);
@@ -139,13 +148,7 @@ void multiply_sparse_column_with_sparse_column_matrix_to_column_output(
     }, cd_total, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
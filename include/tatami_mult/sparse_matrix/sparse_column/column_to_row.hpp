@@ -31,6 +31,15 @@ struct MultiplySparseColumnWithSparseColumnMatrixToRowOutputOptions {
      * Different numbers of threads may slightly change the results due to differences in floating-point round-off error.
      */
     int num_threads = 1;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not used in the multiplication.
+     * Note that the values are still realized by `tatami::retrieve_fragmented_sparse_contents()`,
+     * so this only avoids loading them in the inner loops.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -108,8 +117,14 @@ void multiply_sparse_column_with_sparse_column_matrix_to_row_output(
                 for (LeftIndex_ x = 0; x < lrange.number; ++x) {
                     const Output_ mult = lrange.value[x];
                     const auto idx = lrange.index[x];
-                    for (RightIndex_ y = 0; y < right_nnz; ++y) {
-                        outptr[sanisizer::nd_offset<std::size_t>(right_indices[y], right_NC, idx)] += mult * static_cast<Output_>(right_values[y]);
+                    if (options.pattern) {
+                        for (RightIndex_ y = 0; y < right_nnz; ++y) {
+                            outptr[sanisizer::nd_offset<std::size_t>(right_indices[y], right_NC, idx)] += mult;
+                        }
+                    } else {
+                        for (RightIndex_ y = 0; y < right_nnz; ++y) {
+                            outptr[sanisizer::nd_offset<std::size_t>(right_indices[y], right_NC, idx)] += mult * static_cast<Output_>(right_values[y]);
+                        }
                     }
                 }
             }
@@ -139,13 +154,7 @@ void multiply_sparse_column_with_sparse_column_matrix_to_row_output(
     }, cd_total, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
@@ -58,6 +58,20 @@ inline void set_num_threads(MultiplySparseColumnWithSparseMatrixOptions& options
     options.row_to_row.num_threads = num_threads;
 }
 
+/**
+ * Specify whether the RHS matrix is a pattern matrix in all multiplication functions involving a sparse column-major LHS and a sparse matrix RHS.
+ * See `MultiplySparseColumnWithSparseRowMatrixToRowOutputOptions::pattern` for details.
+ *
+ * @param options Options to be set.
+ * @param pattern Whether all non-zero values in the RHS matrix are equal to 1.
+ */
+inline void set_sparse_pattern(MultiplySparseColumnWithSparseMatrixOptions& options, bool pattern) {
+    options.column_to_column.pattern = pattern;
+    options.column_to_row.pattern = pattern;
+    options.row_to_column.pattern = pattern;
+    options.row_to_row.pattern = pattern;
+}
+
 /**
  * This function delegates to `multiply_sparse_column_with_sparse_row_matrix_to_row_output()`,
  * `multiply_sparse_column_with_sparse_row_matrix_to_column_output()`,
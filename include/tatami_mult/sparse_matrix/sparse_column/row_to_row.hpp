@@ -31,6 +31,14 @@ struct MultiplySparseColumnWithSparseRowMatrixToRowOutputOptions {
      * Different numbers of threads may slightly change the results due to differences in floating-point round-off error.
      */
     int num_threads = 1;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not extracted and the multiplication only uses its indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -72,7 +80,9 @@ void multiply_sparse_column_with_sparse_row_matrix_to_row_output(
 
     const int num_used = tatami::parallelize([&](int t, LeftIndex_ start, LeftIndex_ length) -> void {
         auto left_ext = tatami::consecutive_extractor<true>(left, false, start, length);
-        auto right_ext = tatami::consecutive_extractor<true>(right, true, start, length);
+        tatami::Options right_opt;
+        right_opt.sparse_extract_value = !options.pattern;
+        auto right_ext = tatami::consecutive_extractor<true>(right, true, start, length, right_opt);
 
         std::optional<std::vector<Output_> > tmp_output;
         Output_* outptr; 
@@ -100,8 +110,14 @@ void multiply_sparse_column_with_sparse_row_matrix_to_row_output(
             for (LeftIndex_ x = 0; x < lrange.number; ++x) {
                 const auto idx = lrange.index[x]; 
                 const Output_ mult = lrange.value[x];
-                for (RightIndex_ y = 0; y < rrange.number; ++y) {
-                    outptr[sanisizer::nd_offset<std::size_t>(rrange.index[y], right_NC, idx)] += mult * static_cast<Output_>(rrange.value[y]);
+                if (options.pattern) {
+                    for (RightIndex_ y = 0; y < rrange.number; ++y) {
+                        outptr[sanisizer::nd_offset<std::size_t>(rrange.index[y], right_NC, idx)] += mult;
+                    }
+                } else {
+                    for (RightIndex_ y = 0; y < rrange.number; ++y) {
+                        outptr[sanisizer::nd_offset<std::size_t>(rrange.index[y], right_NC, idx)] += mult * static_cast<Output_>(rrange.value[y]);
+                    }
                 }
             }
         }
@@ -112,13 +128,7 @@ void multiply_sparse_column_with_sparse_row_matrix_to_row_output(
     }, common_dim, options.num_threads);
 
     if (do_parallel) {
-        for (int u = 1; u < num_used; ++u) {
-            const auto& tmp = *((*tmp_results)[u - 1]);
-            const auto N = tmp.size();
-            for (I<decltype(N)> x = 0; x < N; ++x) {
-                output[x] += tmp[x];
-            }
-        }
+        reduce_partial_outputs(output, *tmp_results, num_used, options.num_threads);
     }
 }
 
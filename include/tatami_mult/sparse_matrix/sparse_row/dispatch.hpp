@@ -70,6 +70,20 @@ inline void set_sparse_block_size(MultiplySparseRowWithSparseMatrixOptions& opti
     options.column_to_row.block_size = block_size;
 }
 
+/**
+ * Specify whether the RHS matrix is a pattern matrix in all multiplication functions involving a sparse row-major LHS and a sparse matrix RHS.
+ * See `MultiplySparseRowWithSparseRowMatrixToRowOutputOptions::pattern` for details.
+ *
+ * @param options Options to be set.
+ * @param pattern Whether all non-zero values in the RHS matrix are equal to 1.
+ */
+inline void set_sparse_pattern(MultiplySparseRowWithSparseMatrixOptions& options, bool pattern) {
+    options.column_to_column.pattern = pattern;
+    options.column_to_row.pattern = pattern;
+    options.row_to_column.pattern = pattern;
+    options.row_to_row.pattern = pattern;
+}
+
 /**
  * This function delegates to `multiply_sparse_row_with_sparse_row_matrix_to_row_output()`,
  * `multiply_sparse_row_with_sparse_row_matrix_to_column_output()`,
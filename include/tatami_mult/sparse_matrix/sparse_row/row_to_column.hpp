@@ -30,6 +30,14 @@ struct MultiplySparseRowWithSparseRowMatrixToColumnOutputOptions {
      * Different numbers of threads will not change the results. 
      */
     int num_threads = 1;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not extracted and the multiplication only uses its indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
 /**
@@ -65,7 +73,7 @@ void multiply_sparse_row_with_sparse_row_matrix_to_column_output(
     auto right_vbuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(common_dim);
     auto right_ibuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightIndex_> > >(common_dim);
     auto right_ranges = tatami::create_container_of_Index_size<std::vector<tatami::SparseRange<RightValue_, RightIndex_> > >(common_dim);
-    populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, options.num_threads);
+    populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, options.pattern, options.num_threads);
 
     tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
         auto ext = tatami::consecutive_extractor<true>(left, true, start, length);
@@ -81,8 +89,14 @@ void multiply_sparse_row_with_sparse_row_matrix_to_column_output(
             for (LeftIndex_ x = 0; x < lrange.number; ++x) {
                 const Output_ mult = lrange.value[x];
                 const auto rrange = right_ranges[lrange.index[x]];
-                for (RightIndex_ y = 0; y < rrange.number; ++y) {
-                    tmp_row[rrange.index[y]] += mult * static_cast<Output_>(rrange.value[y]);
+                if (options.pattern) {
+                    for (RightIndex_ y = 0; y < rrange.number; ++y) {
+                        tmp_row[rrange.index[y]] += mult;
+                    }
+                } else {
+                    for (RightIndex_ y = 0; y < rrange.number; ++y) {
+                        tmp_row[rrange.index[y]] += mult * static_cast<Output_>(rrange.value[y]);
+                    }
                 }
             }
 
@@ -30,8 +30,81 @@ struct MultiplySparseRowWithSparseRowMatrixToRowOutputOptions {
      * Different numbers of threads will not change the results. 
      */
     int num_threads = 1;
+
+    /**
+     * Minimum proportion of non-zero elements in a RHS row for it to be stored densely after realization.
+     * Dense-enough rows are then added to the output with a contiguous loop, avoiding the indirect writes of the sparse representation.
+     * The default of 1 only stores rows without any structural zeros densely, so the results are the same as if the dense storage was not used.
+     * Smaller values may be faster but will multiply the structural zeros of each dense row explicitly,
+     * so any non-finite values in `left` may propagate to more entries of the output.
+     * Values greater than 1 disable the dense storage altogether.
+     */
+    double dense_threshold = 1;
+
+    /**
+     * Whether `right` is a pattern matrix, i.e., all of its non-zero values are equal to 1.
+     * If true, the non-zero values of `right` are not extracted and the multiplication only uses its indices,
+     * which reduces memory traffic for adjacency or presence/absence matrices.
+     * Results are undefined if `right` contains non-zero values other than 1.
+     */
+    bool pattern = false;
 };
 
+/**
+ * @cond
+ */
+// Creating a functor that adds the product of the next 'lr_num' LHS rows in '[start, start + length)' to a row-major 'block' with 'right_columns' columns.
+// This is also used by multiply_with_matrix_to_row_blocks() to fill each block of streamed output rows.
+// 'right_dense' should be created from 'right_ranges' by densify_sparse_buffers().
+template<typename Output_, typename LeftValue_, typename LeftIndex_, typename RightColumns_, typename RightValue_, typename RightIndex_>
+auto setup_sparse_row_with_sparse_row_matrix_to_row_blocks(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const LeftIndex_ start,
+    const LeftIndex_ length,
+    const RightColumns_ right_columns,
+    const std::vector<tatami::SparseRange<RightValue_, RightIndex_> >& right_ranges,
+    const std::vector<std::vector<RightValue_> >& right_dense
+) {
+    const auto common_dim = left.ncol();
+    return [
+        ext = tatami::consecutive_extractor<true>(left, true, start, length),
+        vbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(common_dim),
+        ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(common_dim),
+        &right_ranges,
+        &right_dense,
+        right_columns
+    ](const LeftIndex_ lr_num, Output_* const block) mutable -> void {
+        for (LeftIndex_ lr_counter = 0; lr_counter < lr_num; ++lr_counter) {
+            const auto lrange = ext->fetch(vbuffer.data(), ibuffer.data());
+            const auto optr = block + sanisizer::product_unsafe<std::size_t>(lr_counter, right_columns);
+            for (LeftIndex_ x = 0; x < lrange.number; ++x) {
+                const Output_ mult = lrange.value[x];
+                const auto& rdense = right_dense[lrange.index[x]];
+                if (!rdense.empty()) {
+                    for (RightColumns_ rc = 0; rc < right_columns; ++rc) {
+                        optr[rc] += mult * static_cast<Output_>(rdense[rc]);
+                    }
+                    continue;
+                }
+
+                const auto rrange = right_ranges[lrange.index[x]];
+                if (rrange.value == NULL) { // i.e., a pattern matrix.
+                    for (RightIndex_ y = 0; y < rrange.number; ++y) {
+                        optr[rrange.index[y]] += mult;
+                    }
+                } else {
+                    for (RightIndex_ y = 0; y < rrange.number; ++y) {
+                        optr[rrange.index[y]] += mult * static_cast<Output_>(rrange.value[y]);
+                    }
+                }
+            }
+        }
+    };
+}
+/**
+ * @endcond
+ */
+
 /**
  * This function will iterate over `left`, realizing rows into memory as needed.
  * It will also realize all of `right` into memory for fast repeated accesses.
@@ -65,48 +138,19 @@ void multiply_sparse_row_with_sparse_row_matrix_to_row_output(
     auto right_vbuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightValue_> > >(common_dim);
     auto right_ibuffers = tatami::create_container_of_Index_size<std::vector<std::vector<RightIndex_> > >(common_dim);
     auto right_ranges = tatami::create_container_of_Index_size<std::vector<tatami::SparseRange<RightValue_, RightIndex_> > >(common_dim);
-    populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, options.num_threads);
-
-    const bool do_parallel = options.num_threads > 1;
-    if (!do_parallel) {
-        std::fill_n(output, sanisizer::product_unsafe<std::size_t>(left_NR, right_NC), 0);
-    }
-
-    tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
-        auto ext = tatami::consecutive_extractor<true>(left, true, start, length);
-        auto vbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(common_dim);
-        auto ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(common_dim);
-
-        std::optional<std::vector<Output_> > tmp_row;
-        if (do_parallel) {
-            tmp_row.emplace(tatami::cast_Index_to_container_size<std::vector<Output_> >(right_NC));
-        }
-
-        for (LeftIndex_ lr = 0; lr < length; ++lr) {
-            const auto lrange = ext->fetch(vbuffer.data(), ibuffer.data());
-            const auto optr = output + sanisizer::product_unsafe<std::size_t>(start + lr, right_NC);
-            const auto tmp_optr = (do_parallel ? tmp_row->data() : optr);
-
-            for (LeftIndex_ x = 0; x < lrange.number; ++x) {
-                const auto rrange = right_ranges[lrange.index[x]];
-                const Output_ mult = lrange.value[x];
-                for (RightIndex_ y = 0; y < rrange.number; ++y) {
-                    tmp_optr[rrange.index[y]] += mult * static_cast<Output_>(rrange.value[y]);
-                }
-            };
-
-            if (do_parallel) {
-                std::copy_n(tmp_optr, right_NC, optr);
-
-                // Technically, we only have to reset the positions at which there is at least one non-zero across all RHS rows.
-                // However, the union of all non-zero positions across all RHS rows is probably quite dense.
-                // It'll likely be faster to just zero the entire buffer rather than trying to zero specific positions;
-                // for example, one 64-byte cache line contains 8 doubles, so you'd need a density below ~10% to even avoid loading every cache line.
-                // And that's not even considering further optimizations in the memset call.
-                std::fill_n(tmp_optr, right_NC, 0);
-            }
-        }
-    }, left_NR, options.num_threads);
+    populate_sparse_buffers(true, common_dim, right_NC, right, right_vbuffers, right_ibuffers, right_ranges, options.pattern, options.num_threads);
+    const auto right_dense = densify_sparse_buffers(common_dim, right_NC, right_vbuffers, right_ibuffers, right_ranges, options.dense_threshold, options.num_threads);
+
+    compute_row_blocks_to_row_output(
+        left_NR,
+        right_NC,
+        1,
+        [&](const LeftIndex_ start, const LeftIndex_ length) {
+            return setup_sparse_row_with_sparse_row_matrix_to_row_blocks<Output_>(left, start, length, right_NC, right_ranges, right_dense);
+        },
+        output,
+        options.num_threads
+    );
 }
 
 }
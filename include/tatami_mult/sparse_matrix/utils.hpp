@@ -11,6 +11,7 @@
 
 namespace tatami_mult {
 
+// If 'pattern = true', only the indices are extracted and the value pointers of all ranges are set to NULL.
 template<typename Value_, typename Index_>
 void populate_sparse_buffers(
     const bool row,
@@ -20,18 +21,30 @@ void populate_sparse_buffers(
     std::vector<std::vector<Value_> >& all_vbuffers,
     std::vector<std::vector<Index_> >& all_ibuffers,
     std::vector<tatami::SparseRange<Value_, Index_> >& all_ranges,
+    const bool pattern,
     int num_threads
 ) {
     tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
-        auto tmp_v = tatami::create_container_of_Index_size<std::vector<Value_> >(secondary);
+        std::vector<Value_> tmp_v;
+        if (!pattern) {
+            tatami::resize_container_to_Index_size(tmp_v, secondary);
+        }
         auto tmp_i = tatami::create_container_of_Index_size<std::vector<Index_> >(secondary);
-        auto ext = tatami::consecutive_extractor<true>(matrix, row, start, length);
+
+        tatami::Options opt;
+        opt.sparse_extract_value = !pattern;
+        auto ext = tatami::consecutive_extractor<true>(matrix, row, start, length, opt);
+
         for (Index_ i = start, end = start + length; i < end; ++i) {
-            tmp_v.resize(secondary); // creation was type-safe, so should resize.
+            if (!pattern) {
+                tmp_v.resize(secondary); // creation was type-safe, so should resize.
+            }
             tmp_i.resize(secondary);
 
             auto range = ext->fetch(tmp_v.data(), tmp_i.data());
-            if (range.value == tmp_v.data()) {
+            if (pattern) {
+                range.value = NULL;
+            } else if (range.value == tmp_v.data()) {
                 all_vbuffers[i].swap(tmp_v);
                 range.value = all_vbuffers[i].data();
             }
@@ -44,6 +57,54 @@ void populate_sparse_buffers(
     }, primary, num_threads);
 }
 
+// Expanding the vectors with at least 'threshold * secondary' non-zero elements into dense buffers.
+// The sparse buffers for these vectors are released as the dense buffers will be used instead,
+// so the value and index pointers of their ranges are set to NULL to avoid any dangling references; only 'number' is preserved.
+// Vectors that remain sparse are represented by an empty dense buffer.
+template<typename Value_, typename Index_>
+std::vector<std::vector<Value_> > densify_sparse_buffers(
+    const Index_ primary,
+    const Index_ secondary,
+    std::vector<std::vector<Value_> >& all_vbuffers,
+    std::vector<std::vector<Index_> >& all_ibuffers,
+    std::vector<tatami::SparseRange<Value_, Index_> >& all_ranges,
+    const double threshold,
+    int num_threads
+) {
+    auto output = tatami::create_container_of_Index_size<std::vector<std::vector<Value_> > >(primary);
+    if (threshold > 1) {
+        return output;
+    }
+
+    const double limit = threshold * static_cast<double>(secondary);
+    tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+        for (Index_ i = start, end = start + length; i < end; ++i) {
+            auto& range = all_ranges[i];
+            if (range.number == 0 || static_cast<double>(range.number) < limit) {
+                continue;
+            }
+
+            auto& dense = output[i];
+            tatami::resize_container_to_Index_size(dense, secondary);
+            if (range.value == NULL) { // i.e., a pattern matrix.
+                for (Index_ x = 0; x < range.number; ++x) {
+                    dense[range.index[x]] = 1;
+                }
+            } else {
+                for (Index_ x = 0; x < range.number; ++x) {
+                    dense[range.index[x]] = range.value[x];
+                }
+            }
+            std::vector<Value_>().swap(all_vbuffers[i]);
+            std::vector<Index_>().swap(all_ibuffers[i]);
+            range.value = NULL;
+            range.index = NULL;
+        }
+    }, primary, num_threads);
+
+    return output;
+}
+
 template<typename Value_, typename Index_, class Zero_>
 std::optional<std::vector<Index_> > filter_non_empty_sparse(
     const std::vector<tatami::SparseRange<Value_, Index_> >& all_ranges,
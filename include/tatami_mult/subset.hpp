@@ -0,0 +1,414 @@
+#ifndef TATAMI_MULT_SUBSET_HPP
+#define TATAMI_MULT_SUBSET_HPP
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cstddef>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+#include "dense_dot_product.hpp"
+#include "sparse_dot_product.hpp"
+#include "dense_matrix/dispatch.hpp"
+#include "sparse_matrix/dispatch.hpp"
+
+/**
+ * @file subset.hpp
+ * @brief Products involving subsets of the rows, columns or common dimension.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `multiply_subset_with_multiple_vectors()` and `multiply_subset_with_matrix()`.
+ */
+struct MultiplySubsetOptions {
+    /**
+     * Number of threads to use in `multiply_subset_with_multiple_vectors()`.
+     * Different numbers of threads may slightly change the results due to differences in floating-point round-off error,
+     * if the LHS matrix prefers column access.
+     */
+    int num_threads = 1;
+
+    /**
+     * Options to pass to `multiply_with_dense_matrix()` in `multiply_subset_with_matrix()`, if `right` is dense.
+     */
+    MultiplyWithDenseMatrixOptions dense_matrix;
+
+    /**
+     * Options to pass to `multiply_with_sparse_matrix()` in `multiply_subset_with_matrix()`, if `right` is sparse.
+     */
+    MultiplyWithSparseMatrixOptions sparse_matrix;
+};
+
+/**
+ * Set the number of threads to use in `multiply_subset_with_multiple_vectors()` and `multiply_subset_with_matrix()`.
+ *
+ * @param options Options to be set.
+ * @param num_threads Number of threads, should be positive.
+ */
+inline void set_num_threads(MultiplySubsetOptions& options, int num_threads) {
+    options.num_threads = num_threads;
+    set_num_threads(options.dense_matrix, num_threads);
+    set_num_threads(options.sparse_matrix, num_threads);
+}
+
+/**
+ * @cond
+ */
+template<typename Index_>
+Index_ get_subset_length(const tatami::VectorPtr<Index_>& subset, const Index_ full) {
+    if (subset) {
+        return sanisizer::cast<Index_>(subset->size());
+    } else {
+        return full;
+    }
+}
+
+// Mapping each index in the subset to its position in the subset.
+// This only spans the range of the subset so that the cost is independent of the full extent of the dimension.
+template<typename Index_>
+class SubsetPositions {
+public:
+    SubsetPositions(const tatami::VectorPtr<Index_>& subset) {
+        if (subset && !subset->empty()) {
+            my_offset = subset->front();
+            tatami::resize_container_to_Index_size(my_positions, subset->back() - my_offset + 1);
+            const Index_ num = subset->size();
+            for (Index_ s = 0; s < num; ++s) {
+                my_positions[(*subset)[s] - my_offset] = s;
+            }
+            my_identity = false;
+        }
+    }
+
+    Index_ operator()(const Index_ i) const {
+        if (my_identity) {
+            return i;
+        } else {
+            return my_positions[i - my_offset];
+        }
+    }
+
+private:
+    bool my_identity = true;
+    Index_ my_offset = 0;
+    std::vector<Index_> my_positions;
+};
+
+// Iterating over [start, start + length) of the subset along the target dimension,
+// extracting only the subset of the non-target dimension.
+template<bool sparse_, typename Value_, typename Index_>
+auto new_subset_extractor(
+    const tatami::Matrix<Value_, Index_>& matrix,
+    const bool row,
+    const tatami::VectorPtr<Index_>& target_subset,
+    const Index_ start,
+    const Index_ length,
+    const tatami::VectorPtr<Index_>& non_target_subset
+) {
+    std::shared_ptr<const tatami::Oracle<Index_> > oracle;
+    if (target_subset) {
+        oracle.reset(new tatami::FixedViewOracle<Index_>(target_subset->data() + start, length));
+    } else {
+        oracle.reset(new tatami::ConsecutiveOracle<Index_>(start, length));
+    }
+
+    if (non_target_subset) {
+        return tatami::new_extractor<sparse_, true>(matrix, row, std::move(oracle), non_target_subset);
+    } else {
+        return tatami::new_extractor<sparse_, true>(matrix, row, std::move(oracle));
+    }
+}
+
+// Here, each 'right' vector is compact, i.e., it contains one entry per element of the common subset.
+template<std::size_t accumulators_, typename LeftValue_, typename LeftIndex_, typename Output_>
+void multiply_subset_with_compact_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::VectorPtr<LeftIndex_>& row_subset,
+    const tatami::VectorPtr<LeftIndex_>& common_subset,
+    const std::vector<std::vector<Output_> >& right,
+    const std::vector<Output_*>& output,
+    const MultiplySubsetOptions& options
+) {
+    const auto num_rows = get_subset_length(row_subset, left.nrow());
+    const auto num_common = get_subset_length(common_subset, left.ncol());
+    const auto right_vectors = right.size();
+    typedef I<decltype(right_vectors)> RightVectors;
+    const bool sparse = left.is_sparse();
+
+    if (left.prefer_rows()) {
+        const SubsetPositions<LeftIndex_> common_positions(sparse ? common_subset : nullptr);
+
+        tatami::parallelize([&](int, const LeftIndex_ start, const LeftIndex_ length) -> void {
+            if (sparse) {
+                auto ext = new_subset_extractor<true>(left, true, row_subset, start, length, common_subset);
+                auto vbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(num_common);
+                auto ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(num_common);
+                std::vector<LeftIndex_> pbuffer;
+                if (common_subset) {
+                    tatami::resize_container_to_Index_size(pbuffer, num_common);
+                }
+
+                for (LeftIndex_ lr = 0; lr < length; ++lr) {
+                    const auto range = ext->fetch(vbuffer.data(), ibuffer.data());
+
+                    // Converting the indices into positions in the common subset, so that they can be used to index into the compact 'right' vectors.
+                    const LeftIndex_* positions = range.index;
+                    if (common_subset) {
+                        for (LeftIndex_ x = 0; x < range.number; ++x) {
+                            pbuffer[x] = common_positions(range.index[x]);
+                        }
+                        positions = pbuffer.data();
+                    }
+
+                    for (RightVectors rv = 0; rv < right_vectors; ++rv) {
+                        output[rv][start + lr] = sparse_dot_product<accumulators_>(
+                            range.number, // Implicit cast to std::size_t is safe, as per the tatami contract.
+                            range.value,
+                            positions,
+                            right[rv].data(),
+                            static_cast<Output_>(0)
+                        );
+                    }
+                }
+
+            } else {
+                auto ext = new_subset_extractor<false>(left, true, row_subset, start, length, common_subset);
+                auto buffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(num_common);
+                for (LeftIndex_ lr = 0; lr < length; ++lr) {
+                    const auto ptr = ext->fetch(buffer.data());
+                    for (RightVectors rv = 0; rv < right_vectors; ++rv) {
+                        output[rv][start + lr] = dense_dot_product<accumulators_>(
+                            num_common, // Implicit cast to std::size_t is safe, as per the tatami contract.
+                            ptr,
+                            right[rv].data(),
+                            static_cast<Output_>(0)
+                        );
+                    }
+                }
+            }
+        }, num_rows, options.num_threads);
+        return;
+    }
+
+    for (RightVectors rv = 0; rv < right_vectors; ++rv) {
+        std::fill_n(output[rv], num_rows, 0);
+    }
+    const SubsetPositions<LeftIndex_> row_positions(sparse ? row_subset : nullptr);
+
+    auto compute = [&](const LeftIndex_ start, const LeftIndex_ length, auto get_output_vector) -> void {
+        if (sparse) {
+            auto ext = new_subset_extractor<true>(left, false, common_subset, start, length, row_subset);
+            auto vbuffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(num_rows);
+            auto ibuffer = tatami::create_container_of_Index_size<std::vector<LeftIndex_> >(num_rows);
+            for (LeftIndex_ cd = 0; cd < length; ++cd) {
+                const auto range = ext->fetch(vbuffer.data(), ibuffer.data());
+                for (RightVectors rv = 0; rv < right_vectors; ++rv) {
+                    const Output_ mult = right[rv][start + cd];
+                    const auto outvec = get_output_vector(rv);
+                    for (LeftIndex_ x = 0; x < range.number; ++x) {
+                        outvec[row_positions(range.index[x])] += mult * static_cast<Output_>(range.value[x]);
+                    }
+                }
+            }
+
+        } else {
+            auto ext = new_subset_extractor<false>(left, false, common_subset, start, length, row_subset);
+            auto buffer = tatami::create_container_of_Index_size<std::vector<LeftValue_> >(num_rows);
+            for (LeftIndex_ cd = 0; cd < length; ++cd) {
+                const auto ptr = ext->fetch(buffer.data());
+                for (RightVectors rv = 0; rv < right_vectors; ++rv) {
+                    const Output_ mult = right[rv][start + cd];
+                    const auto outvec = get_output_vector(rv);
+                    for (LeftIndex_ lr = 0; lr < num_rows; ++lr) {
+                        outvec[lr] += mult * static_cast<Output_>(ptr[lr]);
+                    }
+                }
+            }
+        }
+    };
+
+    const auto get_output_vector = [&](const RightVectors rv) -> Output_* {
+        return output[rv];
+    };
+
+    const bool do_parallel = options.num_threads > 1;
+    std::optional<std::vector<std::optional<std::vector<Output_> > > > tmp_results;
+    if (do_parallel) {
+        tmp_results.emplace(sanisizer::cast<I<decltype(tmp_results->size())> >(options.num_threads - 1));
+    }
+
+    const auto num_used = tatami::parallelize([&](int t, const LeftIndex_ start, const LeftIndex_ length) -> void {
+        if (!do_parallel || t == 0) {
+            compute(start, length, get_output_vector);
+
+        } else {
+            // Storing all partial outputs contiguously for reduce_partial_output_vectors().
+            std::vector<Output_> tmp_output(sanisizer::product<typename std::vector<Output_>::size_type>(right_vectors, num_rows));
+            compute(
+                start,
+                length,
+                [&](const RightVectors rv) -> Output_* {
+                    return tmp_output.data() + sanisizer::product_unsafe<std::size_t>(rv, num_rows);
+                }
+            );
+            (*tmp_results)[t - 1] = std::move(tmp_output);
+        }
+    }, num_common, options.num_threads);
+
+    if (do_parallel) {
+        reduce_partial_output_vectors(
+            right_vectors,
+            get_output_vector,
+            num_rows,
+            [&](const int u) -> const Output_* {
+                return (*tmp_results)[u - 1]->data();
+            },
+            num_used,
+            options.num_threads
+        );
+    }
+}
+
+// Applying the subsets to a matrix so that it can be passed to the matrix multiplication kernels.
+// For sorted and unique indices, the extractors of the tatami::DelayedSubset views forward the kernels' oracles to the underlying matrix with an indexed selection,
+// so only the subset is ever extracted and the kernels' buffers are sized according to the subsets.
+template<typename Value_, typename Index_, typename RowIndex_, typename ColumnIndex_>
+std::shared_ptr<const tatami::Matrix<Value_, Index_> > apply_subsets(
+    const tatami::Matrix<Value_, Index_>& matrix,
+    const tatami::VectorPtr<RowIndex_>& row_subset,
+    const tatami::VectorPtr<ColumnIndex_>& column_subset
+) {
+    std::shared_ptr<const tatami::Matrix<Value_, Index_> > output = tatami::wrap_shared_ptr(&matrix);
+    if (row_subset) {
+        output = tatami::make_DelayedSubset<Value_, Index_>(std::move(output), std::vector<Index_>(row_subset->begin(), row_subset->end()), true);
+    }
+    if (column_subset) {
+        output = tatami::make_DelayedSubset<Value_, Index_>(std::move(output), std::vector<Index_>(column_subset->begin(), column_subset->end()), false);
+    }
+    return output;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Multiply a subset of the rows of a matrix `left` with multiple vectors `right`, using only a subset of the common dimension.
+ * Specifically, for each `i`, this computes `output[i] = left[r, s] * right[i][s]` where `r` is `row_subset` and `s` is `common_subset`.
+ *
+ * The subsets are used directly in the extraction from `left`, i.e., with oracles for the iteration dimension and indexed extraction for the other dimension.
+ * This avoids the overhead of wrapping `left` in a `tatami::DelayedSubset`,
+ * and all buffers are sized according to the subsets so the cost of the multiplication is proportional to the size of the subsets.
+ *
+ * @tparam accumulators_ Number of accumulators for computing the dot product,
+ * see the @ref multiple-accumulators "Multiple accumulators" section for more details.
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param row_subset Pointer to a vector of sorted and unique row indices of `left`.
+ * If NULL, all rows are used.
+ * @param common_subset Pointer to a vector of sorted and unique column indices of `left`, representing the subset of the common dimension.
+ * If NULL, all columns are used.
+ * @param[in] right Vector of pointers, each of which points to an array of length `left.ncol()`.
+ * Each entry contains an RHS vector with which to multiply `left`, though only the entries in `common_subset` are accessed.
+ * @param[out] output Vector of length equal to `right.size()`.
+ * Each entry is a pointer to an array of length equal to the number of rows in the subset.
+ * On output, the `i`-th entry stores the product `left[r, s] * right[i][s]`.
+ * @param options Further options.
+ */
+template<std::size_t accumulators_ = 4, typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void multiply_subset_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::VectorPtr<LeftIndex_>& row_subset,
+    const tatami::VectorPtr<LeftIndex_>& common_subset,
+    const std::vector<RightValue_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplySubsetOptions& options
+) {
+    // Gathering the RHS entries for the common subset, so that they can be accessed contiguously.
+    const auto num_common = get_subset_length(common_subset, left.ncol());
+    std::vector<std::vector<Output_> > compact;
+    compact.reserve(right.size());
+    for (const auto rptr : right) {
+        compact.emplace_back(tatami::cast_Index_to_container_size<std::vector<Output_> >(num_common));
+        auto& current = compact.back();
+        if (common_subset) {
+            for (LeftIndex_ cd = 0; cd < num_common; ++cd) {
+                current[cd] = rptr[(*common_subset)[cd]];
+            }
+        } else {
+            std::copy_n(rptr, num_common, current.begin());
+        }
+    }
+
+    multiply_subset_with_compact_vectors<accumulators_>(left, row_subset, common_subset, compact, output, options);
+}
+
+/**
+ * Multiply a subset of the rows of a matrix `left` with a subset of the columns of another matrix `right`, using only a subset of the common dimension.
+ * Specifically, this computes `left[r, s] * right[s, c]` where `r` is `row_subset`, `s` is `common_subset` and `c` is `column_subset`.
+ *
+ * The subsets are applied to `left` and `right` before they are passed to `multiply_with_dense_matrix()` or `multiply_with_sparse_matrix()`,
+ * so the product is computed by the same kernels as `multiply_with_matrix()` and is written directly to `output` in the requested layout.
+ * The matrix kernels drive their own extraction with oracles,
+ * so the subsets are represented by `tatami::DelayedSubset` views that forward the oracles and indices to the extractors of the underlying matrices.
+ * All buffers are sized according to the subsets so the cost of the multiplication is proportional to the size of the subsets.
+ *
+ * Unlike `multiply_subset_with_multiple_vectors()`, this function does not avoid the `tatami::DelayedSubset` wrapper.
+ * Passing the subsets through every matrix kernel would duplicate each kernel's extraction logic, for a small benefit.
+ * For sorted and unique subsets, the wrapper already extracts only the subset from the underlying matrix, with the kernels' oracles and an indexed selection.
+ * Its remaining per-fetch cost is a virtual call and, for sparse extraction along a subsetted dimension, a remapping of the returned indices.
+ * Both are small compared to the multiplication of each fetched row/column.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS matrix value.
+ * @tparam RightIndex_ Integer type of the RHS matrix index.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left LHS matrix to be multiplied.
+ * @param right RHS matrix to be multiplied.
+ * `right.nrow()` and `left.ncol()` should be equal.
+ * @param row_subset Pointer to a vector of sorted and unique row indices of `left`.
+ * If NULL, all rows are used.
+ * @param common_subset Pointer to a vector of sorted and unique column indices of `left` (and row indices of `right`), representing the subset of the common dimension.
+ * If NULL, all columns of `left` are used.
+ * @param column_subset Pointer to a vector of sorted and unique column indices of `right`.
+ * If NULL, all columns are used.
+ * @param[out] output Pointer to an array of length equal to the product of the number of rows in `row_subset` and the number of columns in `column_subset`.
+ * On output, this stores the product `left[r, s] * right[s, c]`.
+ * @param output_row_major Whether to store the product in row-major format.
+ * If false, the product is stored in column-major format.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename RightIndex_, typename Output_>
+void multiply_subset_with_matrix(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const tatami::Matrix<RightValue_, RightIndex_>& right,
+    const tatami::VectorPtr<LeftIndex_>& row_subset,
+    const tatami::VectorPtr<LeftIndex_>& common_subset,
+    const tatami::VectorPtr<RightIndex_>& column_subset,
+    Output_* const output,
+    const bool output_row_major,
+    const MultiplySubsetOptions& options
+) {
+    const auto sub_left = apply_subsets(left, row_subset, common_subset);
+    const auto sub_right = apply_subsets(right, common_subset, column_subset);
+    if (sub_right->is_sparse()) {
+        multiply_with_sparse_matrix(*sub_left, *sub_right, output, output_row_major, options.sparse_matrix);
+    } else {
+        multiply_with_dense_matrix(*sub_left, *sub_right, output, output_row_major, options.dense_matrix);
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef TATAMI_MULT_SYMMETRIC_HPP
+#define TATAMI_MULT_SYMMETRIC_HPP
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+
+/**
+ * @file symmetric.hpp
+ * @brief Symmetric LHS stored as a single triangle.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `multiply_symmetric_with_single_vector()` and `multiply_symmetric_with_multiple_vectors()`.
+ */
+struct MultiplySymmetricOptions {
+    /**
+     * Whether the upper triangle of the LHS matrix should be used.
+     * If false, the lower triangle is used instead.
+     * Elements in the other triangle are never extracted and may contain arbitrary values, e.g., zeros in a sparse matrix that only stores one triangle.
+     */
+    bool upper = false;
+
+    /**
+     * Number of consecutive rows (or columns, if the LHS matrix prefers column access) that are extracted with the same contiguous block.
+     * Each block covers the triangle for all of its rows, so larger values reduce the number of extractor constructions at the cost of extracting more elements outside of the triangle.
+     */
+    int block_size = 128;
+
+    /**
+     * Number of threads to use.
+     * Different numbers of threads may slightly change the results due to differences in floating-point round-off error.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @cond
+ */
+template<bool sparse_, typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void multiply_symmetric(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplySymmetricOptions& options
+) {
+    const LeftIndex_ N = left.nrow();
+    const auto num_vectors = right.size();
+
+    // By symmetry, we can iterate along the preferred dimension regardless of which triangle is stored.
+    // The triangle covers the leading elements [0, i] of the i-th row in the lower triangle, or of the i-th column in the upper triangle;
+    // otherwise, it covers the trailing elements [i, N).
+    const bool row = left.prefer_rows();
+    const bool leading = (row != options.upper);
+    const LeftIndex_ block_size = sanisizer::min(std::max(options.block_size, 1), N);
+    const int num_threads = std::max(options.num_threads, 1);
+
+    // Each off-diagonal element contributes to two outputs, so each partition needs its own output buffers.
+    compute_triangle_partitions_with_partials(N, output, num_threads, [&](const int p, const std::vector<Output_*>& optrs) -> void {
+        auto dots = sanisizer::create<std::vector<Output_> >(num_vectors);
+
+        // Partitioning so that each thread processes roughly the same number of triangle elements, rather than the same number of rows.
+        const LeftIndex_ first = triangle_partition_boundary(N, leading, p, num_threads);
+        const LeftIndex_ last = triangle_partition_boundary(N, leading, p + 1, num_threads);
+        iterate_triangle<sparse_>(left, row, leading, first, last, false, block_size, [&](const LeftIndex_ i, const LeftValue_ diag, auto for_each) -> void {
+            const Output_ dmult = diag;
+            for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                dots[v] = dmult * right[v][i];
+            }
+
+            for_each([&](const LeftIndex_ j, const LeftValue_ val) -> void {
+                const Output_ mult = val;
+                for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                    dots[v] += mult * right[v][j];
+                    optrs[v][j] += mult * right[v][i];
+                }
+            });
+
+            for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                optrs[v][i] += dots[v];
+            }
+        });
+    });
+}
+
+template<typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void multiply_symmetric(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplySymmetricOptions& options
+) {
+    if (left.is_sparse()) {
+        multiply_symmetric<true>(left, right, output, options);
+    } else {
+        multiply_symmetric<false>(left, right, output, options);
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Multiply a symmetric matrix with a single vector, i.e., the equivalent of BLAS's SYMV.
+ * Only one triangle of `left` is extracted, using block extraction along its preferred dimension.
+ * Each off-diagonal element of the triangle contributes to two entries of the output, which allows users to store only one triangle of large symmetric operators,
+ * e.g., covariance, kernel or graph Laplacian matrices, and halves the amount of data that needs to be extracted.
+ *
+ * Each thread processes a contiguous range of rows (or columns) that contains roughly the same number of triangle elements,
+ * and accumulates its contributions into its own buffer of length equal to the number of rows of `left`.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vector.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left Square LHS matrix to be multiplied.
+ * This is treated as a symmetric matrix where the triangle specified by `MultiplySymmetricOptions::upper` is reflected across the diagonal.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On output, this stores the product of the symmetric matrix and `right`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void multiply_symmetric_with_single_vector(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightValue_* const right,
+    Output_* const output,
+    const MultiplySymmetricOptions& options
+) {
+    multiply_symmetric(left, std::vector<const RightValue_*>{ right }, std::vector<Output_*>{ output }, options);
+}
+
+/**
+ * Multiply a symmetric matrix with multiple vectors, i.e., the equivalent of BLAS's SYMM.
+ * This is similar to `multiply_symmetric_with_single_vector()` except that each extracted element of the triangle is applied to all RHS vectors.
+ * Each thread allocates a buffer of length equal to the product of the number of rows of `left` and the number of vectors.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam Right_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output arrays.
+ *
+ * @param left Square LHS matrix to be multiplied.
+ * This is treated as a symmetric matrix where the triangle specified by `MultiplySymmetricOptions::upper` is reflected across the diagonal.
+ * @param[in] right Vector of pointers, each of which points to an array of length equal to the number of columns of `left`.
+ * Each entry contains a RHS vector with which to multiply the symmetric matrix.
+ * @param[out] output Vector of pointers, each of which points to an array of length equal to the number of rows of `left`.
+ * On output, the `i`-th entry stores the product of the symmetric matrix and `right[i]`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void multiply_symmetric_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplySymmetricOptions& options
+) {
+    multiply_symmetric(left, right, output, options);
+}
+
+}
+
+#endif
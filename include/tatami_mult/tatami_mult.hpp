@@ -2,9 +2,22 @@
 #define TATAMI_MULT_HPP
 
 #include "single_vector/dispatch.hpp"
+#include "single_vector/compressed_sparse_row.hpp"
 #include "multiple_vectors/dispatch.hpp"
 #include "dense_matrix/dispatch.hpp"
 #include "sparse_matrix/dispatch.hpp"
+#include "row_blocks.hpp"
+#include "epilogue.hpp"
+#include "multiple_matrices.hpp"
+#include "bidirectional.hpp"
+#include "sliced_ellpack.hpp"
+#include "symmetric.hpp"
+#include "triangular.hpp"
+#include "banded.hpp"
+#include "transpose.hpp"
+#include "out_of_core.hpp"
+#include "partial.hpp"
+#include "subset.hpp"
 
 #include <vector>
 
@@ -53,6 +66,7 @@ struct MultiplyWithMatrixOptions {
  *
  * @param options Options to be set.
  * @param num_threads Number of threads, should be positive.
+ * This should usually be no greater than the number of physical cores, see the @ref parallelization "Parallelization" section for details.
  */
 inline void set_num_threads(MultiplyWithMatrixOptions& options, int num_threads) {
     set_num_threads(options.dense_matrix, num_threads);
@@ -0,0 +1,65 @@
+#ifndef TATAMI_MULT_TRANSPOSE_HPP
+#define TATAMI_MULT_TRANSPOSE_HPP
+
+#include <cstddef>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+
+/**
+ * @file transpose.hpp
+ * @brief Conversion between row-major and column-major layouts.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `transpose()`.
+ */
+struct TransposeOptions {
+    /**
+     * Number of threads to use.
+     * The transposition is parallelized across the columns of the input array.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * Transpose a dense array, e.g., to convert the output of a multiplication function from row-major to column-major format or vice versa.
+ * This uses a recursively blocked (cache-oblivious) algorithm so that the input and output arrays are accessed in cache-friendly tiles regardless of their dimensions.
+ *
+ * @tparam Input_ Numeric type of the input array.
+ * @tparam Index_ Integer type of the array dimensions.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param[in] input Pointer to an array of length equal to `nrow * ncol`, containing a matrix in row-major format.
+ * @param nrow Number of rows in the matrix.
+ * @param ncol Number of columns in the matrix.
+ * @param[out] output Pointer to an array of length equal to `nrow * ncol`.
+ * On output, this stores the same matrix in column-major format.
+ * This should not overlap with `input`.
+ * @param options Further options.
+ *
+ * Note that a row-major `nrow`-by-`ncol` matrix has the same layout as a column-major `ncol`-by-`nrow` matrix.
+ * So, to convert a column-major `nrow`-by-`ncol` matrix into row-major format, call this function with the dimensions swapped.
+ */
+template<typename Input_, typename Index_, typename Output_>
+void transpose(const Input_* input, const Index_ nrow, const Index_ ncol, Output_* output, const TransposeOptions& options) {
+    const auto NR = sanisizer::cast<std::size_t>(nrow);
+    tatami::parallelize([&](int, Index_ start, Index_ length) -> void {
+        transpose_tile<false>(
+            input + start,
+            NR,
+            sanisizer::cast<std::size_t>(length),
+            sanisizer::cast<std::size_t>(ncol),
+            output + sanisizer::product_unsafe<std::size_t>(start, NR),
+            NR
+        );
+    }, ncol, options.num_threads);
+}
+
+}
+
+#endif
@@ -0,0 +1,366 @@
+#ifndef TATAMI_MULT_TRIANGULAR_HPP
+#define TATAMI_MULT_TRIANGULAR_HPP
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+
+/**
+ * @file triangular.hpp
+ * @brief Products with, and solves against, a triangular LHS.
+ */
+
+namespace tatami_mult {
+
+/**
+ * @brief Options for `multiply_triangular_with_single_vector()` and `multiply_triangular_with_multiple_vectors()`.
+ */
+struct MultiplyTriangularOptions {
+    /**
+     * Whether the LHS matrix is upper triangular.
+     * If false, it is assumed to be lower triangular.
+     * Elements in the other triangle are never extracted and are treated as zero, regardless of their actual values.
+     */
+    bool upper = false;
+
+    /**
+     * Whether the diagonal of the LHS matrix is assumed to consist of ones.
+     * If true, the diagonal elements are not used, regardless of their actual values.
+     */
+    bool unit_diagonal = false;
+
+    /**
+     * Number of consecutive rows (or columns, if the LHS matrix prefers column access) that are extracted with the same contiguous block.
+     * Each block covers the triangle for all of its rows, so larger values reduce the number of extractor constructions at the cost of extracting more elements outside of the triangle.
+     */
+    int block_size = 128;
+
+    /**
+     * Number of threads to use.
+     * Different numbers of threads may slightly change the results due to differences in floating-point round-off error.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @cond
+ */
+template<bool sparse_, typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void multiply_triangular(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplyTriangularOptions& options
+) {
+    const LeftIndex_ N = left.nrow();
+    const auto num_vectors = right.size();
+    const bool row = left.prefer_rows();
+    const bool leading = (row != options.upper);
+    const LeftIndex_ block_size = sanisizer::min(std::max(options.block_size, 1), N);
+    const int num_threads = std::max(options.num_threads, 1);
+
+    auto get_diagonal = [&](const LeftValue_ diag) -> Output_ {
+        if (options.unit_diagonal) {
+            return 1;
+        } else {
+            return diag;
+        }
+    };
+
+    if (row) {
+        // Each output element is a dot product of a row of the triangle, so no per-thread buffers are required.
+        tatami::parallelize([&](int, int start, int length) -> void {
+            auto dots = sanisizer::create<std::vector<Output_> >(num_vectors);
+            for (int p = start, pend = start + length; p < pend; ++p) {
+                const LeftIndex_ first = triangle_partition_boundary(N, leading, p, num_threads);
+                const LeftIndex_ last = triangle_partition_boundary(N, leading, p + 1, num_threads);
+                iterate_triangle<sparse_>(left, true, leading, first, last, false, block_size, [&](const LeftIndex_ i, const LeftValue_ diag, auto for_each) -> void {
+                    const Output_ dmult = get_diagonal(diag);
+                    for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                        dots[v] = dmult * right[v][i];
+                    }
+
+                    for_each([&](const LeftIndex_ j, const LeftValue_ val) -> void {
+                        const Output_ mult = val;
+                        for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                            dots[v] += mult * right[v][j];
+                        }
+                    });
+
+                    for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                        output[v][i] = dots[v];
+                    }
+                });
+            }
+        }, num_threads, num_threads);
+        return;
+    }
+
+    // Otherwise, each column of the triangle is scattered into the output, so each partition needs its own output buffers.
+    compute_triangle_partitions_with_partials(N, output, num_threads, [&](const int p, const std::vector<Output_*>& optrs) -> void {
+        const LeftIndex_ first = triangle_partition_boundary(N, leading, p, num_threads);
+        const LeftIndex_ last = triangle_partition_boundary(N, leading, p + 1, num_threads);
+        iterate_triangle<sparse_>(left, false, leading, first, last, false, block_size, [&](const LeftIndex_ j, const LeftValue_ diag, auto for_each) -> void {
+            const Output_ dmult = get_diagonal(diag);
+            for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                optrs[v][j] += dmult * right[v][j];
+            }
+
+            for_each([&](const LeftIndex_ i, const LeftValue_ val) -> void {
+                const Output_ mult = val;
+                for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                    optrs[v][i] += mult * right[v][j];
+                }
+            });
+        });
+    });
+}
+
+template<typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void multiply_triangular(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplyTriangularOptions& options
+) {
+    if (left.is_sparse()) {
+        multiply_triangular<true>(left, right, output, options);
+    } else {
+        multiply_triangular<false>(left, right, output, options);
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Multiply a triangular matrix with a single vector, i.e., the equivalent of BLAS's TRMV.
+ * Only the relevant triangle of `left` is extracted, using block extraction along its preferred dimension.
+ * If `left` prefers row access, each output element is computed as a dot product of a row of the triangle;
+ * otherwise, each column of the triangle is scattered into per-thread buffers of length equal to the number of rows of `left`.
+ * In both cases, threads are assigned contiguous ranges of rows (or columns) that contain roughly the same number of triangle elements.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vector.
+ * @tparam Output_ Numeric type of the output array.
+ *
+ * @param left Square LHS matrix to be multiplied.
+ * This is treated as a triangular matrix according to `MultiplyTriangularOptions::upper`.
+ * @param[in] right Pointer to an array of length equal to the number of columns of `left`,
+ * containing the RHS vector.
+ * @param[out] output Pointer to an array of length equal to the number of rows of `left`.
+ * On output, this stores the product of the triangular matrix and `right`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void multiply_triangular_with_single_vector(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightValue_* const right,
+    Output_* const output,
+    const MultiplyTriangularOptions& options
+) {
+    multiply_triangular(left, std::vector<const RightValue_*>{ right }, std::vector<Output_*>{ output }, options);
+}
+
+/**
+ * Multiply a triangular matrix with multiple vectors, i.e., the equivalent of BLAS's TRMM.
+ * This is similar to `multiply_triangular_with_single_vector()` except that each extracted element of the triangle is applied to all RHS vectors.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam Right_ Numeric type of the RHS vectors.
+ * @tparam Output_ Numeric type of the output arrays.
+ *
+ * @param left Square LHS matrix to be multiplied.
+ * This is treated as a triangular matrix according to `MultiplyTriangularOptions::upper`.
+ * @param[in] right Vector of pointers, each of which points to an array of length equal to the number of columns of `left`.
+ * Each entry contains a RHS vector with which to multiply the triangular matrix.
+ * @param[out] output Vector of pointers, each of which points to an array of length equal to the number of rows of `left`.
+ * On output, the `i`-th entry stores the product of the triangular matrix and `right[i]`.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void multiply_triangular_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const MultiplyTriangularOptions& options
+) {
+    multiply_triangular(left, right, output, options);
+}
+
+/**
+ * @brief Options for `solve_triangular_with_single_vector()` and `solve_triangular_with_multiple_vectors()`.
+ */
+struct SolveTriangularOptions {
+    /**
+     * Whether the LHS matrix is upper triangular.
+     * If false, it is assumed to be lower triangular.
+     * Elements in the other triangle are never extracted and are treated as zero, regardless of their actual values.
+     */
+    bool upper = false;
+
+    /**
+     * Whether the diagonal of the LHS matrix is assumed to consist of ones.
+     * If true, the diagonal elements are not used, regardless of their actual values.
+     */
+    bool unit_diagonal = false;
+
+    /**
+     * Number of consecutive rows (or columns, if the LHS matrix prefers column access) that are extracted with the same contiguous block.
+     * Each block covers the triangle for all of its rows, so larger values reduce the number of extractor constructions at the cost of extracting more elements outside of the triangle.
+     */
+    int block_size = 128;
+
+    /**
+     * Number of threads to use.
+     * Each thread solves a subset of the RHS vectors with its own pass through the LHS matrix,
+     * so multiple threads are only useful with at least as many RHS vectors.
+     * Different numbers of threads will not change the results.
+     */
+    int num_threads = 1;
+};
+
+/**
+ * @cond
+ */
+template<bool sparse_, typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void solve_triangular(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const SolveTriangularOptions& options
+) {
+    const LeftIndex_ N = left.nrow();
+    const auto num_vectors = right.size();
+    for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+        if (static_cast<const void*>(right[v]) != static_cast<const void*>(output[v])) {
+            std::copy_n(right[v], N, output[v]);
+        }
+    }
+
+    // Lower triangular matrices are solved by forward substitution, upper triangular matrices by backward substitution.
+    const bool row = left.prefer_rows();
+    const bool leading = (row != options.upper);
+    const bool descending = options.upper;
+    const LeftIndex_ block_size = sanisizer::min(std::max(options.block_size, 1), N);
+
+    tatami::parallelize([&](int, int start, int length) -> void {
+        const int end = start + length;
+        iterate_triangle<sparse_>(left, row, leading, static_cast<LeftIndex_>(0), N, descending, block_size, [&](const LeftIndex_ i, const LeftValue_ diag, auto for_each) -> void {
+            const Output_ dmult = diag;
+            if (row) {
+                // Subtracting the contributions of the already-solved elements before dividing by the diagonal.
+                for_each([&](const LeftIndex_ j, const LeftValue_ val) -> void {
+                    const Output_ mult = val;
+                    for (int v = start; v < end; ++v) {
+                        output[v][i] -= mult * output[v][j];
+                    }
+                });
+                if (!options.unit_diagonal) {
+                    for (int v = start; v < end; ++v) {
+                        output[v][i] /= dmult;
+                    }
+                }
+
+            } else {
+                // Solving the current element and then removing its contribution from all elements that have yet to be solved.
+                if (!options.unit_diagonal) {
+                    for (int v = start; v < end; ++v) {
+                        output[v][i] /= dmult;
+                    }
+                }
+                for_each([&](const LeftIndex_ j, const LeftValue_ val) -> void {
+                    const Output_ mult = val;
+                    for (int v = start; v < end; ++v) {
+                        output[v][j] -= mult * output[v][i];
+                    }
+                });
+            }
+        });
+    }, sanisizer::cast<int>(num_vectors), options.num_threads);
+}
+
+template<typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void solve_triangular(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const SolveTriangularOptions& options
+) {
+    if (left.is_sparse()) {
+        solve_triangular<true>(left, right, output, options);
+    } else {
+        solve_triangular<false>(left, right, output, options);
+    }
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Solve a triangular system of equations with a single RHS vector, i.e., the equivalent of BLAS's TRSV.
+ * This computes \f$T^{-1}b\f$ for a triangular matrix \f$T\f$ by forward substitution (if lower triangular) or backward substitution (if upper triangular).
+ * Only the relevant triangle of `left` is extracted, using block extraction along its preferred dimension.
+ * No checks are performed for zeros on the diagonal, which will result in infinite or NaN values in the output.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam RightValue_ Numeric type of the RHS vector.
+ * @tparam Output_ Floating-point type of the output array.
+ *
+ * @param left Square LHS matrix.
+ * This is treated as a triangular matrix according to `SolveTriangularOptions::upper`.
+ * @param[in] right Pointer to an array of length equal to the number of rows of `left`,
+ * containing the RHS vector \f$b\f$.
+ * @param[out] output Pointer to an array of length equal to the number of columns of `left`.
+ * On output, this stores the solution \f$T^{-1}b\f$.
+ * This may be the same as `right` for an in-place solve.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename RightValue_, typename Output_>
+void solve_triangular_with_single_vector(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const RightValue_* const right,
+    Output_* const output,
+    const SolveTriangularOptions& options
+) {
+    solve_triangular(left, std::vector<const RightValue_*>{ right }, std::vector<Output_*>{ output }, options);
+}
+
+/**
+ * Solve a triangular system of equations with multiple RHS vectors, i.e., the equivalent of BLAS's TRSM.
+ * This is similar to `solve_triangular_with_single_vector()` except that each extracted element of the triangle is applied to all RHS vectors.
+ *
+ * @tparam LeftValue_ Numeric type of the LHS matrix value.
+ * @tparam LeftIndex_ Integer type of the LHS matrix index.
+ * @tparam Right_ Numeric type of the RHS vectors.
+ * @tparam Output_ Floating-point type of the output arrays.
+ *
+ * @param left Square LHS matrix.
+ * This is treated as a triangular matrix according to `SolveTriangularOptions::upper`.
+ * @param[in] right Vector of pointers, each of which points to an array of length equal to the number of rows of `left`.
+ * @param[out] output Vector of pointers, each of which points to an array of length equal to the number of columns of `left`.
+ * On output, the `i`-th entry stores the solution for `right[i]`.
+ * Each entry may be the same as the corresponding entry of `right` for an in-place solve.
+ * @param options Further options.
+ */
+template<typename LeftValue_, typename LeftIndex_, typename Right_, typename Output_>
+void solve_triangular_with_multiple_vectors(
+    const tatami::Matrix<LeftValue_, LeftIndex_>& left,
+    const std::vector<Right_*>& right,
+    const std::vector<Output_*>& output,
+    const SolveTriangularOptions& options
+) {
+    solve_triangular(left, right, output, options);
+}
+
+}
+
+#endif
@@ -5,6 +5,11 @@
 #include <vector>
 #include <cassert>
 #include <array>
+#include <algorithm>
+#include <memory>
+#include <cmath>
+#include <cstddef>
+#include <optional>
 
 #include "tatami/tatami.hpp"
 #include "sanisizer/sanisizer.hpp"
@@ -14,6 +19,29 @@ namespace tatami_mult {
 template<typename Input_>
 using I = std::remove_cv_t<std::remove_reference_t<Input_> >;
 
+// Small integer types, typically used to store counts or quantized values.
+// Products of two such values are exactly representable in a 64-bit integer,
+// so we can accumulate them without any conversion to floating-point.
+template<typename Type_>
+constexpr bool is_small_integer = std::is_integral<Type_>::value && sizeof(Type_) <= 2;
+
+// Whether to convert small integer LHS values to the output type in bulk after extraction.
+// This conversion is easily vectorized and only needs to be performed once for each LHS vector,
+// rather than once per element in each dot product with a non-integer RHS vector.
+template<typename Left_, typename Right_>
+constexpr bool convert_small_integer_left = is_small_integer<Left_> && !is_small_integer<Right_>;
+
+template<bool convert_, class Extractor_, typename Raw_, typename Stored_>
+const Stored_* fetch_dense_converted(Extractor_& ext, std::vector<Raw_>& raw_buffer, std::vector<Stored_>& stored_buffer) {
+    if constexpr(convert_) {
+        auto ptr = ext.fetch(raw_buffer.data());
+        std::copy_n(ptr, stored_buffer.size(), stored_buffer.data());
+        return stored_buffer.data();
+    } else {
+        return ext.fetch(stored_buffer.data());
+    }
+}
+
 // Mathematically equivalent to std::accumulate but reorders summations for greater instruction-level parallelism.
 template<std::size_t width_>
 double recursive_sum(std::array<double, width_>& dots) {
@@ -35,6 +63,173 @@ double recursive_sum(std::array<double, width_>& dots) {
     }
 }
 
+// Cache-oblivious transposition of a row-major 'nrow * ncol' tile, i.e., output[c * output_stride + r] = input[r * input_stride + c].
+// We recursively halve the longer dimension until the tile fits in a small base case, so each level of the cache hierarchy eventually sees a tile that fits.
+// The fixed-size base case has contiguous writes and a short stride for the reads, which gives the compiler a good chance to unroll/vectorize it.
+// If accumulate_ = true, the transposed values are added to the existing contents of 'output'.
+template<bool accumulate_, typename Input_, typename Output_>
+void transpose_tile(const Input_* input, const std::size_t nrow, const std::size_t ncol, const std::size_t input_stride, Output_* output, const std::size_t output_stride) {
+    constexpr std::size_t base_size = 16;
+    if (nrow <= base_size && ncol <= base_size) {
+        for (std::size_t c = 0; c < ncol; ++c) {
+            const auto curout = output + c * output_stride;
+            for (std::size_t r = 0; r < nrow; ++r) {
+                const Output_ val = input[r * input_stride + c];
+                if constexpr(accumulate_) {
+                    curout[r] += val;
+                } else {
+                    curout[r] = val;
+                }
+            }
+        }
+    } else if (nrow >= ncol) {
+        const std::size_t half = nrow / 2;
+        transpose_tile<accumulate_>(input, half, ncol, input_stride, output, output_stride);
+        transpose_tile<accumulate_>(input + half * input_stride, nrow - half, ncol, input_stride, output + half, output_stride);
+    } else {
+        const std::size_t half = ncol / 2;
+        transpose_tile<accumulate_>(input, nrow, half, input_stride, output, output_stride);
+        transpose_tile<accumulate_>(input + half, nrow, ncol - half, input_stride, output + half * output_stride, output_stride);
+    }
+}
+
+// Adding per-thread partial results into multiple output vectors, each of length 'length'.
+// For each thread 'u' in '[1, num_used)', 'get_partial(u)' should return a pointer to its partial results for all vectors (thread 0 writes directly to the outputs),
+// where the results for vector 'v' start at an offset of 'v * length'.
+// Each partial buffer was allocated and first touched by the worker that filled it, so on NUMA systems, it lives on that worker's node.
+// Rather than having the calling thread pull every buffer across the interconnect, we parallelize the reduction across contiguous slices of the outputs,
+// which spreads the reads over all memory controllers. The order of additions for each element is unchanged so the result is identical to a serial reduction.
+// If 'finalize' is not a nullptr, each completed element is replaced by 'finalize(v, i, value)' for vector 'v' and position 'i' while its slice is still in cache;
+// this is done even if 'num_used <= 1', in which case no partial results are added.
+template<typename Vectors_, class GetOutputVector_, typename Length_, class GetPartial_, class Finalize_ = std::nullptr_t>
+void reduce_partial_output_vectors(
+    const Vectors_ num_vectors,
+    GetOutputVector_ get_output_vector,
+    const Length_ length,
+    GetPartial_ get_partial,
+    const int num_used,
+    const int num_threads,
+    Finalize_ finalize = nullptr
+) {
+    constexpr bool has_finalize = !std::is_same<Finalize_, std::nullptr_t>::value;
+    if constexpr(!has_finalize) {
+        if (num_used <= 1) {
+            return;
+        }
+    }
+
+    const auto len = sanisizer::cast<std::size_t>(length);
+    const auto N = sanisizer::product<std::size_t>(num_vectors, len);
+    constexpr std::size_t block_size = 16384; // avoid spinning up threads for small outputs, and avoid false sharing at the slice boundaries.
+    const auto num_blocks = sanisizer::cast<std::ptrdiff_t>(N / block_size + (N % block_size > 0));
+
+    tatami::parallelize([&](int, std::ptrdiff_t start, std::ptrdiff_t blocks) -> void {
+        const std::size_t first = static_cast<std::size_t>(start) * block_size;
+        const std::size_t last = std::min(N, static_cast<std::size_t>(start + blocks) * block_size);
+        for (int u = 1; u < num_used; ++u) {
+            const auto tmp = get_partial(u);
+
+            // Walking through the vectors that overlap with this slice.
+            auto x = first;
+            while (x < last) {
+                const std::size_t v = x / len;
+                const auto vstart = v * len;
+                const auto vend = std::min(last, vstart + len);
+                const auto optr = get_output_vector(static_cast<Vectors_>(v));
+                for (; x < vend; ++x) {
+                    optr[x - vstart] += tmp[x];
+                }
+            }
+        }
+
+        if constexpr(has_finalize) {
+            auto x = first;
+            while (x < last) {
+                const std::size_t v = x / len;
+                const auto vstart = v * len;
+                const auto vend = std::min(last, vstart + len);
+                const auto optr = get_output_vector(static_cast<Vectors_>(v));
+                for (; x < vend; ++x) {
+                    auto& current = optr[x - vstart];
+                    current = finalize(static_cast<Vectors_>(v), x - vstart, current);
+                }
+            }
+        }
+    }, num_blocks, num_threads);
+}
+
+// Adding per-thread partial results into 'output', where '*(partials[u - 1])' holds the results of thread 'u' (thread 0 writes directly to 'output').
+// This is a special case of reduce_partial_output_vectors() with a single output vector.
+template<typename Output_, class Partials_>
+void reduce_partial_outputs(Output_* const output, const Partials_& partials, const int num_used, const int num_threads) {
+    if (num_used <= 1) {
+        return;
+    }
+    reduce_partial_output_vectors(
+        1,
+        [&](int) -> Output_* {
+            return output;
+        },
+        partials[0]->size(),
+        [&](const int u) {
+            return partials[u - 1]->data();
+        },
+        num_used,
+        num_threads
+    );
+}
+
+// Computing a row-major product over blocks of up to 'block_size' LHS rows.
+// For each thread, 'setup(start, length)' should return a functor that accepts 'lr_num' and 'block',
+// and adds the product of the next 'lr_num' LHS rows in '[start, start + length)' to the row-major array 'block' with 'right_columns' columns.
+// The same functors are used by the row-block streaming functions, which supply their own buffers instead of 'output'.
+template<typename Output_, typename LeftIndex_, typename RightColumns_, class Setup_>
+void compute_row_blocks_to_row_output(
+    const LeftIndex_ left_NR,
+    const RightColumns_ right_columns,
+    const int block_size,
+    Setup_ setup,
+    Output_* const output,
+    const int num_threads
+) {
+    const bool do_parallel = num_threads > 1;
+    if (!do_parallel) {
+        // Product must fit in a size_t in order for output to have been allocated correctly in the first place.
+        // Technically, right_columns could be larger than a size_t if left_NR == 0, but the product after wraparound would still be zero, so it's fine.
+        std::fill_n(output, sanisizer::product_unsafe<std::size_t>(right_columns, left_NR), 0);
+    }
+
+    tatami::parallelize([&](int, LeftIndex_ start, LeftIndex_ length) -> void {
+        auto compute = setup(start, length);
+
+        // Creating a block to hold the output during the updates, to mitigate false sharing between threads.
+        // There is still some false sharing when we transfer the results to the output rows, but this is fine as it is outside of the innermost loop.
+        std::optional<std::vector<Output_> > tmp_output;
+        if (do_parallel) {
+            const LeftIndex_ max_block_rows = sanisizer::min(length, block_size);
+            tmp_output.emplace(sanisizer::product<I<decltype(tmp_output->size())> >(max_block_rows, right_columns));
+        }
+
+        LeftIndex_ lr = 0;
+        while (lr < length) {
+            const LeftIndex_ lr_num = sanisizer::min(block_size, length - lr);
+            const auto optr = output + sanisizer::product_unsafe<std::size_t>(start + lr, right_columns);
+            const auto tmp_optr = (do_parallel ? tmp_output->data() : optr);
+            compute(lr_num, tmp_optr);
+
+            if (do_parallel) {
+                // Technically, we only have to reset the positions that were modified by 'compute'.
+                // However, it'll likely be faster to just zero the entire buffer rather than trying to zero specific positions;
+                // for example, one 64-byte cache line contains 8 doubles, so you'd need a density below ~10% to even avoid loading every cache line.
+                const auto out_space = sanisizer::product_unsafe<std::size_t>(lr_num, right_columns);
+                std::copy_n(tmp_optr, out_space, optr);
+                std::fill_n(tmp_optr, out_space, 0);
+            }
+            lr += lr_num;
+        }
+    }, left_NR, num_threads);
+}
+
 template<typename Index_>
 struct FetchNonEmptySparseBlockInfo {
     FetchNonEmptySparseBlockInfo(const Index_ position, const Index_ num_non_empty, const bool all_non_empty) : 
@@ -84,6 +279,160 @@ FetchNonEmptySparseBlockInfo<Index_> fetch_non_empty_sparse_block(
     return FetchNonEmptySparseBlockInfo(position, num_non_empty, all_non_empty);
 }
 
+
+// Identify the non-empty vectors of a sparse matrix in [start, start + length) along the specified dimension.
+// This uses a structure-only pass that does not extract any values or indices.
+//
+// The result is used to construct a fixed oracle for the extractor of the other (dense) operand in the lockstep kernels.
+// We don't build the oracle incrementally from the sparse extractor, as tatami oracles are queried ahead of the fetches to plan prefetching;
+// predicting the next index would require reading the sparse operand ahead of the dense one and buffering its vectors until they are fetched,
+// which costs more memory than this pass and still stalls the dense extractor's prefetching on the sparse extraction.
+template<typename Value_, typename Index_>
+std::vector<Index_> find_non_empty_sparse_vectors(const tatami::Matrix<Value_, Index_>& matrix, const bool row, const Index_ start, const Index_ length) {
+    tatami::Options opt;
+    opt.sparse_extract_value = false;
+    opt.sparse_extract_index = false;
+    auto ext = tatami::consecutive_extractor<true>(matrix, row, start, length, opt);
+    std::vector<Index_> output;
+    for (Index_ i = start, end = start + length; i < end; ++i) {
+        if (ext->fetch(NULL, NULL).number) {
+            output.push_back(i);
+        }
+    }
+    return output;
+}
+
+// Boundary of the 'p'-th of 'num_partitions' partitions of the rows (or columns) of a triangle of order 'N',
+// chosen so that each partition contains roughly the same number of triangle elements.
+// 'leading' indicates whether the i-th row (or column) contains the leading elements [0, i] of the triangle,
+// otherwise it contains the trailing elements [i, N).
+template<typename Index_>
+Index_ triangle_partition_boundary(const Index_ N, const bool leading, const int p, const int num_partitions) {
+    const double frac = static_cast<double>(p) / num_partitions;
+    if (leading) {
+        return static_cast<Index_>(std::round(N * std::sqrt(frac)));
+    } else {
+        return N - static_cast<Index_>(std::round(N * std::sqrt(1 - frac)));
+    }
+}
+
+// Calling 'compute(p, optrs)' for each of the 'num_partitions' partitions of a triangle of order 'N', where 'optrs' contains one pointer per output vector.
+// Each element of the triangle may contribute to any output element, so the first partition accumulates directly into the zeroed 'output'
+// while all other partitions accumulate into their own buffers, which are then added to 'output' by reduce_partial_output_vectors().
+template<typename Index_, typename Output_, class Compute_>
+void compute_triangle_partitions_with_partials(const Index_ N, const std::vector<Output_*>& output, const int num_partitions, Compute_ compute) {
+    const auto num_vectors = output.size();
+    for (const auto optr : output) {
+        std::fill_n(optr, N, 0);
+    }
+    auto buffers = sanisizer::create<std::vector<std::vector<Output_> > >(num_partitions);
+
+    tatami::parallelize([&](int, int start, int length) -> void {
+        auto optrs = output;
+        for (int p = start, pend = start + length; p < pend; ++p) {
+            if (p > 0) {
+                auto& curbuffer = buffers[p];
+                curbuffer.resize(sanisizer::product<I<decltype(curbuffer.size())> >(N, num_vectors));
+                for (I<decltype(num_vectors)> v = 0; v < num_vectors; ++v) {
+                    optrs[v] = curbuffer.data() + sanisizer::product_unsafe<std::size_t>(v, N);
+                }
+            }
+            compute(p, optrs);
+        }
+    }, num_partitions, num_partitions);
+
+    // Every partition is processed, so all buffers after the first are filled.
+    reduce_partial_output_vectors(
+        num_vectors,
+        [&](const I<decltype(num_vectors)> v) -> Output_* {
+            return output[v];
+        },
+        N,
+        [&](const int p) -> const Output_* {
+            return buffers[p].data();
+        },
+        num_partitions,
+        num_partitions
+    );
+}
+
+// Iterate over the triangle of a square matrix for the rows (or columns) in [first, last), in increasing or decreasing order.
+// Each chunk of 'block_size' consecutive rows is extracted with a contiguous block that covers the triangle for all rows in the chunk.
+// For the i-th row, we call 'fun(i, diag, for_each)' where 'diag' is the diagonal element
+// and 'for_each(inner)' calls 'inner(j, value)' for each off-diagonal element of the triangle in that row.
+template<bool sparse_, typename Value_, typename Index_, class Function_>
+void iterate_triangle(
+    const tatami::Matrix<Value_, Index_>& matrix,
+    const bool row,
+    const bool leading,
+    const Index_ first,
+    const Index_ last,
+    const bool descending,
+    const Index_ block_size,
+    Function_ fun
+) {
+    const Index_ N = matrix.nrow();
+    auto vbuffer = tatami::create_container_of_Index_size<std::vector<Value_> >(N);
+    auto ibuffer = tatami::create_container_of_Index_size<std::vector<Index_> >(sparse_ ? N : 0);
+
+    for (Index_ done = 0, total = last - first; done < total; ) {
+        const Index_ clength = std::min(total - done, block_size);
+        const Index_ cstart = (descending ? last - done - clength : first + done);
+        const Index_ cend = cstart + clength;
+        const Index_ bstart = (leading ? 0 : cstart);
+        const Index_ blength = (leading ? cend : N - cstart);
+
+        std::shared_ptr<const tatami::Oracle<Index_> > oracle;
+        if (descending) {
+            auto sequence = tatami::create_container_of_Index_size<std::vector<Index_> >(clength);
+            for (Index_ k = 0; k < clength; ++k) {
+                sequence[k] = cend - 1 - k;
+            }
+            oracle.reset(new tatami::FixedVectorOracle<Index_>(std::move(sequence)));
+        } else {
+            oracle.reset(new tatami::ConsecutiveOracle<Index_>(cstart, clength));
+        }
+        auto ext = tatami::new_extractor<sparse_, true>(matrix, row, std::move(oracle), bstart, blength);
+
+        for (Index_ k = 0; k < clength; ++k) {
+            const Index_ i = (descending ? cend - 1 - k : cstart + k);
+            if constexpr(sparse_) {
+                const auto range = ext->fetch(vbuffer.data(), ibuffer.data());
+                Value_ diag = 0;
+                for (Index_ x = 0; x < range.number; ++x) {
+                    if (range.index[x] == i) {
+                        diag = range.value[x];
+                    }
+                }
+                fun(i, diag, [&](auto inner) -> void {
+                    for (Index_ x = 0; x < range.number; ++x) {
+                        const Index_ j = range.index[x];
+                        if (leading ? j < i : j > i) {
+                            inner(j, range.value[x]);
+                        }
+                    }
+                });
+
+            } else {
+                const auto ptr = ext->fetch(vbuffer.data());
+                fun(i, ptr[i - bstart], [&](auto inner) -> void {
+                    if (leading) {
+                        for (Index_ j = 0; j < i; ++j) {
+                            inner(j, ptr[j]);
+                        }
+                    } else {
+                        for (Index_ j = i + 1; j < N; ++j) {
+                            inner(j, ptr[j - bstart]);
+                        }
+                    }
+                });
+            }
+        }
+
+        done += clength;
+    }
+}
+
 }
 
 #endif
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/async.hpp"
+
+class AsyncTest : public ::testing::TestWithParam<std::tuple<int, bool, int> > {
+protected:
+    inline static std::shared_ptr<const tatami::Matrix<double, int> > dense_row, dense_column, sparse_row, sparse_column;
+    inline static int NR = 61, NC = 35;
+
+    static void SetUpTestSuite() {
+        auto dump = tatami_test::simulate_vector<double>(NR * NC, []{
+            tatami_test::SimulateVectorOptions opt;
+            opt.density = 0.2;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 8888;
+            return opt;
+        }());
+        auto tmp = std::make_shared<tatami::DenseRowMatrix<double, int> >(NR, NC, std::move(dump));
+        dense_row = tmp;
+        dense_column = tatami::convert_to_dense(tmp.get(), false);
+        sparse_row = tatami::convert_to_compressed_sparse(tmp.get(), true);
+        sparse_column = tatami::convert_to_compressed_sparse(tmp.get(), false);
+    }
+};
+
+TEST_P(AsyncTest, Basic) {
+    const auto params = GetParam();
+    const int NRHS = std::get<0>(params);
+    const bool row_major = std::get<1>(params);
+    const int nthreads = std::get<2>(params);
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.3;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 9999 + NRHS + nthreads;
+        return opt;
+    }());
+    std::shared_ptr<const tatami::Matrix<double, int> > right_dense(new tatami::DenseRowMatrix<double, int>(NC, NRHS, std::move(rhs)));
+    std::shared_ptr<const tatami::Matrix<double, int> > right_sparse = tatami::convert_to_compressed_sparse(right_dense.get(), false);
+
+    tatami_mult::MultiplyWithMatrixOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+
+    for (const auto& left : { dense_row, dense_column, sparse_row, sparse_column }) {
+        for (const auto& right : { right_dense, right_sparse }) {
+            std::vector<double> ref(NR * NRHS);
+            tatami_mult::multiply_with_matrix(*left, *right, ref.data(), row_major, opt);
+
+            std::vector<double> output(NR * NRHS);
+            auto handle = tatami_mult::multiply_with_matrix_async(left, right, output.data(), row_major, opt);
+            handle.get();
+            EXPECT_EQ(handle.progress(), 1);
+            for (std::size_t i = 0; i < ref.size(); ++i) {
+                EXPECT_FLOAT_EQ(ref[i], output[i]);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Async,
+    AsyncTest,
+    ::testing::Combine(
+        ::testing::Values(10, 100), // number of RHS columns, to check that larger_left is respected.
+        ::testing::Values(true, false), // row-major output
+        ::testing::Values(1, 3) // number of threads
+    )
+);
+
+TEST(Async, Cancellation) {
+    const int NR = 10000, NC = 200, NRHS = 50;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.seed = 1111;
+        return opt;
+    }());
+    std::shared_ptr<const tatami::Matrix<double, int> > left(new tatami::DenseRowMatrix<double, int>(NR, NC, std::move(dump)));
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.seed = 2222;
+        return opt;
+    }());
+    std::shared_ptr<const tatami::Matrix<double, int> > right(new tatami::DenseColumnMatrix<double, int>(NC, NRHS, std::move(rhs)));
+
+    std::vector<double> output(NR * NRHS);
+    tatami_mult::MultiplyWithMatrixOptions opt;
+    tatami_mult::set_num_threads(opt, 2);
+
+    auto handle = tatami_mult::multiply_with_matrix_async(left, right, output.data(), false, opt);
+    handle.cancel();
+    EXPECT_THROW(handle.get(), tatami_mult::MultiplicationCancelled);
+    EXPECT_LT(handle.progress(), 1);
+    EXPECT_TRUE(handle.ready());
+
+    // Destruction of an unfinished handle cancels and waits for the threads.
+    {
+        auto handle2 = tatami_mult::multiply_with_matrix_async(left, right, output.data(), false, opt);
+    }
+
+    // Moved-from handles can still be queried and cancelled.
+    {
+        auto handle3 = tatami_mult::multiply_with_matrix_async(left, right, output.data(), false, opt);
+        auto moved = std::move(handle3);
+        handle3.cancel();
+        EXPECT_EQ(handle3.progress(), 1);
+        EXPECT_TRUE(handle3.ready());
+        moved.get();
+        EXPECT_EQ(moved.progress(), 1);
+    }
+}
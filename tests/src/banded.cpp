@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+#include "utils.h"
+
+class BandedTest : public ::testing::TestWithParam<std::tuple<std::pair<int, int>, std::pair<int, int>, int> > {
+protected:
+    static std::pair<tatami_mult::BandedMatrix<double, int>, std::shared_ptr<const tatami::Matrix<double, int> > > create_banded(int NR, int NC, int lower, int upper, int seed) {
+        const int width = lower + upper + 1;
+        auto values = tatami_test::simulate_vector<double>(NR * width, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = seed;
+            return opt;
+        }());
+
+        std::vector<double> dense(NR * NC);
+        for (int r = 0; r < NR; ++r) {
+            for (int k = 0; k < width; ++k) {
+                const int c = r - lower + k;
+                if (c >= 0 && c < NC) {
+                    dense[r * NC + c] = values[r * width + k];
+                }
+            }
+        }
+
+        return std::make_pair(
+            tatami_mult::BandedMatrix<double, int>(NR, NC, lower, upper, std::move(values)),
+            std::shared_ptr<const tatami::Matrix<double, int> >(new tatami::DenseRowMatrix<double, int>(NR, NC, std::move(dense)))
+        );
+    }
+
+};
+
+TEST_P(BandedTest, Vectors) {
+    const auto params = GetParam();
+    const auto dims = std::get<0>(params);
+    const auto bands = std::get<1>(params);
+    const int nthreads = std::get<2>(params);
+    const int NR = dims.first, NC = dims.second;
+
+    auto created = create_banded(NR, NC, bands.first, bands.second, 42 + NR + NC + bands.first + bands.second);
+    const auto& banded = created.first;
+    EXPECT_EQ(banded.nrow(), NR);
+    EXPECT_EQ(banded.ncol(), NC);
+    EXPECT_EQ(banded.lower_bandwidth(), bands.first);
+    EXPECT_EQ(banded.upper_bandwidth(), bands.second);
+
+    const int num_vectors = 3;
+    std::vector<std::vector<double> > rhs;
+    std::vector<const double*> rhs_ptrs;
+    for (int v = 0; v < num_vectors; ++v) {
+        rhs.push_back(tatami_test::simulate_vector<double>(NC, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 11 + NC + v;
+            return opt;
+        }()));
+        rhs_ptrs.push_back(rhs.back().data());
+    }
+
+    tatami_mult::MultiplyBandedOptions opt;
+    opt.num_threads = nthreads;
+    tatami_mult::MultiplyWithSingleVectorOptions ref_opt;
+
+    std::vector<std::vector<double> > outputs(num_vectors, std::vector<double>(NR, -1));
+    std::vector<double*> output_ptrs;
+    for (auto& o : outputs) {
+        output_ptrs.push_back(o.data());
+    }
+    tatami_mult::multiply_banded_with_multiple_vectors(banded, rhs_ptrs, output_ptrs, opt);
+
+    for (int v = 0; v < num_vectors; ++v) {
+        std::vector<double> ref(NR), output(NR, 99);
+        tatami_mult::multiply_with_single_vector(*(created.second), rhs[v].data(), ref.data(), ref_opt);
+        tatami_mult::multiply_banded_with_single_vector(banded, rhs[v].data(), output.data(), opt);
+        for (int r = 0; r < NR; ++r) {
+            EXPECT_FLOAT_EQ(ref[r], output[r]);
+            EXPECT_FLOAT_EQ(ref[r], outputs[v][r]);
+        }
+    }
+}
+
+TEST_P(BandedTest, Matrix) {
+    const auto params = GetParam();
+    const auto dims = std::get<0>(params);
+    const auto bands = std::get<1>(params);
+    const int nthreads = std::get<2>(params);
+    const int NR = dims.first, NC = dims.second;
+
+    auto created = create_banded(NR, NC, bands.first, bands.second, 24 + NR + NC + bands.first + bands.second);
+    const auto& banded = created.first;
+    const auto& ref_banded = *(created.second);
+
+    tatami_mult::MultiplyBandedOptions opt;
+    opt.num_threads = nthreads;
+    tatami_mult::MultiplyWithMatrixOptions ref_opt;
+    ref_opt.larger_left = false;
+
+    const int other_dim = 13;
+    for (bool row_major : { true, false }) {
+        for (const auto& right : create_test_matrices(NC, other_dim, 99 + NC)) {
+            std::vector<double> ref(NR * other_dim), output(NR * other_dim, -1);
+            tatami_mult::multiply_with_matrix(ref_banded, *right, ref.data(), row_major, ref_opt);
+            tatami_mult::multiply_banded_with_matrix(banded, *right, output.data(), row_major, opt);
+            for (std::size_t i = 0; i < ref.size(); ++i) {
+                EXPECT_FLOAT_EQ(ref[i], output[i]);
+            }
+        }
+
+        for (const auto& left : create_test_matrices(other_dim, NR, 77 + NR)) {
+            std::vector<double> ref(other_dim * NC), output(other_dim * NC, -1);
+            tatami_mult::multiply_with_matrix(*left, ref_banded, ref.data(), row_major, ref_opt);
+            tatami_mult::multiply_matrix_with_banded(*left, banded, output.data(), row_major, opt);
+            for (std::size_t i = 0; i < ref.size(); ++i) {
+                EXPECT_FLOAT_EQ(ref[i], output[i]);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Banded,
+    BandedTest,
+    ::testing::Combine(
+        ::testing::Values( // dimensions
+            std::make_pair(41, 41),
+            std::make_pair(57, 23),
+            std::make_pair(19, 44)
+        ),
+        ::testing::Values( // lower and upper bandwidths
+            std::make_pair(0, 0),
+            std::make_pair(1, 2),
+            std::make_pair(4, 0),
+            std::make_pair(0, 3),
+            std::make_pair(30, 50)
+        ),
+        ::testing::Values(1, 3) // number of threads
+    )
+);
+
+TEST(Banded, Diagonal) {
+    std::vector<double> diag{ 1.5, -2, 3, 0, 7 };
+    auto banded = tatami_mult::create_diagonal_matrix(diag);
+    EXPECT_EQ(banded.nrow(), 5);
+    EXPECT_EQ(banded.ncol(), 5);
+
+    tatami::DenseColumnMatrix<double, int> right(5, 2, std::vector<double>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 });
+    std::vector<double> output(10);
+    tatami_mult::multiply_banded_with_matrix(banded, right, output.data(), false, tatami_mult::MultiplyBandedOptions());
+    for (int r = 0; r < 5; ++r) {
+        EXPECT_FLOAT_EQ(output[r], diag[r] * (r + 1));
+        EXPECT_FLOAT_EQ(output[r + 5], diag[r] * (r + 6));
+    }
+
+    auto tbanded = banded.transpose();
+    EXPECT_EQ(tbanded.nrow(), 5);
+    EXPECT_EQ(tbanded.lower_bandwidth(), 0);
+    std::vector<double> ones(5, 1), dout(5);
+    tatami_mult::multiply_banded_with_single_vector(tbanded, ones.data(), dout.data(), tatami_mult::MultiplyBandedOptions());
+    EXPECT_EQ(dout, diag);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+class BidirectionalTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    inline static std::shared_ptr<const tatami::Matrix<double, int> > dense_row, dense_column, sparse_row, sparse_column;
+    inline static int NR = 69, NC = 47;
+
+    static void SetUpTestSuite() {
+        auto dump = tatami_test::simulate_vector<double>(NR * NC, []{
+            tatami_test::SimulateVectorOptions opt;
+            opt.density = 0.2;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 5151;
+            return opt;
+        }());
+        auto tmp = std::make_shared<tatami::DenseRowMatrix<double, int> >(NR, NC, std::move(dump));
+        dense_row = tmp;
+        dense_column = tatami::convert_to_dense(tmp.get(), false);
+        sparse_row = tatami::convert_to_compressed_sparse(tmp.get(), true);
+        sparse_column = tatami::convert_to_compressed_sparse(tmp.get(), false);
+    }
+};
+
+TEST_P(BidirectionalTest, Basic) {
+    const auto params = GetParam();
+    const int num_vectors = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+
+    auto right = tatami_test::simulate_vector<double>(NC * num_vectors, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 5252;
+        return opt;
+    }());
+    auto left = tatami_test::simulate_vector<double>(NR * num_vectors, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 5353;
+        return opt;
+    }());
+
+    tatami_mult::MultiplyWithSingleVectorOptions vopt;
+    tatami_mult::set_num_threads(vopt, nthreads);
+
+    for (const auto& mat : { dense_row, dense_column, sparse_row, sparse_column }) {
+        // Reference products, computed one vector at a time.
+        std::vector<double> ref_forward(NR * num_vectors), ref_transposed(NC * num_vectors);
+        auto tmat = tatami::make_DelayedTranspose(mat);
+        for (int v = 0; v < num_vectors; ++v) {
+            tatami_mult::multiply_with_single_vector(*mat, right.data() + v * NC, ref_forward.data() + v * NR, vopt);
+            tatami_mult::multiply_with_single_vector(*tmat, left.data() + v * NR, ref_transposed.data() + v * NC, vopt);
+        }
+
+        for (int sparse = 0; sparse < 3; ++sparse) {
+            tatami_mult::BidirectionalOperatorOptions opt;
+            tatami_mult::set_num_threads(opt, nthreads);
+            if (sparse < 2) {
+                opt.sparse = (sparse == 1);
+            }
+            tatami_mult::BidirectionalOperator<double, int> op(*mat, opt);
+            EXPECT_EQ(op.nrow(), NR);
+            EXPECT_EQ(op.ncol(), NC);
+            EXPECT_TRUE(op.forward()->prefer_rows());
+            EXPECT_TRUE(op.transposed()->prefer_rows());
+            EXPECT_EQ(op.forward()->is_sparse(), (sparse == 2 ? mat->is_sparse() : sparse == 1));
+
+            // Repeated calls to check that the workspaces are correctly reused.
+            for (int it = 0; it < 2; ++it) {
+                std::vector<double> forward(NR * num_vectors), transposed(NC * num_vectors);
+                op.apply(right.data(), num_vectors, forward.data());
+                op.apply_transpose(left.data(), num_vectors, transposed.data());
+                for (std::size_t i = 0; i < forward.size(); ++i) {
+                    EXPECT_FLOAT_EQ(ref_forward[i], forward[i]);
+                }
+                for (std::size_t i = 0; i < transposed.size(); ++i) {
+                    EXPECT_FLOAT_EQ(ref_transposed[i], transposed[i]);
+                }
+            }
+
+            std::vector<double> forward(NR), transposed(NC);
+            op.apply(right.data(), forward.data());
+            op.apply_transpose(left.data(), transposed.data());
+            for (int i = 0; i < NR; ++i) {
+                EXPECT_FLOAT_EQ(ref_forward[i], forward[i]);
+            }
+            for (int i = 0; i < NC; ++i) {
+                EXPECT_FLOAT_EQ(ref_transposed[i], transposed[i]);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Bidirectional,
+    BidirectionalTest,
+    ::testing::Combine(
+        ::testing::Values(1, 5), // number of vectors
+        ::testing::Values(1, 3) // number of threads
+    )
+);
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <vector>
+#include <cstdint>
 
 #include "tatami_test/tatami_test.hpp"
 
@@ -70,3 +72,21 @@ TEST(RecursiveSum, Basic) {
         EXPECT_EQ(tatami_mult::recursive_sum(sums), std::accumulate(sums.begin(), sums.end(), 0.0));
     }
 }
+
+TEST(DenseDotProduct, SmallIntegers) {
+    // Products of 16-bit values are accumulated exactly, even when the sum exceeds the range of a 32-bit integer.
+    const int N = 1000;
+    std::vector<uint16_t> left(N);
+    std::vector<int16_t> right(N);
+    std::int64_t ref = 0;
+    for (int i = 0; i < N; ++i) {
+        left[i] = 65535 - i;
+        right[i] = (i % 2 ? 32767 : -100) - i;
+        ref += static_cast<std::int64_t>(left[i]) * static_cast<std::int64_t>(right[i]);
+    }
+
+    EXPECT_EQ(tatami_mult::dense_dot_product<1>(N, left.data(), right.data(), static_cast<std::int64_t>(0)), ref);
+    EXPECT_EQ(tatami_mult::dense_dot_product<4>(N, left.data(), right.data(), static_cast<std::int64_t>(0)), ref);
+    EXPECT_EQ(tatami_mult::dense_dot_product<4>(N, left.data(), right.data(), 0.0), static_cast<double>(ref));
+    EXPECT_EQ(tatami_mult::dense_dot_product<4>(N, left.data(), right.data(), 10.0), static_cast<double>(ref) + 10);
+}
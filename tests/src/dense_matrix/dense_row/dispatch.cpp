@@ -59,6 +59,15 @@ TEST_P(DenseMatrixDenseRowTest, Basic) {
     tatami_mult::multiply_dense_row_with_dense_matrix(*dense_row, *right_row, dr_rr_ro.data(), true, opt);
     tatami_mult::multiply_dense_row_with_dense_matrix(*dense_row, *right_row, dr_rr_co.data(), false, opt);
 
+    // Checking that worker-local copies of the RHS give the same results.
+    {
+        auto ropt = opt;
+        ropt.row_to_row.replicate_right = true;
+        std::vector<double> replicated(output_size, 5.6);
+        tatami_mult::multiply_dense_row_with_dense_matrix(*dense_row, *right_row, replicated.data(), true, ropt);
+        EXPECT_EQ(replicated, dr_rr_ro);
+    }
+
     // Checking that it still works for column-major LHS.
     tatami_mult::multiply_dense_row_with_dense_matrix(*dense_col, *right_row, dc_rr_ro.data(), true, opt);
     tatami_mult::multiply_dense_row_with_dense_matrix(*dense_col, *right_col, dc_rc_ro.data(), true, opt);
@@ -71,6 +71,54 @@ TEST(DenseMatrixDispatch, Basic) {
     }
 }
 
+TEST(DenseMatrixDispatch, ParallelReduction) {
+    // Output is large enough that the reduction of the per-thread partial results is split across multiple workers.
+    const int NR = 150;
+    const int NC = 30;
+    const int NRHS = 130;
+
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.25;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 123 + NR + NC + NRHS; 
+        return opt;
+    }());
+    tatami::DenseRowMatrix<double, int> dense_row(NR, NC, dump);
+    auto dense_col = tatami::convert_to_dense<double, int>(dense_row, false, {});
+    auto sparse_col = tatami::convert_to_compressed_sparse<double, int>(dense_row, false, {});
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 321 + NR + NC + NRHS;
+        return opt;
+    }());
+    tatami::DenseColumnMatrix<double, int> right_col(NC, NRHS, rhs);
+
+    tatami_mult::MultiplyWithDenseMatrixOptions opt;
+    tatami_mult::set_num_threads(opt, 3);
+
+    const auto output_size = NR * NRHS;
+    for (bool row_major : { true, false }) {
+        std::vector<double> dc_out(output_size, 7.8), sc_out(output_size, 8.9);
+        tatami_mult::multiply_with_dense_matrix(*dense_col, right_col, dc_out.data(), row_major, opt);
+        tatami_mult::multiply_with_dense_matrix(*sparse_col, right_col, sc_out.data(), row_major, opt);
+
+        for (int h = 0; h < NRHS; ++h) {
+            const auto rptr = rhs.data() + h * NC;
+            for (int r = 0; r < NR; ++r) {
+                const auto ref = std::inner_product(rptr, rptr + NC, dump.begin() + r * NC, 0.0);
+                const auto idx = (row_major ? r * NRHS + h : h * NR + r);
+                EXPECT_FLOAT_EQ(ref, dc_out[idx]);
+                EXPECT_FLOAT_EQ(ref, sc_out[idx]);
+            }
+        }
+    }
+}
+
 TEST(DenseMatrixDispatch, Options) {
     tatami_mult::MultiplyWithDenseMatrixOptions opt;
     tatami_mult::set_num_threads(opt, 13);
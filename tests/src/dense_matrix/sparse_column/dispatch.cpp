@@ -197,6 +197,30 @@ TEST_P(DenseMatrixSparseColumnEmptyTest, Basic) {
     EXPECT_EQ(sc_rr_ro, fun_rr_ro);
     tatami_mult::multiply_sparse_column_with_dense_row_matrix_to_row_output(*sparse_row, NRHS, get_right, fun_rr_ro.data(), opt.row_to_row);
     EXPECT_EQ(sr_rr_ro, fun_rr_ro);
+
+    // Check that the pre-pass to skip empty LHS columns gives the same results.
+    for (bool prepass : { false, true }) {
+        auto popt = opt.row_to_column;
+        popt.prepass_non_empty = prepass;
+        std::vector<double> pre_rr_co(output_size, 6.6);
+        tatami_mult::multiply_sparse_column_with_dense_row_matrix_to_column_output(*sparse_col, *right_row, pre_rr_co.data(), popt);
+        EXPECT_EQ(sc_rr_co, pre_rr_co);
+        tatami_mult::multiply_sparse_column_with_dense_row_matrix_to_column_output(*sparse_row, *right_row, pre_rr_co.data(), popt);
+        EXPECT_EQ(sr_rr_co, pre_rr_co);
+    }
+
+    // Check that the pre-pass only requests and fetches the RHS rows for the non-empty LHS columns.
+    // This also checks that the pre-pass is used by default for an oracle-aware RHS.
+    {
+        FetchRecordingMatrix recorder(right_row);
+        std::vector<double> rec_rr_co(output_size, 6.6);
+        tatami_mult::multiply_sparse_column_with_dense_row_matrix_to_column_output(*sparse_col, recorder, rec_rr_co.data(), opt.row_to_column);
+        EXPECT_EQ(sc_rr_co, rec_rr_co);
+
+        const auto expected = find_non_empty_test_vectors(NR, NC, dump, false);
+        EXPECT_EQ(recorder.predicted(), expected);
+        EXPECT_EQ(recorder.fetched(), expected);
+    }
 }
 
 INSTANTIATE_TEST_SUITE_P(
@@ -61,6 +61,15 @@ TEST_P(DenseMatrixSparseRowTest, Basic) {
     tatami_mult::multiply_sparse_row_with_dense_matrix(*sparse_row, *right_row, sr_rr_ro.data(), true, opt);
     tatami_mult::multiply_sparse_row_with_dense_matrix(*sparse_row, *right_row, sr_rr_co.data(), false, opt);
 
+    // Checking that worker-local copies of the RHS give the same results.
+    {
+        auto ropt = opt;
+        ropt.row_to_row.replicate_right = true;
+        std::vector<double> replicated(output_size, 10.5);
+        tatami_mult::multiply_sparse_row_with_dense_matrix(*sparse_row, *right_row, replicated.data(), true, ropt);
+        EXPECT_EQ(replicated, sr_rr_ro);
+    }
+
     // Checking that it still works for column-major LHS.
     tatami_mult::multiply_sparse_row_with_dense_matrix(*sparse_col, *right_row, sc_rr_ro.data(), true, opt);
     tatami_mult::multiply_sparse_row_with_dense_matrix(*sparse_col, *right_col, sc_rc_ro.data(), true, opt);
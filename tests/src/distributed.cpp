@@ -0,0 +1,314 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <numeric>
+#include <atomic>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/distributed.hpp"
+
+// Simulating each rank with a separate thread.
+template<class Function_>
+static void run_ranks(int nranks, Function_ fun) {
+    auto comms = tatami_mult::create_local_communicators<double>(nranks);
+    std::vector<std::thread> workers;
+    for (int r = 0; r < nranks; ++r) {
+        workers.emplace_back([&,r]() -> void { fun(comms[r]); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+class DistributedTest : public ::testing::TestWithParam<std::tuple<int, int, bool> > {
+protected:
+    static std::vector<double> simulate(std::size_t n, int seed) {
+        return tatami_test::simulate_vector<double>(n, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.density = 0.4;
+            opt.seed = seed;
+            return opt;
+        }());
+    }
+
+    // Splitting a row-major matrix into row slices of (possibly) different sizes for each rank.
+    static std::vector<std::shared_ptr<const tatami::Matrix<double, int> > > split(const std::vector<double>& dump, int NC, const std::vector<int>& sizes, bool sparse) {
+        std::vector<std::shared_ptr<const tatami::Matrix<double, int> > > output;
+        std::size_t offset = 0;
+        for (auto s : sizes) {
+            std::vector<double> sub(dump.begin() + offset, dump.begin() + offset + s * NC);
+            offset += s * NC;
+            std::shared_ptr<const tatami::Matrix<double, int> > mat(new tatami::DenseRowMatrix<double, int>(s, NC, std::move(sub)));
+            if (sparse) {
+                mat = tatami::convert_to_compressed_sparse<double, int>(*mat, false, {});
+            }
+            output.push_back(std::move(mat));
+        }
+        return output;
+    }
+};
+
+TEST_P(DistributedTest, Transpose) {
+    const auto params = GetParam();
+    const int nranks = std::get<0>(params);
+    const int chunk_size = std::get<1>(params);
+    const bool sparse = std::get<2>(params);
+
+    std::vector<int> sizes;
+    for (int r = 0; r < nranks; ++r) {
+        sizes.push_back(5 + r * 7);
+    }
+    const int NR = std::accumulate(sizes.begin(), sizes.end(), 0);
+    const int NCA = 31, NCB = 17;
+
+    auto adump = simulate(NR * NCA, 99 + nranks + chunk_size);
+    auto bdump = simulate(NR * NCB, 88 + nranks + chunk_size);
+    auto aslices = split(adump, NCA, sizes, sparse);
+    auto bslices = split(bdump, NCB, sizes, false);
+
+    tatami::DenseRowMatrix<double, int> afull(NR, NCA, adump), bfull(NR, NCB, bdump);
+    auto tafull = tatami::make_DelayedTranspose(tatami::wrap_shared_ptr(static_cast<const tatami::Matrix<double, int>*>(&afull)));
+
+    tatami_mult::MultiplyDistributedOptions opt;
+    opt.chunk_size = chunk_size;
+
+    for (bool row_major : { true, false }) {
+        std::vector<double> ref(NCA * NCB);
+        tatami_mult::multiply_with_matrix(*tafull, bfull, ref.data(), row_major, tatami_mult::MultiplyWithMatrixOptions());
+
+        std::vector<std::vector<double> > outputs(nranks, std::vector<double>(NCA * NCB, -1));
+        run_ranks(nranks, [&](tatami_mult::LocalCommunicator<double>& comm) -> void {
+            const int r = comm.rank();
+            EXPECT_EQ(comm.size(), nranks);
+            tatami_mult::multiply_distributed_transpose_with_matrix(*(aslices[r]), *(bslices[r]), comm, outputs[r].data(), row_major, opt);
+        });
+
+        for (int r = 0; r < nranks; ++r) {
+            EXPECT_EQ(outputs[r], outputs[0]);
+        }
+        for (int i = 0; i < NCA * NCB; ++i) {
+            EXPECT_FLOAT_EQ(ref[i], outputs[0][i]);
+        }
+    }
+}
+
+TEST_P(DistributedTest, Gather) {
+    const auto params = GetParam();
+    const int nranks = std::get<0>(params);
+    const int chunk_size = std::get<1>(params);
+    const bool sparse = std::get<2>(params);
+
+    std::vector<int> sizes;
+    for (int r = 0; r < nranks; ++r) {
+        sizes.push_back(11 - r * 3);
+    }
+    const int NR = std::accumulate(sizes.begin(), sizes.end(), 0);
+    const int NC = 23, NRHS = 19;
+
+    auto adump = simulate(NR * NC, 77 + nranks + chunk_size);
+    auto bdump = simulate(NC * NRHS, 66 + nranks + chunk_size);
+    auto aslices = split(adump, NC, sizes, sparse);
+    tatami::DenseRowMatrix<double, int> afull(NR, NC, adump), right(NC, NRHS, bdump);
+
+    tatami_mult::MultiplyDistributedOptions opt;
+    opt.chunk_size = chunk_size;
+
+    // Using computed blocks that are smaller than, larger than, or not aligned with the all-gathered chunks.
+    for (int block_size : { 2, 7, 1000 }) {
+        opt.row_blocks.ordered_block_size = block_size;
+        for (bool row_major : { true, false }) {
+            std::vector<double> ref(NR * NRHS);
+            tatami_mult::multiply_with_matrix(afull, right, ref.data(), row_major, tatami_mult::MultiplyWithMatrixOptions());
+
+            std::vector<std::vector<double> > outputs(nranks, std::vector<double>(NR * NRHS, -1));
+            run_ranks(nranks, [&](tatami_mult::LocalCommunicator<double>& comm) -> void {
+                const int r = comm.rank();
+                tatami_mult::multiply_distributed_with_matrix(*(aslices[r]), right, comm, outputs[r].data(), row_major, opt);
+            });
+
+            for (int r = 0; r < nranks; ++r) {
+                EXPECT_EQ(outputs[r], outputs[0]);
+            }
+            for (int i = 0; i < NR * NRHS; ++i) {
+                EXPECT_FLOAT_EQ(ref[i], outputs[0][i]);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Distributed,
+    DistributedTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 3), // number of ranks
+        ::testing::Values(1, 5, 64), // chunk size
+        ::testing::Values(false, true) // sparse LHS
+    )
+);
+
+// Wrapper that counts the number of rows and columns fetched from the underlying matrix.
+class CountingMatrix final : public tatami::Matrix<double, int> {
+public:
+    CountingMatrix(std::shared_ptr<const tatami::Matrix<double, int> > inner) : my_inner(std::move(inner)) {}
+
+    mutable std::atomic<int> row_fetches{0}, column_fetches{0};
+
+    double passes() const {
+        return static_cast<double>(row_fetches) / my_inner->nrow() + static_cast<double>(column_fetches) / my_inner->ncol();
+    }
+
+private:
+    std::shared_ptr<const tatami::Matrix<double, int> > my_inner;
+
+    template<class Base_>
+    struct Dense final : public Base_ {
+        Dense(std::unique_ptr<Base_> inner, std::atomic<int>& counter) : inner(std::move(inner)), counter(counter) {}
+        std::unique_ptr<Base_> inner;
+        std::atomic<int>& counter;
+        const double* fetch(int i, double* buffer) {
+            ++counter;
+            return inner->fetch(i, buffer);
+        }
+    };
+
+    template<class Base_>
+    struct Sparse final : public Base_ {
+        Sparse(std::unique_ptr<Base_> inner, std::atomic<int>& counter) : inner(std::move(inner)), counter(counter) {}
+        std::unique_ptr<Base_> inner;
+        std::atomic<int>& counter;
+        tatami::SparseRange<double, int> fetch(int i, double* vbuffer, int* ibuffer) {
+            ++counter;
+            return inner->fetch(i, vbuffer, ibuffer);
+        }
+    };
+
+    std::atomic<int>& counter(bool row) const {
+        return (row ? row_fetches : column_fetches);
+    }
+
+    template<class Base_>
+    std::unique_ptr<Base_> wrap_dense(bool row, std::unique_ptr<Base_> inner) const {
+        return std::make_unique<Dense<Base_> >(std::move(inner), counter(row));
+    }
+
+    template<class Base_>
+    std::unique_ptr<Base_> wrap_sparse(bool row, std::unique_ptr<Base_> inner) const {
+        return std::make_unique<Sparse<Base_> >(std::move(inner), counter(row));
+    }
+
+    typedef tatami::MyopicDenseExtractor<double, int> MDense;
+    typedef tatami::OracularDenseExtractor<double, int> ODense;
+    typedef tatami::MyopicSparseExtractor<double, int> MSparse;
+    typedef tatami::OracularSparseExtractor<double, int> OSparse;
+    typedef std::shared_ptr<const tatami::Oracle<int> > OraclePtr;
+
+public:
+    int nrow() const { return my_inner->nrow(); }
+    int ncol() const { return my_inner->ncol(); }
+    bool is_sparse() const { return my_inner->is_sparse(); }
+    double is_sparse_proportion() const { return my_inner->is_sparse_proportion(); }
+    bool prefer_rows() const { return my_inner->prefer_rows(); }
+    double prefer_rows_proportion() const { return my_inner->prefer_rows_proportion(); }
+    bool uses_oracle(bool row) const { return my_inner->uses_oracle(row); }
+
+    std::unique_ptr<MDense> dense(bool row, const tatami::Options& opt) const {
+        return wrap_dense(row, my_inner->dense(row, opt));
+    }
+    std::unique_ptr<MDense> dense(bool row, int bs, int bl, const tatami::Options& opt) const {
+        return wrap_dense(row, my_inner->dense(row, bs, bl, opt));
+    }
+    std::unique_ptr<MDense> dense(bool row, tatami::VectorPtr<int> idx, const tatami::Options& opt) const {
+        return wrap_dense(row, my_inner->dense(row, std::move(idx), opt));
+    }
+    std::unique_ptr<MSparse> sparse(bool row, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_inner->sparse(row, opt));
+    }
+    std::unique_ptr<MSparse> sparse(bool row, int bs, int bl, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_inner->sparse(row, bs, bl, opt));
+    }
+    std::unique_ptr<MSparse> sparse(bool row, tatami::VectorPtr<int> idx, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_inner->sparse(row, std::move(idx), opt));
+    }
+
+    std::unique_ptr<ODense> dense(bool row, OraclePtr o, const tatami::Options& opt) const {
+        return wrap_dense(row, my_inner->dense(row, std::move(o), opt));
+    }
+    std::unique_ptr<ODense> dense(bool row, OraclePtr o, int bs, int bl, const tatami::Options& opt) const {
+        return wrap_dense(row, my_inner->dense(row, std::move(o), bs, bl, opt));
+    }
+    std::unique_ptr<ODense> dense(bool row, OraclePtr o, tatami::VectorPtr<int> idx, const tatami::Options& opt) const {
+        return wrap_dense(row, my_inner->dense(row, std::move(o), std::move(idx), opt));
+    }
+    std::unique_ptr<OSparse> sparse(bool row, OraclePtr o, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_inner->sparse(row, std::move(o), opt));
+    }
+    std::unique_ptr<OSparse> sparse(bool row, OraclePtr o, int bs, int bl, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_inner->sparse(row, std::move(o), bs, bl, opt));
+    }
+    std::unique_ptr<OSparse> sparse(bool row, OraclePtr o, tatami::VectorPtr<int> idx, const tatami::Options& opt) const {
+        return wrap_sparse(row, my_inner->sparse(row, std::move(o), std::move(idx), opt));
+    }
+};
+
+TEST(Distributed, SinglePass) {
+    // Each process should only make a single pass through its slices, regardless of the chunk size.
+    const int nranks = 2, NR = 13, NCA = 29, NCB = 11;
+    auto adump = tatami_test::simulate_vector<double>(NR * NCA, tatami_test::SimulateVectorOptions());
+    auto bdump = tatami_test::simulate_vector<double>(NR * NCB, tatami_test::SimulateVectorOptions());
+    auto rdump = tatami_test::simulate_vector<double>(NCA * NCB, tatami_test::SimulateVectorOptions());
+
+    tatami_mult::MultiplyDistributedOptions opt;
+    opt.chunk_size = 3;
+
+    for (bool sparse : { false, true }) {
+        std::vector<std::shared_ptr<CountingMatrix> > lefts, rights;
+        std::shared_ptr<const tatami::Matrix<double, int> > full_right(new tatami::DenseRowMatrix<double, int>(NCA, NCB, rdump));
+        std::vector<std::shared_ptr<CountingMatrix> > full_rights;
+        for (int r = 0; r < nranks; ++r) {
+            std::shared_ptr<const tatami::Matrix<double, int> > lmat(new tatami::DenseRowMatrix<double, int>(NR, NCA, adump));
+            if (sparse) {
+                lmat = tatami::convert_to_compressed_sparse<double, int>(*lmat, true, {});
+            }
+            lefts.push_back(std::make_shared<CountingMatrix>(std::move(lmat)));
+            rights.push_back(std::make_shared<CountingMatrix>(std::shared_ptr<const tatami::Matrix<double, int> >(new tatami::DenseRowMatrix<double, int>(NR, NCB, bdump))));
+            full_rights.push_back(std::make_shared<CountingMatrix>(full_right));
+        }
+
+        for (bool row_major : { true, false }) {
+            std::vector<std::vector<double> > outputs(nranks, std::vector<double>(NCA * NCB));
+            run_ranks(nranks, [&](tatami_mult::LocalCommunicator<double>& comm) -> void {
+                const int r = comm.rank();
+                lefts[r]->row_fetches = 0;
+                lefts[r]->column_fetches = 0;
+                rights[r]->row_fetches = 0;
+                rights[r]->column_fetches = 0;
+                tatami_mult::multiply_distributed_transpose_with_matrix(*(lefts[r]), *(rights[r]), comm, outputs[r].data(), row_major, opt);
+            });
+            for (int r = 0; r < nranks; ++r) {
+                EXPECT_EQ(lefts[r]->passes(), 1);
+                EXPECT_EQ(rights[r]->passes(), 1);
+            }
+
+            outputs.clear();
+            outputs.resize(nranks, std::vector<double>(NR * nranks * NCB));
+            run_ranks(nranks, [&](tatami_mult::LocalCommunicator<double>& comm) -> void {
+                const int r = comm.rank();
+                lefts[r]->row_fetches = 0;
+                lefts[r]->column_fetches = 0;
+                full_rights[r]->row_fetches = 0;
+                full_rights[r]->column_fetches = 0;
+                tatami_mult::multiply_distributed_with_matrix(*(lefts[r]), *(full_rights[r]), comm, outputs[r].data(), row_major, opt);
+            });
+            for (int r = 0; r < nranks; ++r) {
+                EXPECT_EQ(lefts[r]->passes(), 1);
+                EXPECT_EQ(full_rights[r]->passes(), 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <cmath>
+#include <limits>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/epilogue.hpp"
+
+class EpilogueTest : public ::testing::TestWithParam<std::tuple<double, double, int> > {
+protected:
+    inline static int NR = 57, NC = 38, NRHS = 11;
+    inline static std::vector<double> dump, rhs, existing;
+    inline static std::shared_ptr<tatami::Matrix<double, int> > dense_row, dense_column, sparse_row, sparse_column;
+    inline static std::shared_ptr<tatami::Matrix<double, int> > right_dense, right_sparse;
+
+    static void SetUpTestSuite() {
+        dump = tatami_test::simulate_vector<double>(NR * NC, []{
+            tatami_test::SimulateVectorOptions opt;
+            opt.density = 0.2;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 420;
+            return opt;
+        }());
+        dense_row.reset(new tatami::DenseRowMatrix<double, int>(NR, NC, dump));
+        dense_column = tatami::convert_to_dense(dense_row.get(), false);
+        sparse_row = tatami::convert_to_compressed_sparse(dense_row.get(), true);
+        sparse_column = tatami::convert_to_compressed_sparse(dense_row.get(), false);
+
+        rhs = tatami_test::simulate_vector<double>(NC * NRHS, []{
+            tatami_test::SimulateVectorOptions opt;
+            opt.density = 0.5;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 421;
+            return opt;
+        }());
+        right_dense.reset(new tatami::DenseColumnMatrix<double, int>(NC, NRHS, rhs));
+        right_sparse = tatami::convert_to_compressed_sparse(right_dense.get(), true);
+
+        existing = tatami_test::simulate_vector<double>(NR * NRHS, []{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 422;
+            return opt;
+        }());
+    }
+
+    // Reference for the product in column-major format.
+    static double reference(int r, int h) {
+        double ref = 0;
+        for (int c = 0; c < NC; ++c) {
+            ref += dump[r * NC + c] * rhs[h * NC + c];
+        }
+        return ref;
+    }
+
+    static double expected(double alpha, double beta, int r, int h, double old) {
+        const double val = alpha * reference(r, h) + beta * old;
+        return val * 2 + r;
+    }
+};
+
+TEST_P(EpilogueTest, SingleVector) {
+    const auto params = GetParam();
+    const double alpha = std::get<0>(params);
+    const double beta = std::get<1>(params);
+
+    tatami_mult::MultiplyWithSingleVectorAndUpdateOptions opt;
+    opt.alpha = alpha;
+    opt.beta = beta;
+    tatami_mult::set_num_threads(opt, std::get<2>(params));
+
+    for (const auto& mat : { dense_row, dense_column, sparse_row, sparse_column }) {
+        std::vector<double> output(existing.begin(), existing.begin() + NR);
+        if (beta == 0) {
+            output[0] = std::numeric_limits<double>::quiet_NaN(); // check that it is ignored.
+        }
+        tatami_mult::multiply_with_single_vector_and_update(*mat, rhs.data(), output.data(), [](int r, double x) -> double { return x * 2 + r; }, opt);
+        for (int r = 0; r < NR; ++r) {
+            EXPECT_FLOAT_EQ(output[r], expected(alpha, beta, r, 0, existing[r]));
+        }
+    }
+}
+
+TEST_P(EpilogueTest, MultipleVectors) {
+    const auto params = GetParam();
+    const double alpha = std::get<0>(params);
+    const double beta = std::get<1>(params);
+
+    tatami_mult::MultiplyWithMultipleVectorsAndUpdateOptions opt;
+    opt.alpha = alpha;
+    opt.beta = beta;
+    tatami_mult::set_num_threads(opt, std::get<2>(params));
+
+    std::vector<const double*> rhs_ptrs;
+    for (int h = 0; h < NRHS; ++h) {
+        rhs_ptrs.push_back(rhs.data() + h * NC);
+    }
+
+    for (const auto& mat : { dense_row, dense_column, sparse_row, sparse_column }) {
+        auto output = existing;
+        std::vector<double*> out_ptrs;
+        for (int h = 0; h < NRHS; ++h) {
+            out_ptrs.push_back(output.data() + h * NR);
+        }
+
+        tatami_mult::multiply_with_multiple_vectors_and_update(
+            *mat,
+            rhs_ptrs,
+            out_ptrs,
+            [](std::size_t, int r, double x) -> double { return x * 2 + r; },
+            opt
+        );
+
+        for (int h = 0; h < NRHS; ++h) {
+            for (int r = 0; r < NR; ++r) {
+                EXPECT_FLOAT_EQ(output[h * NR + r], expected(alpha, beta, r, h, existing[h * NR + r]));
+            }
+        }
+    }
+}
+
+TEST_P(EpilogueTest, Matrix) {
+    const auto params = GetParam();
+    const double alpha = std::get<0>(params);
+    const double beta = std::get<1>(params);
+
+    tatami_mult::MultiplyWithMatrixAndUpdateOptions opt;
+    opt.alpha = alpha;
+    opt.beta = beta;
+    tatami_mult::set_num_threads(opt, std::get<2>(params));
+
+    for (const auto& mat : { dense_row, dense_column, sparse_row, sparse_column }) {
+        for (const auto& right : { right_dense, right_sparse }) {
+            // Column-major output.
+            {
+                auto output = existing;
+                tatami_mult::multiply_with_matrix_and_update(*mat, *right, output.data(), false, [](int r, int, double x) -> double { return x * 2 + r; }, opt);
+                for (int h = 0; h < NRHS; ++h) {
+                    for (int r = 0; r < NR; ++r) {
+                        EXPECT_FLOAT_EQ(output[h * NR + r], expected(alpha, beta, r, h, existing[h * NR + r]));
+                    }
+                }
+            }
+
+            // Row-major output.
+            {
+                auto output = existing;
+                tatami_mult::multiply_with_matrix_and_update(*mat, *right, output.data(), true, [](int r, int, double x) -> double { return x * 2 + r; }, opt);
+                for (int h = 0; h < NRHS; ++h) {
+                    for (int r = 0; r < NR; ++r) {
+                        EXPECT_FLOAT_EQ(output[r * NRHS + h], expected(alpha, beta, r, h, existing[r * NRHS + h]));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_P(EpilogueTest, NoEpilogue) {
+    const auto params = GetParam();
+    const double alpha = std::get<0>(params);
+    const double beta = std::get<1>(params);
+    const int nthreads = std::get<2>(params);
+
+    auto expected_no_epilogue = [&](int r, int h, double old) -> double {
+        return alpha * reference(r, h) + beta * old;
+    };
+
+    tatami_mult::MultiplyWithSingleVectorAndUpdateOptions sopt;
+    sopt.alpha = alpha;
+    sopt.beta = beta;
+    tatami_mult::set_num_threads(sopt, nthreads);
+
+    tatami_mult::MultiplyWithMultipleVectorsAndUpdateOptions vopt;
+    vopt.alpha = alpha;
+    vopt.beta = beta;
+    tatami_mult::set_num_threads(vopt, nthreads);
+
+    tatami_mult::MultiplyWithMatrixAndUpdateOptions mopt;
+    mopt.alpha = alpha;
+    mopt.beta = beta;
+    tatami_mult::set_num_threads(mopt, nthreads);
+
+    std::vector<const double*> rhs_ptrs;
+    for (int h = 0; h < NRHS; ++h) {
+        rhs_ptrs.push_back(rhs.data() + h * NC);
+    }
+
+    for (const auto& mat : { dense_row, dense_column, sparse_row, sparse_column }) {
+        std::vector<double> single(existing.begin(), existing.begin() + NR);
+        tatami_mult::multiply_with_single_vector_and_update(*mat, rhs.data(), single.data(), sopt);
+        for (int r = 0; r < NR; ++r) {
+            EXPECT_FLOAT_EQ(single[r], expected_no_epilogue(r, 0, existing[r]));
+        }
+
+        auto multiple = existing;
+        std::vector<double*> out_ptrs;
+        for (int h = 0; h < NRHS; ++h) {
+            out_ptrs.push_back(multiple.data() + h * NR);
+        }
+        tatami_mult::multiply_with_multiple_vectors_and_update(*mat, rhs_ptrs, out_ptrs, vopt);
+        for (int h = 0; h < NRHS; ++h) {
+            for (int r = 0; r < NR; ++r) {
+                EXPECT_FLOAT_EQ(multiple[h * NR + r], expected_no_epilogue(r, h, existing[h * NR + r]));
+            }
+        }
+
+        for (const auto& right : { right_dense, right_sparse }) {
+            auto output = existing;
+            tatami_mult::multiply_with_matrix_and_update(*mat, *right, output.data(), false, mopt);
+            for (int h = 0; h < NRHS; ++h) {
+                for (int r = 0; r < NR; ++r) {
+                    EXPECT_FLOAT_EQ(output[h * NR + r], expected_no_epilogue(r, h, existing[h * NR + r]));
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Epilogue,
+    EpilogueTest,
+    ::testing::Combine(
+        ::testing::Values(1.0, 2.5),  // alpha
+        ::testing::Values(0.0, -0.5, 1.0), // beta
+        ::testing::Values(1, 3)       // number of threads
+    )
+);
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/incremental.hpp"
+
+#include "utils.h"
+
+class IncrementalTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    static std::vector<std::vector<double> > create_vectors(int len, int num_vectors, int seed) {
+        std::vector<std::vector<double> > output;
+        for (int v = 0; v < num_vectors; ++v) {
+            output.push_back(tatami_test::simulate_vector<double>(len, [&]{
+                tatami_test::SimulateVectorOptions opt;
+                opt.lower = -10;
+                opt.upper = 10;
+                opt.seed = seed + v;
+                return opt;
+            }()));
+        }
+        return output;
+    }
+
+    template<typename Value_>
+    static std::vector<Value_*> get_pointers(std::vector<std::vector<double> >& vectors, int offset) {
+        std::vector<Value_*> ptrs;
+        for (auto& v : vectors) {
+            ptrs.push_back(v.data() + offset);
+        }
+        return ptrs;
+    }
+};
+
+TEST_P(IncrementalTest, AppendedRows) {
+    const auto params = GetParam();
+    const int previous = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+    const int NR = 53, NC = 31, NRHS = 17, num_vectors = 3;
+
+    auto lefts = create_test_matrices(NR, NC, 10 + previous);
+    auto rights = create_test_matrices(NC, NRHS, 20 + previous);
+    auto rhs = create_vectors(NC, num_vectors, 30 + previous);
+
+    tatami_mult::MultiplyWithMatrixOptions mopt;
+    tatami_mult::set_num_threads(mopt, nthreads);
+    tatami_mult::MultiplyWithMultipleVectorsOptions vopt;
+    tatami_mult::set_num_threads(vopt, nthreads);
+
+    for (const auto& left : lefts) {
+        auto old_rows = tatami::make_DelayedSubsetBlock<double, int>(left, 0, previous, true);
+        auto new_rows = tatami::make_DelayedSubsetBlock<double, int>(left, previous, NR - previous, true);
+
+        for (bool row_major : { true, false }) {
+            for (const auto& right : rights) {
+                std::vector<double> ref(NR * NRHS);
+                tatami_mult::multiply_with_matrix(*left, *right, ref.data(), row_major, mopt);
+
+                std::vector<double> output(previous * NRHS);
+                tatami_mult::multiply_with_matrix(*old_rows, *right, output.data(), row_major, mopt);
+                output.resize(NR * NRHS);
+                tatami_mult::update_product_for_appended_rows(*new_rows, previous, *right, output.data(), row_major, mopt);
+                for (int i = 0; i < NR * NRHS; ++i) {
+                    EXPECT_FLOAT_EQ(ref[i], output[i]);
+                }
+            }
+        }
+
+        std::vector<std::vector<double> > ref(num_vectors, std::vector<double>(NR));
+        tatami_mult::multiply_with_multiple_vectors(*left, get_pointers<const double>(rhs, 0), get_pointers<double>(ref, 0), vopt);
+
+        std::vector<std::vector<double> > output(num_vectors, std::vector<double>(previous));
+        tatami_mult::multiply_with_multiple_vectors(*old_rows, get_pointers<const double>(rhs, 0), get_pointers<double>(output, 0), vopt);
+        for (auto& o : output) {
+            o.resize(NR);
+        }
+        tatami_mult::update_product_for_appended_rows(*new_rows, previous, get_pointers<const double>(rhs, 0), get_pointers<double>(output, 0), vopt);
+        for (int v = 0; v < num_vectors; ++v) {
+            for (int r = 0; r < NR; ++r) {
+                EXPECT_FLOAT_EQ(ref[v][r], output[v][r]);
+            }
+        }
+    }
+}
+
+TEST_P(IncrementalTest, AppendedColumns) {
+    const auto params = GetParam();
+    const int previous = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+    const int NR = 29, NC = 53, NRHS = 17, num_vectors = 3;
+
+    auto lefts = create_test_matrices(NR, NC, 40 + previous);
+    auto rights = create_test_matrices(NC, NRHS, 50 + previous);
+    auto rhs = create_vectors(NC, num_vectors, 60 + previous);
+
+    tatami_mult::MultiplyWithMatrixOptions mopt;
+    tatami_mult::set_num_threads(mopt, nthreads);
+    tatami_mult::MultiplyPartialWithMatrixOptions popt;
+    tatami_mult::set_num_threads(popt, nthreads);
+    tatami_mult::MultiplyWithMultipleVectorsOptions vopt;
+    tatami_mult::set_num_threads(vopt, nthreads);
+
+    for (const auto& left : lefts) {
+        auto old_columns = tatami::make_DelayedSubsetBlock<double, int>(left, 0, previous, false);
+        auto new_columns = tatami::make_DelayedSubsetBlock<double, int>(left, previous, NC - previous, false);
+
+        for (bool row_major : { true, false }) {
+            for (const auto& right : rights) {
+                auto old_right_rows = tatami::make_DelayedSubsetBlock<double, int>(right, 0, previous, true);
+                auto new_right_rows = tatami::make_DelayedSubsetBlock<double, int>(right, previous, NC - previous, true);
+
+                std::vector<double> ref(NR * NRHS);
+                tatami_mult::multiply_with_matrix(*left, *right, ref.data(), row_major, mopt);
+
+                std::vector<double> output(NR * NRHS);
+                tatami_mult::multiply_with_matrix(*old_columns, *old_right_rows, output.data(), row_major, mopt);
+                tatami_mult::update_product_for_appended_columns(*new_columns, *new_right_rows, output.data(), row_major, popt);
+                for (int i = 0; i < NR * NRHS; ++i) {
+                    EXPECT_FLOAT_EQ(ref[i], output[i]);
+                }
+            }
+        }
+
+        std::vector<std::vector<double> > ref(num_vectors, std::vector<double>(NR));
+        tatami_mult::multiply_with_multiple_vectors(*left, get_pointers<const double>(rhs, 0), get_pointers<double>(ref, 0), vopt);
+
+        std::vector<std::vector<double> > output(num_vectors, std::vector<double>(NR));
+        tatami_mult::multiply_with_multiple_vectors(*old_columns, get_pointers<const double>(rhs, 0), get_pointers<double>(output, 0), vopt);
+        tatami_mult::update_product_for_appended_columns(*new_columns, get_pointers<const double>(rhs, previous), get_pointers<double>(output, 0), vopt);
+        for (int v = 0; v < num_vectors; ++v) {
+            for (int r = 0; r < NR; ++r) {
+                EXPECT_FLOAT_EQ(ref[v][r], output[v][r]);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Incremental,
+    IncrementalTest,
+    ::testing::Combine(
+        ::testing::Values(0, 1, 20, 29), // number of previous rows or columns
+        ::testing::Values(1, 3) // number of threads
+    )
+);
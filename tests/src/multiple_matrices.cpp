@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+class MultipleMatricesTest : public ::testing::TestWithParam<std::tuple<bool, int> > {
+protected:
+    inline static std::shared_ptr<const tatami::Matrix<double, int> > dense_row, dense_column, sparse_row, sparse_column;
+    inline static int NR = 57, NC = 39;
+
+    static void SetUpTestSuite() {
+        auto dump = tatami_test::simulate_vector<double>(NR * NC, []{
+            tatami_test::SimulateVectorOptions opt;
+            opt.density = 0.2;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 4242;
+            return opt;
+        }());
+        auto tmp = std::make_shared<tatami::DenseRowMatrix<double, int> >(NR, NC, std::move(dump));
+        dense_row = tmp;
+        dense_column = tatami::convert_to_dense(tmp.get(), false);
+        sparse_row = tatami::convert_to_compressed_sparse(tmp.get(), true);
+        sparse_column = tatami::convert_to_compressed_sparse(tmp.get(), false);
+    }
+
+    static std::shared_ptr<const tatami::Matrix<double, int> > create_right(int ncol, double density, bool sparse, int seed) {
+        auto rhs = tatami_test::simulate_vector<double>(NC * ncol, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.density = density;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = seed;
+            return opt;
+        }());
+        std::shared_ptr<const tatami::Matrix<double, int> > dense(new tatami::DenseColumnMatrix<double, int>(NC, ncol, std::move(rhs)));
+        if (sparse) {
+            return tatami::convert_to_compressed_sparse(dense.get(), true);
+        }
+        return dense;
+    }
+};
+
+TEST_P(MultipleMatricesTest, Basic) {
+    const auto params = GetParam();
+    const bool row_major = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+
+    tatami_mult::MultiplyWithMultipleMatricesOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+    tatami_mult::MultiplyWithMatrixOptions ref_opt;
+    tatami_mult::set_num_threads(ref_opt, nthreads);
+
+    // Mixing sparse and dense RHS matrices with different numbers of columns, including an empty one.
+    std::vector<std::vector<std::shared_ptr<const tatami::Matrix<double, int> > > > scenarios;
+    scenarios.push_back({ create_right(5, 1, false, 100), create_right(11, 1, false, 101) });
+    scenarios.push_back({ create_right(7, 0.1, true, 200), create_right(3, 0.2, true, 201), create_right(9, 0.05, true, 202) });
+    scenarios.push_back({ create_right(4, 1, false, 300), create_right(0, 0.1, true, 301), create_right(6, 0.1, true, 302) });
+
+    for (const auto& left : { dense_row, dense_column, sparse_row, sparse_column }) {
+        for (const auto& right : scenarios) {
+            const auto num_right = right.size();
+            std::vector<std::vector<double> > output(num_right);
+            std::vector<double*> output_ptrs;
+            for (std::size_t j = 0; j < num_right; ++j) {
+                output[j].resize(NR * right[j]->ncol());
+                output_ptrs.push_back(output[j].data());
+            }
+            tatami_mult::multiply_with_multiple_matrices(*left, right, output_ptrs, row_major, opt);
+
+            for (std::size_t j = 0; j < num_right; ++j) {
+                std::vector<double> ref(NR * right[j]->ncol());
+                tatami_mult::multiply_with_matrix(*left, *(right[j]), ref.data(), row_major, ref_opt);
+                ASSERT_EQ(ref.size(), output[j].size());
+                for (std::size_t i = 0; i < ref.size(); ++i) {
+                    EXPECT_FLOAT_EQ(ref[i], output[j][i]);
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    MultipleMatrices,
+    MultipleMatricesTest,
+    ::testing::Combine(
+        ::testing::Values(true, false), // row-major output
+        ::testing::Values(1, 3) // number of threads
+    )
+);
+
+TEST(MultipleMatrices, Empty) {
+    tatami::DenseRowMatrix<double, int> left(5, 4, std::vector<double>(20));
+    std::vector<std::shared_ptr<const tatami::Matrix<double, int> > > right;
+    tatami_mult::MultiplyWithMultipleMatricesOptions opt;
+    tatami_mult::multiply_with_multiple_matrices(left, right, std::vector<double*>{}, true, opt);
+}
@@ -84,3 +84,40 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::Values(1, 3)
     )
 );
+
+TEST(MultipleVectorsDenseColumn, LargeReduction) {
+    // Checking that the parallel reduction of the per-thread outputs handles slices that span multiple output vectors.
+    const int NR = 3001, NC = 20, NRHS = 7;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, tatami_test::SimulateVectorOptions());
+    tatami::DenseColumnMatrix<double, int> mat(NR, NC, [&]{
+        std::vector<double> transposed(NR * NC);
+        for (int r = 0; r < NR; ++r) {
+            for (int c = 0; c < NC; ++c) {
+                transposed[c * NR + r] = dump[r * NC + c];
+            }
+        }
+        return transposed;
+    }());
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, tatami_test::SimulateVectorOptions());
+
+    std::vector<double*> rhs_ptrs(NRHS);
+    for (int h = 0; h < NRHS; ++h) {
+        rhs_ptrs[h] = rhs.data() + h * NC;
+    }
+
+    tatami_mult::MultiplyDenseColumnWithMultipleVectorsOptions opt;
+    opt.num_threads = 3;
+    std::vector<std::vector<double> > output(NRHS, std::vector<double>(NR));
+    std::vector<double*> output_ptrs;
+    for (auto& o : output) {
+        output_ptrs.push_back(o.data());
+    }
+    tatami_mult::multiply_dense_column_with_multiple_vectors(mat, rhs_ptrs, output_ptrs, opt);
+
+    for (int h = 0; h < NRHS; ++h) {
+        for (int r = 0; r < NR; ++r) {
+            const auto ref = std::inner_product(rhs_ptrs[h], rhs_ptrs[h] + NC, dump.begin() + r * NC, 0.0);
+            EXPECT_FLOAT_EQ(ref, output[h][r]);
+        }
+    }
+}
@@ -88,3 +88,61 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::Values(1, 3)
     )
 );
+
+TEST(MultipleVectorsDenseRow, SmallIntegers) {
+    const int NR = 45, NC = 81, NRHS = 7;
+    std::vector<uint16_t> counts(NR * NC);
+    for (int i = 0; i < NR * NC; ++i) {
+        counts[i] = (i * 7919) % 1000;
+    }
+    tatami::DenseRowMatrix<uint16_t, int> mat(NR, NC, counts);
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 9191;
+        return opt;
+    }());
+    std::vector<double*> rhs_ptrs(NRHS);
+    std::vector<std::vector<uint16_t> > irhs(NRHS);
+    std::vector<uint16_t*> irhs_ptrs(NRHS);
+    for (int h = 0; h < NRHS; ++h) {
+        rhs_ptrs[h] = rhs.data() + h * NC;
+        for (int c = 0; c < NC; ++c) {
+            irhs[h].push_back(c * (h + 1));
+        }
+        irhs_ptrs[h] = irhs[h].data();
+    }
+
+    // Checking that the bulk conversion of the LHS and the integer accumulation both give the correct results.
+    for (const auto& blocks : { std::make_pair(1, 0), std::make_pair(4, 16) }) {
+        for (int nthreads : { 1, 3 }) {
+            tatami_mult::MultiplyDenseRowWithMultipleVectorsOptions opt;
+            opt.num_threads = nthreads;
+            opt.primary_block_size = blocks.first;
+            opt.secondary_block_size = blocks.second;
+
+            std::vector<std::vector<double> > output(NRHS, std::vector<double>(NR)), ioutput(NRHS, std::vector<double>(NR));
+            std::vector<double*> output_ptrs, ioutput_ptrs;
+            for (int h = 0; h < NRHS; ++h) {
+                output_ptrs.push_back(output[h].data());
+                ioutput_ptrs.push_back(ioutput[h].data());
+            }
+            tatami_mult::multiply_dense_row_with_multiple_vectors(mat, rhs_ptrs, output_ptrs, opt);
+            tatami_mult::multiply_dense_row_with_multiple_vectors(mat, irhs_ptrs, ioutput_ptrs, opt);
+
+            for (int h = 0; h < NRHS; ++h) {
+                for (int r = 0; r < NR; ++r) {
+                    double ref = 0, iref = 0;
+                    for (int c = 0; c < NC; ++c) {
+                        ref += static_cast<double>(counts[r * NC + c]) * rhs_ptrs[h][c];
+                        iref += static_cast<double>(counts[r * NC + c]) * irhs[h][c];
+                    }
+                    EXPECT_FLOAT_EQ(ref, output[h][r]);
+                    EXPECT_EQ(iref, ioutput[h][r]);
+                }
+            }
+        }
+    }
+}
@@ -92,4 +92,8 @@ TEST(MultipleVectorsDispatch, Options) {
     tatami_mult::set_sparse_block_size(opt, 42);
     EXPECT_EQ(opt.sparse_row.block_size, 42);
     EXPECT_EQ(opt.sparse_column.block_size, 42);
+
+    tatami_mult::set_sparse_pattern(opt, true);
+    EXPECT_TRUE(opt.sparse_row.pattern);
+    EXPECT_TRUE(opt.sparse_column.pattern);
 }
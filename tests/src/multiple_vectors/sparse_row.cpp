@@ -161,3 +161,58 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::Values(1, 3)
     )
 );
+
+/******************************/
+
+TEST(MultipleVectorsSparseRow, Pattern) {
+    const int NR = 83, NC = 67, NRHS = 5;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = 1;
+        opt.upper = 1;
+        opt.density = 0.15;
+        opt.seed = 7777;
+        return opt;
+    }());
+    auto sparse_row = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), true, {});
+    auto sparse_col = tatami::convert_to_compressed_sparse<double, int>(*sparse_row, false, {});
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 6666;
+        return opt;
+    }());
+    std::vector<double*> rhs_ptrs(NRHS);
+    for (int h = 0; h < NRHS; ++h) {
+        rhs_ptrs[h] = rhs.data() + h * NC;
+    }
+
+    for (int nthreads : { 1, 3 }) {
+        for (int block_size : { 1, 16 }) {
+            tatami_mult::MultiplySparseRowWithMultipleVectorsOptions opt;
+            opt.num_threads = nthreads;
+            opt.block_size = block_size;
+            auto popt = opt;
+            popt.pattern = true;
+
+            for (const auto& mat : { sparse_row, sparse_col }) {
+                std::vector<std::vector<double> > ref(NRHS, std::vector<double>(NR)), output(NRHS, std::vector<double>(NR, 123));
+                std::vector<double*> ref_ptrs, output_ptrs;
+                for (int h = 0; h < NRHS; ++h) {
+                    ref_ptrs.push_back(ref[h].data());
+                    output_ptrs.push_back(output[h].data());
+                }
+
+                tatami_mult::multiply_sparse_row_with_multiple_vectors(*mat, rhs_ptrs, ref_ptrs, opt);
+                tatami_mult::multiply_sparse_row_with_multiple_vectors(*mat, rhs_ptrs, output_ptrs, popt);
+                for (int h = 0; h < NRHS; ++h) {
+                    for (int r = 0; r < NR; ++r) {
+                        EXPECT_FLOAT_EQ(ref[h][r], output[h][r]);
+                    }
+                }
+            }
+        }
+    }
+}
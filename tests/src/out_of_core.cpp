@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <limits>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+#include "utils.h"
+
+class OutOfCoreTest : public ::testing::TestWithParam<std::tuple<std::size_t, int, int> > {};
+
+TEST_P(OutOfCoreTest, Basic) {
+    const auto params = GetParam();
+    const int NR = 57, NC = 38, NRHS = 29;
+
+    tatami_mult::MultiplyOutOfCoreOptions opt;
+    opt.output_tile_size = std::get<0>(params);
+    opt.common_block_size = std::get<1>(params);
+    opt.num_threads = std::get<2>(params);
+
+    auto lefts = create_test_matrices(NR, NC, 12 + opt.output_tile_size + opt.common_block_size);
+    auto rights = create_test_matrices(NC, NRHS, 21 + opt.output_tile_size + opt.common_block_size);
+    tatami_mult::MultiplyWithMatrixOptions ref_opt;
+    ref_opt.larger_left = false;
+
+    for (bool row_major : { true, false }) {
+        std::vector<double> ref(NR * NRHS);
+        tatami_mult::multiply_with_matrix(*(lefts.front()), *(rights.front()), ref.data(), row_major, ref_opt);
+
+        for (const auto& left : lefts) {
+            for (const auto& right : rights) {
+                std::vector<double> output(NR * NRHS, -1);
+                tatami_mult::multiply_out_of_core(*left, *right, output.data(), row_major, opt);
+                for (int i = 0; i < NR * NRHS; ++i) {
+                    EXPECT_FLOAT_EQ(ref[i], output[i]);
+                }
+            }
+        }
+    }
+
+    // Checking that the tiles are within budget and cover the output exactly once.
+    std::vector<int> visited(NR * NRHS);
+    int last_row = -1;
+    tatami_mult::multiply_out_of_core_to_tiles(
+        *(lefts.front()),
+        *(rights.front()),
+        [&](int row_start, int row_length, int col_start, int col_length, const double*) -> void {
+            EXPECT_LE(static_cast<std::size_t>(row_length * col_length), std::max<std::size_t>(opt.output_tile_size, NRHS));
+            EXPECT_GE(row_start, last_row);
+            last_row = row_start;
+            for (int r = row_start; r < row_start + row_length; ++r) {
+                for (int c = col_start; c < col_start + col_length; ++c) {
+                    ++visited[r * NRHS + c];
+                }
+            }
+        },
+        opt
+    );
+    for (auto v : visited) {
+        EXPECT_EQ(v, 1);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    OutOfCore,
+    OutOfCoreTest,
+    ::testing::Combine(
+        ::testing::Values(20, 400, 100000), // output tile size
+        ::testing::Values(0, 7, 1024), // common block size, where 0 is treated as 1
+        ::testing::Values(1, 3) // number of threads
+    )
+);
+
+TEST(OutOfCore, NonFinite) {
+    // Zeros in the LHS should not propagate non-finite values from the RHS.
+    tatami::DenseRowMatrix<double, int> left(2, 2, std::vector<double>{ 0, 1, 2, 0 });
+    tatami::DenseRowMatrix<double, int> right(2, 2, std::vector<double>{ std::numeric_limits<double>::infinity(), 1, 3, 4 });
+    std::vector<double> output(4);
+    tatami_mult::multiply_out_of_core(left, right, output.data(), true, tatami_mult::MultiplyOutOfCoreOptions());
+    EXPECT_EQ(output[0], 3);
+    EXPECT_EQ(output[1], 4);
+    EXPECT_TRUE(std::isinf(output[2]));
+    EXPECT_EQ(output[3], 2);
+}
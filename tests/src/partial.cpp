@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+#include "utils.h"
+
+class PartialTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    static std::vector<int> create_boundaries(int NC, int num_slices) {
+        std::vector<int> boundaries;
+        for (int s = 0; s <= num_slices; ++s) {
+            boundaries.push_back((NC * s) / num_slices);
+        }
+        return boundaries;
+    }
+};
+
+TEST_P(PartialTest, Vectors) {
+    const auto params = GetParam();
+    const int num_slices = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+    const int NR = 67, NC = 43, num_vectors = 5;
+
+    auto lefts = create_test_matrices(NR, NC, 11 + num_slices + nthreads);
+    std::vector<std::vector<double> > rhs;
+    std::vector<const double*> rhs_ptrs;
+    for (int v = 0; v < num_vectors; ++v) {
+        rhs.push_back(tatami_test::simulate_vector<double>(NC, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 22 + v + num_slices;
+            return opt;
+        }()));
+        rhs_ptrs.push_back(rhs.back().data());
+    }
+
+    std::vector<std::vector<double> > ref(num_vectors, std::vector<double>(NR));
+    std::vector<double*> ref_ptrs;
+    for (auto& r : ref) {
+        ref_ptrs.push_back(r.data());
+    }
+    tatami_mult::multiply_with_multiple_vectors(*(lefts.front()), rhs_ptrs, ref_ptrs, tatami_mult::MultiplyWithMultipleVectorsOptions());
+
+    tatami_mult::MultiplyWithMultipleVectorsOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+    const auto boundaries = create_boundaries(NC, num_slices);
+
+    // Checking that the block sizes of each kernel are respected.
+    for (int block_size : { 1, 4 }) {
+        opt.dense_row.primary_block_size = block_size;
+        opt.dense_row.secondary_block_size = 7;
+        opt.dense_column.primary_block_size = block_size;
+        opt.sparse_row.block_size = block_size;
+        opt.sparse_column.block_size = block_size;
+
+        for (const auto& left : lefts) {
+            std::vector<std::vector<double> > output(num_vectors, std::vector<double>(NR));
+            std::vector<double*> output_ptrs;
+            for (auto& o : output) {
+                output_ptrs.push_back(o.data());
+            }
+
+            for (int s = 0; s < num_slices; ++s) {
+                tatami_mult::multiply_partial_with_multiple_vectors(*left, boundaries[s], boundaries[s + 1] - boundaries[s], rhs_ptrs, output_ptrs, opt);
+            }
+
+            for (int v = 0; v < num_vectors; ++v) {
+                for (int r = 0; r < NR; ++r) {
+                    EXPECT_FLOAT_EQ(ref[v][r], output[v][r]);
+                }
+            }
+        }
+    }
+}
+
+TEST_P(PartialTest, Matrix) {
+    const auto params = GetParam();
+    const int num_slices = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+    const int NR = 47, NC = 38, NRHS = 29;
+
+    auto lefts = create_test_matrices(NR, NC, 33 + num_slices + nthreads);
+    auto rights = create_test_matrices(NC, NRHS, 44 + num_slices + nthreads);
+    tatami_mult::MultiplyWithMatrixOptions ref_opt;
+    ref_opt.larger_left = false;
+
+    tatami_mult::MultiplyPartialWithMatrixOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+    const auto boundaries = create_boundaries(NC, num_slices);
+
+    for (bool row_major : { true, false }) {
+        std::vector<double> ref(NR * NRHS);
+        tatami_mult::multiply_with_matrix(*(lefts.front()), *(rights.front()), ref.data(), row_major, ref_opt);
+
+        for (const auto& left : lefts) {
+            for (const auto& right : rights) {
+                std::vector<double> output(NR * NRHS);
+                for (int s = 0; s < num_slices; ++s) {
+                    tatami_mult::multiply_partial_with_matrix(*left, *right, boundaries[s], boundaries[s + 1] - boundaries[s], output.data(), row_major, opt);
+                }
+                for (int i = 0; i < NR * NRHS; ++i) {
+                    EXPECT_FLOAT_EQ(ref[i], output[i]);
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Partial,
+    PartialTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 5), // number of slices
+        ::testing::Values(1, 3) // number of threads
+    )
+);
+
+TEST(Partial, Empty) {
+    tatami::DenseRowMatrix<double, int> left(3, 2, std::vector<double>{ 1, 2, 3, 4, 5, 6 });
+    std::vector<double> right{ 1, 1 }, output{ 7, 8, 9 };
+    tatami_mult::multiply_partial_with_multiple_vectors(
+        left,
+        1,
+        0,
+        std::vector<const double*>{ right.data() },
+        std::vector<double*>{ output.data() },
+        tatami_mult::MultiplyWithMultipleVectorsOptions()
+    );
+    EXPECT_EQ(output, std::vector<double>({ 7, 8, 9 }));
+}
+
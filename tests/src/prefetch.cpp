@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <numeric>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+#include "tatami_mult/prefetch.hpp"
+
+class PrefetchTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    inline static std::shared_ptr<const tatami::Matrix<double, int> > dense_row, dense_column, sparse_row, sparse_column;
+    inline static int NR = 73, NC = 42;
+
+    static void SetUpTestSuite() {
+        auto dump = tatami_test::simulate_vector<double>(NR * NC, []{
+            tatami_test::SimulateVectorOptions opt;
+            opt.density = 0.2;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 7777;
+            return opt;
+        }());
+        auto tmp = std::make_shared<tatami::DenseRowMatrix<double, int> >(NR, NC, std::move(dump));
+        dense_row = tmp;
+        dense_column = tatami::convert_to_dense(tmp.get(), false);
+        sparse_row = tatami::convert_to_compressed_sparse(tmp.get(), true);
+        sparse_column = tatami::convert_to_compressed_sparse(tmp.get(), false);
+    }
+};
+
+TEST_P(PrefetchTest, Extractors) {
+    const auto params = GetParam();
+    tatami_mult::PrefetchOptions popt;
+    popt.num_buffers = std::get<0>(params);
+    popt.min_predictions = 0;
+
+    for (const auto& mat : { dense_row, sparse_column }) {
+        tatami_mult::PrefetchedMatrix<double, int> pmat(mat, popt);
+        EXPECT_EQ(pmat.nrow(), mat->nrow());
+        EXPECT_EQ(pmat.ncol(), mat->ncol());
+        EXPECT_EQ(pmat.is_sparse(), mat->is_sparse());
+        EXPECT_EQ(pmat.prefer_rows(), mat->prefer_rows());
+
+        for (const bool row : { true, false }) {
+            const int primary = (row ? NR : NC), secondary = (row ? NC : NR);
+            const int sub_start = 5, sub_length = secondary / 2;
+            auto indices = std::make_shared<std::vector<int> >();
+            for (int s = 1; s < secondary; s += 3) {
+                indices->push_back(s);
+            }
+
+            // Dense extraction, for full, block and indexed.
+            {
+                auto ref = tatami::consecutive_extractor<false>(*mat, row, 0, primary);
+                auto full = tatami::consecutive_extractor<false>(pmat, row, 0, primary);
+                auto refb = tatami::consecutive_extractor<false>(*mat, row, 0, primary, sub_start, sub_length);
+                auto block = tatami::consecutive_extractor<false>(pmat, row, 0, primary, sub_start, sub_length);
+                auto refi = tatami::consecutive_extractor<false>(*mat, row, 0, primary, indices);
+                auto idx = tatami::consecutive_extractor<false>(pmat, row, 0, primary, indices);
+
+                std::vector<double> buffer1(secondary), buffer2(secondary);
+                for (int p = 0; p < primary; ++p) {
+                    auto rptr = ref->fetch(buffer1.data());
+                    auto pptr = full->fetch(buffer2.data());
+                    EXPECT_EQ(std::vector<double>(rptr, rptr + secondary), std::vector<double>(pptr, pptr + secondary));
+
+                    rptr = refb->fetch(buffer1.data());
+                    pptr = block->fetch(buffer2.data());
+                    EXPECT_EQ(std::vector<double>(rptr, rptr + sub_length), std::vector<double>(pptr, pptr + sub_length));
+
+                    rptr = refi->fetch(buffer1.data());
+                    pptr = idx->fetch(buffer2.data());
+                    EXPECT_EQ(std::vector<double>(rptr, rptr + indices->size()), std::vector<double>(pptr, pptr + indices->size()));
+                }
+            }
+
+            // Sparse extraction, including when values or indices are not extracted.
+            for (int mode = 0; mode < 3; ++mode) {
+                tatami::Options eopt;
+                eopt.sparse_extract_value = (mode != 1);
+                eopt.sparse_extract_index = (mode != 2);
+                auto ref = tatami::consecutive_extractor<true>(*mat, row, 0, primary, eopt);
+                auto full = tatami::consecutive_extractor<true>(pmat, row, 0, primary, eopt);
+
+                std::vector<double> vbuffer1(secondary), vbuffer2(secondary);
+                std::vector<int> ibuffer1(secondary), ibuffer2(secondary);
+                for (int p = 0; p < primary; ++p) {
+                    auto rrange = ref->fetch(vbuffer1.data(), ibuffer1.data());
+                    auto prange = full->fetch(vbuffer2.data(), ibuffer2.data());
+                    ASSERT_EQ(rrange.number, prange.number);
+                    EXPECT_EQ(rrange.value == NULL, prange.value == NULL);
+                    EXPECT_EQ(rrange.index == NULL, prange.index == NULL);
+                    if (rrange.value) {
+                        EXPECT_EQ(std::vector<double>(rrange.value, rrange.value + rrange.number), std::vector<double>(prange.value, prange.value + prange.number));
+                    }
+                    if (rrange.index) {
+                        EXPECT_EQ(std::vector<int>(rrange.index, rrange.index + rrange.number), std::vector<int>(prange.index, prange.index + prange.number));
+                    }
+                }
+            }
+
+            // Extractors can be destroyed before all elements are consumed.
+            {
+                auto partial = tatami::consecutive_extractor<false>(pmat, row, 0, primary);
+                std::vector<double> buffer(secondary);
+                partial->fetch(buffer.data());
+            }
+        }
+    }
+}
+
+TEST_P(PrefetchTest, Multiply) {
+    const auto params = GetParam();
+    tatami_mult::PrefetchOptions popt;
+    popt.num_buffers = std::get<0>(params);
+    popt.min_predictions = 0;
+    const int nthreads = std::get<1>(params);
+
+    const int NRHS = 7;
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 6666;
+        return opt;
+    }());
+    tatami::DenseColumnMatrix<double, int> right(NC, NRHS, rhs);
+
+    tatami_mult::MultiplyWithMatrixOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+    opt.larger_left = false;
+
+    for (const auto& mat : { dense_row, dense_column, sparse_row, sparse_column }) {
+        tatami_mult::PrefetchedMatrix<double, int> pmat(mat, popt);
+        for (const bool row_major : { true, false }) {
+            std::vector<double> ref(NR * NRHS), output(NR * NRHS);
+            tatami_mult::multiply_with_matrix(*mat, right, ref.data(), row_major, opt);
+            tatami_mult::multiply_with_matrix(pmat, right, output.data(), row_major, opt);
+            for (std::size_t i = 0; i < ref.size(); ++i) {
+                EXPECT_FLOAT_EQ(ref[i], output[i]);
+            }
+        }
+
+        std::vector<double> ref(NR), output(NR);
+        tatami_mult::MultiplyWithSingleVectorOptions vopt;
+        tatami_mult::set_num_threads(vopt, nthreads);
+        tatami_mult::multiply_with_single_vector(*mat, rhs.data(), ref.data(), vopt);
+        tatami_mult::multiply_with_single_vector(pmat, rhs.data(), output.data(), vopt);
+        for (std::size_t i = 0; i < ref.size(); ++i) {
+            EXPECT_FLOAT_EQ(ref[i], output[i]);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Prefetch,
+    PrefetchTest,
+    ::testing::Combine(
+        ::testing::Values(0, 1, 2, 4), // number of buffers, where 0 should be treated as 1
+        ::testing::Values(1, 3) // number of threads
+    )
+);
+
+TEST(Prefetch, MinPredictions) {
+    const int NR = 20, NC = 15;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.seed = 8888;
+        return opt;
+    }());
+    auto mat = std::make_shared<tatami::DenseRowMatrix<double, int> >(NR, NC, std::move(dump));
+
+    // Extractors that predict fewer rows than the threshold are passed through, but should still give the same results.
+    tatami_mult::PrefetchOptions popt;
+    popt.min_predictions = 10;
+    tatami_mult::PrefetchedMatrix<double, int> pmat(mat, popt);
+
+    for (int length : { 5, NR }) {
+        auto ref = tatami::consecutive_extractor<false>(*mat, true, 0, length);
+        auto ext = tatami::consecutive_extractor<false>(pmat, true, 0, length);
+        std::vector<double> buffer1(NC), buffer2(NC);
+        for (int r = 0; r < length; ++r) {
+            auto rptr = ref->fetch(buffer1.data());
+            auto pptr = ext->fetch(buffer2.data());
+            EXPECT_EQ(std::vector<double>(rptr, rptr + NC), std::vector<double>(pptr, pptr + NC));
+        }
+    }
+}
@@ -0,0 +1,281 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <numeric>
+#include <sstream>
+#include <cstring>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/row_blocks.hpp"
+
+class RowBlocksTest : public ::testing::TestWithParam<std::tuple<int, int, int, double, std::pair<int, int>, int> > {};
+
+TEST_P(RowBlocksTest, Basic) {
+    const auto params = GetParam();
+    const int NR = std::get<0>(params);
+    const int NC = std::get<1>(params);
+    const int NRHS = std::get<2>(params);
+    const double density = std::get<3>(params);
+    const auto blocks = std::get<4>(params);
+    const auto nthreads = std::get<5>(params);
+
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.density = density;
+        opt.seed = 1690 + NR + NC + NRHS + blocks.first + blocks.second + nthreads;
+        return opt;
+    }());
+    auto dense_row = std::make_unique<tatami::DenseRowMatrix<double, int> >(NR, NC, dump);
+    auto sparse_row = tatami::convert_to_compressed_sparse<double, int>(*dense_row, true, {});
+    auto dense_col = tatami::convert_to_dense<double, int>(*dense_row, false, {});
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.density = density;
+        opt.seed = 1142 + NR + NC + NRHS + blocks.first + blocks.second + nthreads;
+        return opt;
+    }());
+    auto right_col = std::make_unique<tatami::DenseColumnMatrix<double, int> >(NC, NRHS, rhs);
+    auto right_row = tatami::convert_to_dense<double, int>(*right_col, true, {});
+    auto right_sparse = tatami::convert_to_compressed_sparse<double, int>(*right_col, true, {});
+
+    tatami_mult::MultiplyWithMatrixToRowBlocksOptions opt;
+    opt.num_threads = nthreads;
+    opt.block_size = blocks.first;
+    opt.secondary_block_size = blocks.second;
+
+    const auto output_size = NR * NRHS;
+    auto collect = [&](const tatami::Matrix<double, int>& left, const tatami::Matrix<double, int>& right) -> std::vector<double> {
+        std::vector<double> output(output_size, -1);
+        std::vector<int> visited(NR);
+        tatami_mult::multiply_with_matrix_to_row_blocks(
+            left,
+            right,
+            [&](int start, int length, const double* block) -> void {
+                EXPECT_LE(length, blocks.first);
+                std::copy_n(block, length * NRHS, output.begin() + start * NRHS);
+                for (int r = start; r < start + length; ++r) {
+                    ++visited[r];
+                }
+            },
+            opt
+        );
+        for (auto v : visited) {
+            EXPECT_EQ(v, 1);
+        }
+        return output;
+    };
+
+    auto dr_dr = collect(*dense_row, *right_row);
+    auto dr_dc = collect(*dense_row, *right_col);
+    auto dr_sr = collect(*dense_row, *right_sparse);
+    auto sr_dr = collect(*sparse_row, *right_row);
+    auto sr_sr = collect(*sparse_row, *right_sparse);
+    auto dc_dr = collect(*dense_col, *right_row);
+
+    for (int h = 0; h < NRHS; ++h) {
+        const auto rptr = rhs.data() + h * NC;
+        for (int r = 0; r < NR; ++r) {
+            const auto ref = std::inner_product(rptr, rptr + NC, dump.begin() + r * NC, 0.0);
+            const auto rm_idx = r * NRHS + h;
+            EXPECT_FLOAT_EQ(ref, dr_dr[rm_idx]);
+            EXPECT_FLOAT_EQ(ref, dr_dc[rm_idx]);
+            EXPECT_FLOAT_EQ(ref, dr_sr[rm_idx]);
+            EXPECT_FLOAT_EQ(ref, sr_dr[rm_idx]);
+            EXPECT_FLOAT_EQ(ref, sr_sr[rm_idx]);
+            EXPECT_FLOAT_EQ(ref, dc_dr[rm_idx]);
+        }
+    }
+}
+
+TEST_P(RowBlocksTest, Ordered) {
+    const auto params = GetParam();
+    const int NR = std::get<0>(params);
+    const int NC = std::get<1>(params);
+    const int NRHS = std::get<2>(params);
+    const double density = std::get<3>(params);
+    const auto blocks = std::get<4>(params);
+    const auto nthreads = std::get<5>(params);
+
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.density = density;
+        opt.seed = 2690 + NR + NC + NRHS + blocks.first + blocks.second + nthreads;
+        return opt;
+    }());
+    auto dense_row = std::make_unique<tatami::DenseRowMatrix<double, int> >(NR, NC, dump);
+    auto sparse_row = tatami::convert_to_compressed_sparse<double, int>(*dense_row, true, {});
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.density = density;
+        opt.seed = 2142 + NR + NC + NRHS + blocks.first + blocks.second + nthreads;
+        return opt;
+    }());
+    auto right_row = std::make_unique<tatami::DenseRowMatrix<double, int> >(NC, NRHS, rhs);
+    auto right_sparse = tatami::convert_to_compressed_sparse<double, int>(*right_row, true, {});
+
+    tatami_mult::MultiplyWithMatrixToRowBlocksOptions opt;
+    opt.num_threads = nthreads;
+    opt.block_size = blocks.first;
+    opt.secondary_block_size = blocks.second;
+    opt.ordered_block_size = 17;
+
+    const auto output_size = NR * NRHS;
+    auto compare = [&](const tatami::Matrix<double, int>& left, const tatami::Matrix<double, int>& right) -> void {
+        std::vector<double> ref(output_size);
+        tatami_mult::multiply_with_matrix_to_row_blocks(
+            left,
+            right,
+            [&](int start, int length, const double* block) -> void {
+                std::copy_n(block, length * NRHS, ref.begin() + start * NRHS);
+            },
+            opt
+        );
+
+        std::vector<double> output;
+        tatami_mult::multiply_with_matrix_to_ordered_row_blocks(
+            left,
+            right,
+            [&](int start, int length, const double* block) -> void {
+                EXPECT_EQ(start * NRHS, static_cast<int>(output.size()));
+                EXPECT_LE(length, opt.ordered_block_size);
+                output.insert(output.end(), block, block + length * NRHS);
+            },
+            opt
+        );
+        EXPECT_EQ(ref, output);
+
+        std::ostringstream stream;
+        tatami_mult::multiply_with_matrix_to_stream(left, right, stream, opt);
+        const auto contents = stream.str();
+        ASSERT_EQ(contents.size(), output_size * sizeof(double));
+        std::vector<double> streamed(output_size);
+        std::memcpy(streamed.data(), contents.data(), contents.size());
+        EXPECT_EQ(ref, streamed);
+    };
+
+    compare(*dense_row, *right_row);
+    compare(*dense_row, *right_sparse);
+    compare(*sparse_row, *right_row);
+    compare(*sparse_row, *right_sparse);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    RowBlocks,
+    RowBlocksTest,
+    ::testing::Combine(
+        ::testing::Values(100, 13), // number of rows.
+        ::testing::Values(14, 148), // number of columns.
+        ::testing::Values(10, 74),  // number of RHS vectors.
+        ::testing::Values(1, 0.1),  // density.
+        ::testing::Values(          // block size.
+            std::make_pair(1, 16),
+            std::make_pair(8, 8),
+            std::make_pair(16, 64)
+        ),
+        ::testing::Values(1, 3)
+    )
+);
+
+TEST(RowBlocks, StreamError) {
+    tatami::DenseRowMatrix<double, int> left(5, 4, std::vector<double>(20, 1));
+    tatami::DenseRowMatrix<double, int> right(4, 3, std::vector<double>(12, 1));
+    std::ostringstream stream;
+    stream.setstate(std::ios::badbit);
+    tatami_mult::multiply_with_matrix_to_stream(left, right, stream, tatami_mult::MultiplyWithMatrixToRowBlocksOptions());
+    EXPECT_TRUE(stream.fail());
+    EXPECT_TRUE(stream.str().empty());
+}
+
+TEST(RowBlocks, NonPositiveBlockSize) {
+    tatami::DenseRowMatrix<double, int> left(20, 4, std::vector<double>(80, 1));
+    tatami::DenseRowMatrix<double, int> right(4, 3, std::vector<double>(12, 1));
+    auto sparse_left = tatami::convert_to_compressed_sparse<double, int>(left, true, {});
+    auto sparse_right = tatami::convert_to_compressed_sparse<double, int>(right, true, {});
+
+    // Non-positive block sizes are treated as 1.
+    tatami_mult::MultiplyWithMatrixToRowBlocksOptions opt;
+    opt.block_size = 0;
+
+    for (const tatami::Matrix<double, int>* lptr : { static_cast<const tatami::Matrix<double, int>*>(&left), sparse_left.get() }) {
+        for (const tatami::Matrix<double, int>* rptr : { static_cast<const tatami::Matrix<double, int>*>(&right), sparse_right.get() }) {
+            int rows = 0;
+            tatami_mult::multiply_with_matrix_to_row_blocks(
+                *lptr,
+                *rptr,
+                [&](int start, int length, const double* block) -> void {
+                    EXPECT_EQ(start, rows);
+                    EXPECT_EQ(length, 1);
+                    EXPECT_EQ(std::vector<double>(block, block + 3), std::vector<double>(3, 4));
+                    rows += length;
+                },
+                opt
+            );
+            EXPECT_EQ(rows, 20);
+        }
+    }
+}
+
+TEST(RowBlocks, OrderedStop) {
+    tatami::DenseRowMatrix<double, int> left(50, 4, std::vector<double>(200, 1));
+    tatami::DenseRowMatrix<double, int> right(4, 3, std::vector<double>(12, 1));
+    tatami_mult::MultiplyWithMatrixToRowBlocksOptions opt;
+    opt.ordered_block_size = 7;
+
+    int calls = 0;
+    tatami_mult::multiply_with_matrix_to_ordered_row_blocks(
+        left,
+        right,
+        [&](int, int, const double*) -> bool {
+            ++calls;
+            return calls < 2;
+        },
+        opt
+    );
+    EXPECT_EQ(calls, 2);
+
+    // Non-positive block sizes are treated as 1.
+    opt.ordered_block_size = 0;
+    int rows = 0;
+    calls = 0;
+    tatami_mult::multiply_with_matrix_to_ordered_row_blocks(
+        left,
+        right,
+        [&](int start, int length, const double*) -> void {
+            EXPECT_EQ(start, rows);
+            EXPECT_EQ(length, 1);
+            rows += length;
+            ++calls;
+        },
+        opt
+    );
+    EXPECT_EQ(rows, 50);
+    EXPECT_EQ(calls, 50);
+
+    // Same for the size of the blocks used to fill each round.
+    opt.ordered_block_size = 7;
+    opt.block_size = 0;
+    rows = 0;
+    tatami_mult::multiply_with_matrix_to_ordered_row_blocks(
+        left,
+        right,
+        [&](int start, int length, const double* block) -> void {
+            EXPECT_EQ(start, rows);
+            EXPECT_EQ(std::vector<double>(block, block + length * 3), std::vector<double>(length * 3, 4));
+            rows += length;
+        },
+        opt
+    );
+    EXPECT_EQ(rows, 50);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <numeric>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/single_vector/compressed_sparse_row.hpp"
+
+class SingleVectorCompressedSparseRowTest : public ::testing::TestWithParam<std::tuple<int, int, int, bool> > {};
+
+TEST_P(SingleVectorCompressedSparseRowTest, Vector) {
+    const auto params = GetParam();
+    const int NR = std::get<0>(params);
+    const int NC = std::get<1>(params);
+    const auto nthreads = std::get<2>(params);
+    const bool hub = std::get<3>(params);
+
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.density = 0.05;
+        opt.seed = 71 + NR + NC + nthreads + hub;
+        return opt;
+    }());
+
+    // Making a few hub rows that contain most of the non-zero elements, so that they will need to be split across threads.
+    if (hub) {
+        for (int r = 0; r < NR; r += 7) {
+            for (int c = 0; c < NC; ++c) {
+                dump[r * NC + c] = (c % 10) + 1;
+            }
+        }
+    }
+
+    std::vector<double> values;
+    std::vector<int> indices;
+    std::vector<std::size_t> pointers(1);
+    for (int r = 0; r < NR; ++r) {
+        for (int c = 0; c < NC; ++c) {
+            const auto val = dump[r * NC + c];
+            if (val) {
+                values.push_back(val);
+                indices.push_back(c);
+            }
+        }
+        pointers.push_back(values.size());
+    }
+
+    auto rhs = tatami_test::simulate_vector<double>(NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 47 + NR + NC + nthreads;
+        return opt;
+    }());
+
+    tatami_mult::MultiplyCompressedSparseRowWithSingleVectorOptions opt;
+    opt.num_threads = nthreads;
+
+    // Setting an initial value for the output vectors, to check that dirty outputs are properly zeroed.
+    std::vector<double> output1(NR, 123);
+    std::vector<double> output4(NR, 7);
+    tatami_mult::multiply_compressed_sparse_row_with_single_vector<1>(NR, values.data(), indices.data(), pointers.data(), rhs.data(), output1.data(), opt);
+    tatami_mult::multiply_compressed_sparse_row_with_single_vector<4>(NR, values.data(), indices.data(), pointers.data(), rhs.data(), output4.data(), opt);
+
+    for (int r = 0; r < NR; ++r) {
+        const auto ref = std::inner_product(rhs.begin(), rhs.end(), dump.begin() + r * NC, 0.0);
+        EXPECT_FLOAT_EQ(ref, output1[r]);
+        EXPECT_FLOAT_EQ(ref, output4[r]);
+    }
+
+    // Checking that we handle row pointers that don't start at zero, by skipping the first row.
+    if (NR > 1) {
+        std::vector<double> sliced(NR - 1, 99);
+        tatami_mult::multiply_compressed_sparse_row_with_single_vector(NR - 1, values.data(), indices.data(), pointers.data() + 1, rhs.data(), sliced.data(), opt);
+        for (int r = 1; r < NR; ++r) {
+            EXPECT_FLOAT_EQ(output4[r], sliced[r - 1]);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SingleVectorCompressedSparseRow,
+    SingleVectorCompressedSparseRowTest,
+    ::testing::Combine(
+        ::testing::Values(1, 10, 99), // number of rows
+        ::testing::Values(1, 10, 501), // number of columns
+        ::testing::Values(1, 3, 8), // number of threads
+        ::testing::Values(false, true) // whether to add hub rows
+    )
+);
+
+TEST(SingleVectorCompressedSparseRow, Empty) {
+    // More threads than rows + non-zeros.
+    std::vector<double> values;
+    std::vector<int> indices;
+    std::vector<int> pointers(3);
+    std::vector<double> rhs(5, 1);
+    std::vector<double> output(2, 99);
+
+    tatami_mult::MultiplyCompressedSparseRowWithSingleVectorOptions opt;
+    opt.num_threads = 5;
+    tatami_mult::multiply_compressed_sparse_row_with_single_vector(2, values.data(), indices.data(), pointers.data(), rhs.data(), output.data(), opt);
+    EXPECT_EQ(output, std::vector<double>(2));
+}
+
+TEST(SingleVectorCompressedSparseRow, NoThreads) {
+    std::vector<double> values { 1, 2, 3 };
+    std::vector<int> indices { 0, 2, 1 };
+    std::vector<int> pointers { 0, 2, 2, 3 };
+    std::vector<double> rhs { 5, 6, 7 };
+    std::vector<double> output(3, 99);
+
+    // Zero threads should be treated as a single thread, rather than dividing by zero.
+    tatami_mult::MultiplyCompressedSparseRowWithSingleVectorOptions opt;
+    opt.num_threads = 0;
+    tatami_mult::multiply_compressed_sparse_row_with_single_vector(3, values.data(), indices.data(), pointers.data(), rhs.data(), output.data(), opt);
+    std::vector<double> expected { 19, 0, 18 };
+    EXPECT_EQ(output, expected);
+}
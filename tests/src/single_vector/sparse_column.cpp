@@ -76,3 +76,41 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::Values(1, 3)
     )
 );
+
+TEST(SingleVectorSparseColumn, Pattern) {
+    const int NR = 91, NC = 78;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = 1;
+        opt.upper = 1;
+        opt.density = 0.15;
+        opt.seed = 9999;
+        return opt;
+    }());
+    auto sparse_row = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), true, {});
+    auto sparse_col = tatami::convert_to_compressed_sparse<double, int>(*sparse_row, false, {});
+
+    auto rhs = tatami_test::simulate_vector<double>(NC, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 8888;
+        return opt;
+    }());
+
+    for (int nthreads : { 1, 3 }) {
+        tatami_mult::MultiplySparseColumnWithSingleVectorOptions opt;
+        opt.num_threads = nthreads;
+        tatami_mult::MultiplySparseColumnWithSingleVectorOptions popt = opt;
+        popt.pattern = true;
+
+        for (const auto& mat : { sparse_row, sparse_col }) {
+            std::vector<double> ref(NR), output(NR, 123);
+            tatami_mult::multiply_sparse_column_with_single_vector(*mat, rhs.data(), ref.data(), opt);
+            tatami_mult::multiply_sparse_column_with_single_vector(*mat, rhs.data(), output.data(), popt);
+            for (int r = 0; r < NR; ++r) {
+                EXPECT_FLOAT_EQ(ref[r], output[r]);
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/single_vector/dispatch.hpp"
+
+TEST(SingleVectorWorkspace, Reuse) {
+    tatami_mult::SingleVectorWorkspace<double, int, double> work;
+
+    // Reusing the same workspace across matrices of different shapes and representations, 
+    // and with different numbers of threads, to check that stale contents of the buffers are ignored.
+    int counter = 0;
+    for (const auto& dims : std::vector<std::pair<int, int> >{ { 87, 99 }, { 120, 31 }, { 20, 10 } }) {
+        const int NR = dims.first, NC = dims.second;
+        auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.density = 0.2;
+            opt.seed = 1000 + NR;
+            return opt;
+        }());
+        std::shared_ptr<tatami::Matrix<double, int> > dense_row(new tatami::DenseRowMatrix<double, int>(NR, NC, dump));
+        auto dense_col = tatami::convert_to_dense<double, int>(*dense_row, false, {});
+        auto sparse_row = tatami::convert_to_compressed_sparse<double, int>(*dense_row, true, {});
+        auto sparse_col = tatami::convert_to_compressed_sparse<double, int>(*sparse_row, false, {});
+
+        auto rhs = tatami_test::simulate_vector<double>(NC, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 2000 + NC;
+            return opt;
+        }());
+
+        for (int nthreads : { 3, 1, 2 }) {
+            tatami_mult::MultiplyWithSingleVectorOptions opt;
+            tatami_mult::set_num_threads(opt, nthreads);
+
+            for (const auto& mat : { dense_row, dense_col, sparse_row, sparse_col }) {
+                std::vector<double> ref(NR);
+                tatami_mult::multiply_with_single_vector(*mat, rhs.data(), ref.data(), opt);
+
+                // Repeated calls with the same workspace should give the same results.
+                for (int it = 0; it < 2; ++it) {
+                    std::vector<double> output(NR, -1);
+                    tatami_mult::multiply_with_single_vector(*mat, rhs.data(), output.data(), opt, work);
+                    EXPECT_EQ(ref, output);
+                }
+                ++counter;
+            }
+        }
+    }
+    EXPECT_EQ(counter, 36);
+}
+
+TEST(SingleVectorWorkspace, NoThreads) {
+    const int NR = 23, NC = 17;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.2;
+        opt.seed = 3000;
+        return opt;
+    }());
+    std::shared_ptr<tatami::Matrix<double, int> > dense_row(new tatami::DenseRowMatrix<double, int>(NR, NC, dump));
+    auto dense_col = tatami::convert_to_dense<double, int>(*dense_row, false, {});
+    auto sparse_row = tatami::convert_to_compressed_sparse<double, int>(*dense_row, true, {});
+    auto sparse_col = tatami::convert_to_compressed_sparse<double, int>(*sparse_row, false, {});
+    std::vector<double> rhs(NC, 1);
+
+    // Zero threads should be treated as a single thread, so a fresh workspace still needs a buffer for thread 0.
+    tatami_mult::MultiplyWithSingleVectorOptions opt;
+    tatami_mult::set_num_threads(opt, 0);
+    for (const auto& mat : { dense_row, dense_col, sparse_row, sparse_col }) {
+        std::vector<double> ref(NR);
+        tatami_mult::multiply_with_single_vector(*mat, rhs.data(), ref.data(), tatami_mult::MultiplyWithSingleVectorOptions());
+
+        tatami_mult::SingleVectorWorkspace<double, int, double> work;
+        std::vector<double> output(NR, -1);
+        tatami_mult::multiply_with_single_vector(*mat, rhs.data(), output.data(), opt, work);
+        EXPECT_EQ(ref, output);
+    }
+}
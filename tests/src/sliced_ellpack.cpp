@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <limits>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+class SlicedEllpackTest : public ::testing::TestWithParam<std::tuple<int, int, int, int> > {};
+
+TEST_P(SlicedEllpackTest, Basic) {
+    const auto params = GetParam();
+    const int NR = std::get<0>(params);
+    const int NC = std::get<1>(params);
+    const int sort_window = std::get<2>(params);
+    const int nthreads = std::get<3>(params);
+
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.density = 0.1;
+        opt.seed = 31 + NR + NC + sort_window + nthreads;
+        return opt;
+    }());
+
+    // Adding some denser rows to get variable numbers of non-zeros per row.
+    for (int r = 0; r < NR; r += 5) {
+        for (int c = r % 3; c < NC; c += 3) {
+            dump[r * NC + c] = c + 1;
+        }
+    }
+
+    auto sparse_row = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), true, {});
+    auto sparse_column = tatami::convert_to_compressed_sparse<double, int>(*sparse_row, false, {});
+
+    tatami_mult::SlicedEllpackOptions sopt;
+    sopt.sort_window = sort_window;
+    sopt.num_threads = nthreads;
+
+    const int num_vectors = 3;
+    std::vector<std::vector<double> > rhs;
+    for (int v = 0; v < num_vectors; ++v) {
+        rhs.push_back(tatami_test::simulate_vector<double>(NC, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 73 + NR + NC + v;
+            return opt;
+        }()));
+    }
+
+    tatami_mult::MultiplyWithSingleVectorOptions ref_opt;
+    for (const auto& mat : { sparse_row, sparse_column }) {
+        tatami_mult::SlicedEllpackMatrix<double, int> sell(*mat, sopt);
+        EXPECT_EQ(sell.nrow(), NR);
+        EXPECT_EQ(sell.ncol(), NC);
+        EXPECT_EQ(sell.num_chunks(), (NR + 7) / 8);
+        EXPECT_EQ(sell.num_stored() % 8, 0u);
+
+        std::vector<std::vector<double> > refs;
+        for (int v = 0; v < num_vectors; ++v) {
+            refs.emplace_back(NR);
+            tatami_mult::multiply_with_single_vector(*mat, rhs[v].data(), refs.back().data(), ref_opt);
+        }
+
+        tatami_mult::MultiplySlicedEllpackWithSingleVectorOptions vopt;
+        vopt.num_threads = nthreads;
+        std::vector<double> output(NR, 99);
+        tatami_mult::multiply_sliced_ellpack_with_single_vector(sell, rhs.front().data(), output.data(), vopt);
+        for (int r = 0; r < NR; ++r) {
+            EXPECT_FLOAT_EQ(refs.front()[r], output[r]);
+        }
+
+        tatami_mult::MultiplySlicedEllpackWithMultipleVectorsOptions mopt;
+        mopt.num_threads = nthreads;
+        std::vector<std::vector<double> > outputs(num_vectors, std::vector<double>(NR, 99));
+        std::vector<const double*> rptrs;
+        std::vector<double*> optrs;
+        for (int v = 0; v < num_vectors; ++v) {
+            rptrs.push_back(rhs[v].data());
+            optrs.push_back(outputs[v].data());
+        }
+        tatami_mult::multiply_sliced_ellpack_with_multiple_vectors(sell, rptrs, optrs, mopt);
+        for (int v = 0; v < num_vectors; ++v) {
+            for (int r = 0; r < NR; ++r) {
+                EXPECT_FLOAT_EQ(refs[v][r], outputs[v][r]);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SlicedEllpack,
+    SlicedEllpackTest,
+    ::testing::Combine(
+        ::testing::Values(1, 13, 100), // number of rows
+        ::testing::Values(1, 10, 77), // number of columns
+        ::testing::Values(1, 8, 1000), // sort window
+        ::testing::Values(1, 3) // number of threads
+    )
+);
+
+TEST(SlicedEllpack, Padding) {
+    // Sorting should reduce the padding when rows have very different numbers of non-zeros.
+    const int NR = 64, NC = 50;
+    std::vector<double> dump(NR * NC);
+    for (int r = 0; r < NR; r += 8) {
+        for (int c = 0; c < NC; ++c) {
+            dump[r * NC + c] = 1;
+        }
+    }
+    auto mat = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), true, {});
+
+    tatami_mult::SlicedEllpackOptions sopt;
+    sopt.sort_window = 1;
+    tatami_mult::SlicedEllpackMatrix<double, int> unsorted(*mat, sopt);
+    EXPECT_EQ(unsorted.num_stored(), static_cast<std::size_t>(NR * NC));
+
+    sopt.sort_window = NR;
+    tatami_mult::SlicedEllpackMatrix<double, int> sorted(*mat, sopt);
+    EXPECT_EQ(sorted.num_stored(), static_cast<std::size_t>(8 * NC));
+}
+
+TEST(SlicedEllpack, NonFinite) {
+    // Padded lanes should not be affected by non-finite values in the RHS vector.
+    const int NR = 16, NC = 5;
+    std::vector<double> dump(NR * NC);
+    for (int r = 0; r < NR; ++r) {
+        for (int c = 1; c <= r % NC; ++c) {
+            dump[r * NC + c] = r + c;
+        }
+    }
+    dump[0] = 1; // making sure that at least one row actually uses the first column.
+    auto mat = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), true, {});
+    tatami_mult::SlicedEllpackMatrix<double, int> sell(*mat, tatami_mult::SlicedEllpackOptions());
+
+    for (double special : { std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() }) {
+        std::vector<double> rhs{ special, 1, 2, 3, 4 };
+        std::vector<double> output(NR);
+        tatami_mult::multiply_sliced_ellpack_with_single_vector(sell, rhs.data(), output.data(), tatami_mult::MultiplySlicedEllpackWithSingleVectorOptions());
+
+        std::vector<double> output2(NR);
+        tatami_mult::multiply_sliced_ellpack_with_multiple_vectors(
+            sell,
+            std::vector<const double*>{ rhs.data() },
+            std::vector<double*>{ output2.data() },
+            tatami_mult::MultiplySlicedEllpackWithMultipleVectorsOptions()
+        );
+
+        for (int r = 0; r < NR; ++r) {
+            double expected = 0;
+            for (int c = 1; c < NC; ++c) {
+                expected += dump[r * NC + c] * rhs[c];
+            }
+            if (r == 0) {
+                EXPECT_FALSE(std::isfinite(output[r]));
+                EXPECT_FALSE(std::isfinite(output2[r]));
+            } else {
+                EXPECT_EQ(expected, output[r]);
+                EXPECT_EQ(expected, output2[r]);
+            }
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <vector>
 #include <random>
+#include <cstdint>
 
 #include "tatami_test/tatami_test.hpp"
 
@@ -58,3 +59,47 @@ INSTANTIATE_TEST_SUITE_P(
     SparseDotProductTest,
     ::testing::Values(1, 3, 4, 5, 51, 120, 130, 141) // check multiples and non-multiples of 4.
 );
+
+TEST(SparseDotProduct, SmallIntegers) {
+    const int N = 1000;
+    std::vector<uint8_t> left_value;
+    std::vector<int> left_index;
+    std::vector<uint16_t> right(N);
+    std::int64_t ref = 0;
+    for (int i = 0; i < N; ++i) {
+        right[i] = 65535 - i;
+        if (i % 3 == 0) {
+            left_value.push_back(255 - (i % 50));
+            left_index.push_back(i);
+            ref += static_cast<std::int64_t>(left_value.back()) * static_cast<std::int64_t>(right[i]);
+        }
+    }
+
+    EXPECT_EQ(tatami_mult::sparse_dot_product<1>(left_value.size(), left_value.data(), left_index.data(), right.data(), static_cast<std::int64_t>(0)), ref);
+    EXPECT_EQ(tatami_mult::sparse_dot_product<4>(left_value.size(), left_value.data(), left_index.data(), right.data(), 0.0), static_cast<double>(ref));
+}
+
+TEST(SparseDotProduct, Pattern) {
+    const int N = 500;
+    auto right = tatami_test::simulate_vector<double>(N, []{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 1234;
+        return opt;
+    }());
+
+    for (int step : { 1, 3, 7, 50 }) {
+        std::vector<int> left_index;
+        std::vector<double> left_value;
+        for (int i = 0; i < N; i += step) {
+            left_index.push_back(i);
+            left_value.push_back(1);
+        }
+
+        const auto nnz = left_index.size();
+        const auto ref = tatami_mult::sparse_dot_product<1>(nnz, left_value.data(), left_index.data(), right.data(), 1.5);
+        EXPECT_FLOAT_EQ(ref, tatami_mult::sparse_pattern_dot_product<1>(nnz, left_index.data(), right.data(), 1.5));
+        EXPECT_FLOAT_EQ(ref, tatami_mult::sparse_pattern_dot_product<4>(nnz, left_index.data(), right.data(), 1.5));
+    }
+}
@@ -162,6 +162,31 @@ TEST_P(SparseMatrixDenseColumnEmptyTest, Empty) {
             EXPECT_FLOAT_EQ(ref, dc_rr_co[cm_idx]);
         }
     }
+
+    // Check that the pre-pass to skip empty RHS rows gives the same results.
+    for (bool prepass : { false, true }) {
+        auto popt = opt.row_to_row;
+        popt.prepass_non_empty = prepass;
+        std::vector<double> pre_rr_ro(output_size, 1.5);
+        tatami_mult::multiply_dense_column_with_sparse_row_matrix_to_row_output(*dense_col, *right_row, pre_rr_ro.data(), popt);
+        EXPECT_EQ(dc_rr_ro, pre_rr_ro);
+        tatami_mult::multiply_dense_column_with_sparse_row_matrix_to_row_output(*dense_row, *right_row, pre_rr_ro.data(), popt);
+        EXPECT_EQ(dc_rr_ro, pre_rr_ro);
+    }
+
+    // Check that the pre-pass only requests and fetches the LHS columns for the non-empty RHS rows.
+    // Remember that "rhs" holds the column-major contents of the RHS, i.e., each RHS row is a column of the row-major transpose.
+    // This also checks that the pre-pass is used by default for an oracle-aware LHS.
+    {
+        FetchRecordingMatrix recorder(dense_col);
+        std::vector<double> rec_rr_ro(output_size, 1.5);
+        tatami_mult::multiply_dense_column_with_sparse_row_matrix_to_row_output(recorder, *right_row, rec_rr_ro.data(), opt.row_to_row);
+        EXPECT_EQ(dc_rr_ro, rec_rr_ro);
+
+        const auto expected = find_non_empty_test_vectors(NRHS, NC, rhs, false);
+        EXPECT_EQ(recorder.predicted(), expected);
+        EXPECT_EQ(recorder.fetched(), expected);
+    }
 }
 
 INSTANTIATE_TEST_SUITE_P(
@@ -190,4 +215,56 @@ TEST(SparseMatrixDenseColumn, Options) {
     tatami_mult::set_sparse_block_size(opt, 42);
     EXPECT_EQ(opt.row_to_row.block_size, 42);
     EXPECT_EQ(opt.column_to_row.block_size, 42);
+
+    tatami_mult::set_sparse_pattern(opt, true);
+    EXPECT_TRUE(opt.column_to_column.pattern);
+    EXPECT_TRUE(opt.column_to_row.pattern);
+    EXPECT_TRUE(opt.row_to_column.pattern);
+    EXPECT_TRUE(opt.row_to_row.pattern);
+}
+
+/******************************/
+
+TEST(SparseMatrixDenseColumn, Pattern) {
+    const int NR = 47, NC = 61, NRHS = 37;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 2468;
+        return opt;
+    }());
+    auto left = tatami::convert_to_dense<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), true, {});
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.2;
+        opt.lower = 1;
+        opt.upper = 1;
+        opt.seed = 1357;
+        return opt;
+    }());
+    auto right_col = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseColumnMatrix<double, int>(NC, NRHS, rhs), false, {});
+    auto right_row = tatami::convert_to_compressed_sparse<double, int>(*right_col, true, {});
+
+    for (int nthreads : { 1, 3 }) {
+        for (int block_size : { 1, 4 }) {
+            tatami_mult::MultiplyDenseColumnWithSparseMatrixOptions opt;
+            tatami_mult::set_num_threads(opt, nthreads);
+            tatami_mult::set_sparse_block_size(opt, block_size);
+            auto popt = opt;
+            tatami_mult::set_sparse_pattern(popt, true);
+
+            for (const auto& right : { right_row, right_col }) {
+                for (bool row_major : { true, false }) {
+                    std::vector<double> ref(NR * NRHS), output(NR * NRHS, -1);
+                    tatami_mult::multiply_dense_column_with_sparse_matrix(*left, *right, ref.data(), row_major, opt);
+                    tatami_mult::multiply_dense_column_with_sparse_matrix(*left, *right, output.data(), row_major, popt);
+                    for (int i = 0; i < NR * NRHS; ++i) {
+                        EXPECT_FLOAT_EQ(ref[i], output[i]);
+                    }
+                }
+            }
+        }
+    }
 }
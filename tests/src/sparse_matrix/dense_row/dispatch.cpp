@@ -2,6 +2,8 @@
 
 #include <cstddef>
 #include <vector>
+#include <cmath>
+#include <limits>
 
 #include "tatami_test/tatami_test.hpp"
 
@@ -204,4 +206,177 @@ TEST(SparseMatrixDenseRow, Options) {
     tatami_mult::set_sparse_block_size(opt, 42);
     EXPECT_EQ(opt.column_to_column.block_size, 42);
     EXPECT_EQ(opt.column_to_row.block_size, 42);
+
+    tatami_mult::set_sparse_pattern(opt, true);
+    EXPECT_TRUE(opt.column_to_column.pattern);
+    EXPECT_TRUE(opt.column_to_row.pattern);
+    EXPECT_TRUE(opt.row_to_column.pattern);
+    EXPECT_TRUE(opt.row_to_row.pattern);
+}
+
+/******************************/
+
+class SparseMatrixDenseRowHybridTest : public ::testing::TestWithParam<std::tuple<int, int, double> > {};
+
+TEST_P(SparseMatrixDenseRowHybridTest, Hybrid) {
+    const auto params = GetParam();
+    const auto block_size = std::get<0>(params);
+    const auto nthreads = std::get<1>(params);
+    const auto threshold = std::get<2>(params);
+    const int NR = 51, NC = 73, NRHS = 29;
+
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 1234 + block_size + nthreads;
+        return opt;
+    }());
+    auto dense_row = std::make_unique<tatami::DenseRowMatrix<double, int> >(NR, NC, dump);
+
+    // Making some RHS rows and columns denser than others, so that only some of them are stored densely.
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.1;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 5678 + block_size + nthreads;
+        return opt;
+    }());
+    for (int h = 0; h < NRHS; h += 3) {
+        for (int c = 0; c < NC; c += 1 + (h % 2)) {
+            rhs[h * NC + c] = h + c + 1;
+        }
+    }
+    for (int c = 0; c < NC; c += 4) {
+        for (int h = 0; h < NRHS; ++h) {
+            rhs[h * NC + c] = h - c;
+        }
+    }
+    auto right_col = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseColumnMatrix<double, int>(NC, NRHS, rhs), false, {});
+    auto right_row = tatami::convert_to_compressed_sparse<double, int>(*right_col, true, {});
+
+    tatami_mult::MultiplyDenseRowWithSparseMatrixOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+    tatami_mult::set_sparse_block_size(opt, block_size);
+    opt.column_to_row.dense_threshold = threshold;
+    opt.column_to_column.dense_threshold = threshold;
+    opt.row_to_row.dense_threshold = threshold;
+
+    const auto output_size = NR * NRHS;
+    std::vector<double> rc_ro(output_size, 1), rc_co(output_size, 2), rr_ro(output_size, 3);
+    tatami_mult::multiply_dense_row_with_sparse_matrix(*dense_row, *right_col, rc_ro.data(), true, opt);
+    tatami_mult::multiply_dense_row_with_sparse_matrix(*dense_row, *right_col, rc_co.data(), false, opt);
+    tatami_mult::multiply_dense_row_with_sparse_matrix(*dense_row, *right_row, rr_ro.data(), true, opt);
+
+    for (int h = 0; h < NRHS; ++h) {
+        const auto rptr = rhs.data() + h * NC;
+        for (int r = 0; r < NR; ++r) {
+            const auto ref = std::inner_product(rptr, rptr + NC, dump.begin() + r * NC, 0.0);
+            EXPECT_FLOAT_EQ(ref, rc_ro[r * NRHS + h]);
+            EXPECT_FLOAT_EQ(ref, rr_ro[r * NRHS + h]);
+            EXPECT_FLOAT_EQ(ref, rc_co[h * NR + r]);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SparseMatrix,
+    SparseMatrixDenseRowHybridTest,
+    ::testing::Combine(
+        ::testing::Values(1, 4), // block size.
+        ::testing::Values(1, 3), // number of threads.
+        ::testing::Values(0, 0.5, 1, 2) // dense threshold.
+    )
+);
+
+TEST(SparseMatrixDenseRow, DenseThresholdNonFinite) {
+    // Each RHS vector has a single structural zero, which should not be multiplied with the non-finite LHS values under the default threshold.
+    const int NR = 3, NC = 4, NRHS = 4;
+    std::vector<double> dump(NR * NC, 1);
+    dump[1] = std::numeric_limits<double>::infinity();
+    auto dense_row = std::make_unique<tatami::DenseRowMatrix<double, int> >(NR, NC, dump);
+
+    std::vector<double> rhs(NC * NRHS, 2);
+    for (int h = 0; h < NRHS; ++h) {
+        rhs[h * NC + h] = 0;
+    }
+    auto right_col = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseColumnMatrix<double, int>(NC, NRHS, rhs), false, {});
+    auto right_row = tatami::convert_to_compressed_sparse<double, int>(*right_col, true, {});
+
+    tatami_mult::MultiplyDenseRowWithSparseMatrixOptions opt;
+    const auto output_size = NR * NRHS;
+    std::vector<double> rc_ro(output_size), rc_co(output_size), rr_ro(output_size);
+    tatami_mult::multiply_dense_row_with_sparse_matrix(*dense_row, *right_col, rc_ro.data(), true, opt);
+    tatami_mult::multiply_dense_row_with_sparse_matrix(*dense_row, *right_col, rc_co.data(), false, opt);
+    tatami_mult::multiply_dense_row_with_sparse_matrix(*dense_row, *right_row, rr_ro.data(), true, opt);
+
+    // Only the first LHS row contains an infinite value, which is skipped by the structural zero of the second RHS column.
+    EXPECT_EQ(rc_ro[1], 6);
+    EXPECT_EQ(rc_co[NR], 6);
+    EXPECT_EQ(rr_ro[1], 6);
+    for (int h = 0; h < NRHS; ++h) {
+        if (h != 1) {
+            EXPECT_TRUE(std::isinf(rc_ro[h]));
+            EXPECT_TRUE(std::isinf(rc_co[h * NR]));
+            EXPECT_TRUE(std::isinf(rr_ro[h]));
+        }
+    }
+    for (int i = NRHS; i < output_size; ++i) {
+        EXPECT_EQ(rc_ro[i], 6);
+        EXPECT_EQ(rr_ro[i], 6);
+    }
+}
+
+/******************************/
+
+TEST(SparseMatrixDenseRow, Pattern) {
+    const int NR = 47, NC = 61, NRHS = 37;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 2468;
+        return opt;
+    }());
+    auto left = std::make_unique<tatami::DenseRowMatrix<double, int> >(NR, NC, dump);
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.2;
+        opt.lower = 1;
+        opt.upper = 1;
+        opt.seed = 1357;
+        return opt;
+    }());
+    auto right_col = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseColumnMatrix<double, int>(NC, NRHS, rhs), false, {});
+    auto right_row = tatami::convert_to_compressed_sparse<double, int>(*right_col, true, {});
+
+    for (int nthreads : { 1, 3 }) {
+        for (int block_size : { 1, 4 }) {
+            tatami_mult::MultiplyDenseRowWithSparseMatrixOptions opt;
+            tatami_mult::set_num_threads(opt, nthreads);
+            tatami_mult::set_sparse_block_size(opt, block_size);
+
+            // Also checking that pattern vectors are correctly densified.
+            if (block_size == 4) {
+                opt.column_to_column.dense_threshold = 0.1;
+                opt.column_to_row.dense_threshold = 0.1;
+                opt.row_to_row.dense_threshold = 0.1;
+            }
+            auto popt = opt;
+            tatami_mult::set_sparse_pattern(popt, true);
+
+            for (const auto& right : { right_row, right_col }) {
+                for (bool row_major : { true, false }) {
+                    std::vector<double> ref(NR * NRHS), output(NR * NRHS, -1);
+                    tatami_mult::multiply_dense_row_with_sparse_matrix(*left, *right, ref.data(), row_major, opt);
+                    tatami_mult::multiply_dense_row_with_sparse_matrix(*left, *right, output.data(), row_major, popt);
+                    for (int i = 0; i < NR * NRHS; ++i) {
+                        EXPECT_FLOAT_EQ(ref[i], output[i]);
+                    }
+                }
+            }
+        }
+    }
 }
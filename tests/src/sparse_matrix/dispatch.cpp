@@ -101,4 +101,10 @@ TEST(SparseMatrixDispatch, Options) {
     EXPECT_EQ(opt.dense_row.row_to_row.block_size, 100);
     EXPECT_EQ(opt.dense_column.column_to_row.block_size, 100);
     EXPECT_EQ(opt.dense_column.row_to_row.block_size, 100);
+
+    tatami_mult::set_sparse_pattern(opt, true);
+    EXPECT_TRUE(opt.dense_row.row_to_row.pattern);
+    EXPECT_TRUE(opt.dense_column.column_to_column.pattern);
+    EXPECT_TRUE(opt.sparse_row.column_to_row.pattern);
+    EXPECT_TRUE(opt.sparse_column.row_to_column.pattern);
 }
@@ -175,4 +175,55 @@ TEST(SparseMatrixSparseColumn, Options) {
     EXPECT_EQ(opt.column_to_row.num_threads, 12);
     EXPECT_EQ(opt.row_to_column.num_threads, 12);
     EXPECT_EQ(opt.row_to_row.num_threads, 12);
+
+    tatami_mult::set_sparse_pattern(opt, true);
+    EXPECT_TRUE(opt.column_to_column.pattern);
+    EXPECT_TRUE(opt.column_to_row.pattern);
+    EXPECT_TRUE(opt.row_to_column.pattern);
+    EXPECT_TRUE(opt.row_to_row.pattern);
+}
+
+/******************************/
+
+TEST(SparseMatrixSparseColumn, Pattern) {
+    const int NR = 47, NC = 61, NRHS = 37;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 2468;
+        return opt;
+    }());
+    auto left = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), false, {});
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.2;
+        opt.lower = 1;
+        opt.upper = 1;
+        opt.seed = 1357;
+        return opt;
+    }());
+    auto right_col = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseColumnMatrix<double, int>(NC, NRHS, rhs), false, {});
+    auto right_row = tatami::convert_to_compressed_sparse<double, int>(*right_col, true, {});
+
+    for (int nthreads : { 1, 3 }) {
+        {
+            tatami_mult::MultiplySparseColumnWithSparseMatrixOptions opt;
+            tatami_mult::set_num_threads(opt, nthreads);
+            auto popt = opt;
+            tatami_mult::set_sparse_pattern(popt, true);
+
+            for (const auto& right : { right_row, right_col }) {
+                for (bool row_major : { true, false }) {
+                    std::vector<double> ref(NR * NRHS), output(NR * NRHS, -1);
+                    tatami_mult::multiply_sparse_column_with_sparse_matrix(*left, *right, ref.data(), row_major, opt);
+                    tatami_mult::multiply_sparse_column_with_sparse_matrix(*left, *right, output.data(), row_major, popt);
+                    for (int i = 0; i < NR * NRHS; ++i) {
+                        EXPECT_FLOAT_EQ(ref[i], output[i]);
+                    }
+                }
+            }
+        }
+    }
 }
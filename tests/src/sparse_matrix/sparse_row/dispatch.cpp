@@ -199,4 +199,140 @@ TEST(SparseMatrixSparseRow, Options) {
     tatami_mult::set_sparse_block_size(opt, 42);
     EXPECT_EQ(opt.column_to_column.block_size, 42);
     EXPECT_EQ(opt.column_to_row.block_size, 42);
+
+    tatami_mult::set_sparse_pattern(opt, true);
+    EXPECT_TRUE(opt.column_to_column.pattern);
+    EXPECT_TRUE(opt.column_to_row.pattern);
+    EXPECT_TRUE(opt.row_to_column.pattern);
+    EXPECT_TRUE(opt.row_to_row.pattern);
+}
+
+/******************************/
+
+class SparseMatrixSparseRowHybridTest : public ::testing::TestWithParam<std::tuple<int, int, double> > {};
+
+TEST_P(SparseMatrixSparseRowHybridTest, Hybrid) {
+    const auto params = GetParam();
+    const auto block_size = std::get<0>(params);
+    const auto nthreads = std::get<1>(params);
+    const auto threshold = std::get<2>(params);
+    const int NR = 57, NC = 69, NRHS = 31;
+
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.2;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 4321 + block_size + nthreads;
+        return opt;
+    }());
+    auto sparse_row = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), true, {});
+
+    // Making some RHS rows and columns denser than others, so that only some of them are stored densely.
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.1;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 8765 + block_size + nthreads;
+        return opt;
+    }());
+    for (int h = 0; h < NRHS; h += 3) {
+        for (int c = 0; c < NC; c += 1 + (h % 2)) {
+            rhs[h * NC + c] = h + c + 1;
+        }
+    }
+    for (int c = 0; c < NC; c += 4) {
+        for (int h = 0; h < NRHS; ++h) {
+            rhs[h * NC + c] = h - c;
+        }
+    }
+    auto right_col = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseColumnMatrix<double, int>(NC, NRHS, rhs), false, {});
+    auto right_row = tatami::convert_to_compressed_sparse<double, int>(*right_col, true, {});
+
+    tatami_mult::MultiplySparseRowWithSparseMatrixOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+    tatami_mult::set_sparse_block_size(opt, block_size);
+    opt.column_to_row.dense_threshold = threshold;
+    opt.column_to_column.dense_threshold = threshold;
+    opt.row_to_row.dense_threshold = threshold;
+
+    const auto output_size = NR * NRHS;
+    std::vector<double> rc_ro(output_size, 1), rc_co(output_size, 2), rr_ro(output_size, 3);
+    tatami_mult::multiply_sparse_row_with_sparse_matrix(*sparse_row, *right_col, rc_ro.data(), true, opt);
+    tatami_mult::multiply_sparse_row_with_sparse_matrix(*sparse_row, *right_col, rc_co.data(), false, opt);
+    tatami_mult::multiply_sparse_row_with_sparse_matrix(*sparse_row, *right_row, rr_ro.data(), true, opt);
+
+    for (int h = 0; h < NRHS; ++h) {
+        const auto rptr = rhs.data() + h * NC;
+        for (int r = 0; r < NR; ++r) {
+            const auto ref = std::inner_product(rptr, rptr + NC, dump.begin() + r * NC, 0.0);
+            EXPECT_FLOAT_EQ(ref, rc_ro[r * NRHS + h]);
+            EXPECT_FLOAT_EQ(ref, rr_ro[r * NRHS + h]);
+            EXPECT_FLOAT_EQ(ref, rc_co[h * NR + r]);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SparseMatrix,
+    SparseMatrixSparseRowHybridTest,
+    ::testing::Combine(
+        ::testing::Values(1, 4), // block size.
+        ::testing::Values(1, 3), // number of threads.
+        ::testing::Values(0, 0.5, 1, 2) // dense threshold.
+    )
+);
+
+/******************************/
+
+TEST(SparseMatrixSparseRow, Pattern) {
+    const int NR = 47, NC = 61, NRHS = 37;
+    auto dump = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 2468;
+        return opt;
+    }());
+    auto left = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseRowMatrix<double, int>(NR, NC, dump), true, {});
+
+    auto rhs = tatami_test::simulate_vector<double>(NC * NRHS, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.density = 0.2;
+        opt.lower = 1;
+        opt.upper = 1;
+        opt.seed = 1357;
+        return opt;
+    }());
+    auto right_col = tatami::convert_to_compressed_sparse<double, int>(tatami::DenseColumnMatrix<double, int>(NC, NRHS, rhs), false, {});
+    auto right_row = tatami::convert_to_compressed_sparse<double, int>(*right_col, true, {});
+
+    for (int nthreads : { 1, 3 }) {
+        for (int block_size : { 1, 4 }) {
+            tatami_mult::MultiplySparseRowWithSparseMatrixOptions opt;
+            tatami_mult::set_num_threads(opt, nthreads);
+            tatami_mult::set_sparse_block_size(opt, block_size);
+
+            // Also checking that pattern vectors are correctly densified.
+            if (block_size == 4) {
+                opt.column_to_column.dense_threshold = 0.1;
+                opt.column_to_row.dense_threshold = 0.1;
+                opt.row_to_row.dense_threshold = 0.1;
+            }
+            auto popt = opt;
+            tatami_mult::set_sparse_pattern(popt, true);
+
+            for (const auto& right : { right_row, right_col }) {
+                for (bool row_major : { true, false }) {
+                    std::vector<double> ref(NR * NRHS), output(NR * NRHS, -1);
+                    tatami_mult::multiply_sparse_row_with_sparse_matrix(*left, *right, ref.data(), row_major, opt);
+                    tatami_mult::multiply_sparse_row_with_sparse_matrix(*left, *right, output.data(), row_major, popt);
+                    for (int i = 0; i < NR * NRHS; ++i) {
+                        EXPECT_FLOAT_EQ(ref[i], output[i]);
+                    }
+                }
+            }
+        }
+    }
 }
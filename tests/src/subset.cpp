@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+#include "utils.h"
+
+class SubsetTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    // A step of zero means that no subset is used.
+    static tatami::VectorPtr<int> create_subset(int extent, int step) {
+        if (step == 0) {
+            return nullptr;
+        }
+        auto output = std::make_shared<std::vector<int> >();
+        for (int i = step / 2; i < extent; i += step) {
+            output->push_back(i);
+        }
+        return output;
+    }
+
+    static std::vector<int> realize_subset(const tatami::VectorPtr<int>& subset, int extent) {
+        if (subset) {
+            return *subset;
+        }
+        std::vector<int> output(extent);
+        for (int i = 0; i < extent; ++i) {
+            output[i] = i;
+        }
+        return output;
+    }
+};
+
+TEST_P(SubsetTest, Vectors) {
+    const auto params = GetParam();
+    const int step = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+    const int NR = 71, NC = 49, num_vectors = 4;
+
+    const auto ldump = simulate_test_contents(NR, NC, 42 + step);
+    auto lefts = create_test_matrices(NR, NC, ldump);
+
+    std::vector<std::vector<double> > rhs;
+    std::vector<const double*> rhs_ptrs;
+    for (int v = 0; v < num_vectors; ++v) {
+        rhs.push_back(simulate_test_contents(NC, 1, 99 + v));
+        rhs_ptrs.push_back(rhs.back().data());
+    }
+
+    tatami_mult::MultiplySubsetOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+
+    for (int row_step : { 0, step }) {
+        for (int common_step : { 0, step + 1 }) {
+            const auto row_subset = create_subset(NR, row_step);
+            const auto common_subset = create_subset(NC, common_step);
+            const auto rows = realize_subset(row_subset, NR);
+            const auto common = realize_subset(common_subset, NC);
+            const int num_rows = rows.size();
+
+            std::vector<std::vector<double> > ref(num_vectors, std::vector<double>(num_rows));
+            for (int v = 0; v < num_vectors; ++v) {
+                for (int r = 0; r < num_rows; ++r) {
+                    for (auto c : common) {
+                        ref[v][r] += ldump[rows[r] * NC + c] * rhs[v][c];
+                    }
+                }
+            }
+
+            for (const auto& left : lefts) {
+                std::vector<std::vector<double> > output(num_vectors, std::vector<double>(num_rows, -1));
+                std::vector<double*> output_ptrs;
+                for (auto& o : output) {
+                    output_ptrs.push_back(o.data());
+                }
+                tatami_mult::multiply_subset_with_multiple_vectors(*left, row_subset, common_subset, rhs_ptrs, output_ptrs, opt);
+                for (int v = 0; v < num_vectors; ++v) {
+                    for (int r = 0; r < num_rows; ++r) {
+                        EXPECT_FLOAT_EQ(ref[v][r], output[v][r]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_P(SubsetTest, Matrix) {
+    const auto params = GetParam();
+    const int step = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+    const int NR = 43, NC = 37, NRHS = 31;
+
+    const auto ldump = simulate_test_contents(NR, NC, 24 + step);
+    const auto rdump = simulate_test_contents(NC, NRHS, 66 + step);
+    auto lefts = create_test_matrices(NR, NC, ldump);
+    auto rights = create_test_matrices(NC, NRHS, rdump);
+
+    tatami_mult::MultiplySubsetOptions opt;
+    tatami_mult::set_num_threads(opt, nthreads);
+
+    const auto row_subset = create_subset(NR, step);
+    const auto common_subset = create_subset(NC, step + 1);
+    const auto column_subset = create_subset(NRHS, step + 2);
+    const auto rows = realize_subset(row_subset, NR);
+    const auto common = realize_subset(common_subset, NC);
+    const auto columns = realize_subset(column_subset, NRHS);
+    const int num_rows = rows.size(), num_columns = columns.size();
+
+    std::vector<double> ref(num_rows * num_columns);
+    for (int r = 0; r < num_rows; ++r) {
+        for (int c = 0; c < num_columns; ++c) {
+            auto& current = ref[r * num_columns + c];
+            for (auto cd : common) {
+                current += ldump[rows[r] * NC + cd] * rdump[cd * NRHS + columns[c]];
+            }
+        }
+    }
+
+    for (bool row_major : { true, false }) {
+        for (const auto& left : lefts) {
+            for (const auto& right : rights) {
+                std::vector<double> output(num_rows * num_columns, -1);
+                tatami_mult::multiply_subset_with_matrix(*left, *right, row_subset, common_subset, column_subset, output.data(), row_major, opt);
+                for (int r = 0; r < num_rows; ++r) {
+                    for (int c = 0; c < num_columns; ++c) {
+                        const auto observed = (row_major ? output[r * num_columns + c] : output[c * num_rows + r]);
+                        EXPECT_FLOAT_EQ(ref[r * num_columns + c], observed);
+                    }
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Subset,
+    SubsetTest,
+    ::testing::Combine(
+        ::testing::Values(0, 2, 5), // step size of the subsets
+        ::testing::Values(1, 3) // number of threads
+    )
+);
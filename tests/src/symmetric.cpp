@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+#include "utils.h"
+
+class SymmetricTest : public ::testing::TestWithParam<std::tuple<int, bool, int, int> > {};
+
+TEST_P(SymmetricTest, Basic) {
+    const auto params = GetParam();
+    const int N = std::get<0>(params);
+    const bool upper = std::get<1>(params);
+    const int block_size = std::get<2>(params);
+    const int nthreads = std::get<3>(params);
+
+    auto dump = tatami_test::simulate_vector<double>(N * N, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.density = 0.2;
+        opt.seed = 97 + N + upper + block_size + nthreads;
+        return opt;
+    }());
+
+    // Creating the full symmetric matrix for reference, along with a copy that only contains one triangle.
+    auto full = dump;
+    auto triangle = dump;
+    for (int r = 0; r < N; ++r) {
+        for (int c = 0; c < N; ++c) {
+            const auto lower_val = dump[std::max(r, c) * N + std::min(r, c)];
+            full[r * N + c] = lower_val;
+            const bool keep = (upper ? c >= r : c <= r);
+            triangle[r * N + c] = (keep ? lower_val : 0);
+        }
+    }
+
+    tatami::DenseRowMatrix<double, int> ref_mat(N, N, full);
+    auto lefts = create_test_matrices(N, N, triangle);
+
+    const int num_vectors = 3;
+    std::vector<std::vector<double> > rhs;
+    std::vector<const double*> rhs_ptrs;
+    for (int v = 0; v < num_vectors; ++v) {
+        rhs.push_back(tatami_test::simulate_vector<double>(N, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -10;
+            opt.upper = 10;
+            opt.seed = 51 + N + v;
+            return opt;
+        }()));
+        rhs_ptrs.push_back(rhs.back().data());
+    }
+
+    std::vector<std::vector<double> > ref(num_vectors, std::vector<double>(N));
+    tatami_mult::MultiplyWithSingleVectorOptions ref_opt;
+    for (int v = 0; v < num_vectors; ++v) {
+        tatami_mult::multiply_with_single_vector(ref_mat, rhs[v].data(), ref[v].data(), ref_opt);
+    }
+
+    tatami_mult::MultiplySymmetricOptions opt;
+    opt.upper = upper;
+    opt.block_size = block_size;
+    opt.num_threads = nthreads;
+
+    for (const auto& left : lefts) {
+        std::vector<double> output(N, 99);
+        tatami_mult::multiply_symmetric_with_single_vector(*left, rhs[0].data(), output.data(), opt);
+        for (int r = 0; r < N; ++r) {
+            EXPECT_FLOAT_EQ(ref[0][r], output[r]);
+        }
+
+        std::vector<std::vector<double> > outputs(num_vectors, std::vector<double>(N, -1));
+        std::vector<double*> output_ptrs;
+        for (auto& o : outputs) {
+            output_ptrs.push_back(o.data());
+        }
+        tatami_mult::multiply_symmetric_with_multiple_vectors(*left, rhs_ptrs, output_ptrs, opt);
+        for (int v = 0; v < num_vectors; ++v) {
+            for (int r = 0; r < N; ++r) {
+                EXPECT_FLOAT_EQ(ref[v][r], outputs[v][r]);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Symmetric,
+    SymmetricTest,
+    ::testing::Combine(
+        ::testing::Values(1, 17, 80), // matrix order
+        ::testing::Values(false, true), // upper triangle
+        ::testing::Values(1, 7, 128), // block size
+        ::testing::Values(0, 1, 3) // number of threads
+    )
+);
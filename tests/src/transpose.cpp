@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/transpose.hpp"
+
+class TransposeTest : public ::testing::TestWithParam<std::tuple<std::pair<int, int>, int> > {};
+
+TEST_P(TransposeTest, Basic) {
+    const auto params = GetParam();
+    const auto dims = std::get<0>(params);
+    const int nthreads = std::get<1>(params);
+    const int NR = dims.first, NC = dims.second;
+
+    auto input = tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.seed = 13 + NR + NC + nthreads;
+        return opt;
+    }());
+
+    tatami_mult::TransposeOptions opt;
+    opt.num_threads = nthreads;
+    std::vector<double> output(NR * NC, -1);
+    tatami_mult::transpose(input.data(), NR, NC, output.data(), opt);
+    for (int r = 0; r < NR; ++r) {
+        for (int c = 0; c < NC; ++c) {
+            EXPECT_EQ(input[r * NC + c], output[c * NR + r]);
+        }
+    }
+
+    // Round trip with the dimensions swapped.
+    std::vector<float> roundtrip(NR * NC, -1);
+    tatami_mult::transpose(output.data(), NC, NR, roundtrip.data(), opt);
+    for (int i = 0; i < NR * NC; ++i) {
+        EXPECT_EQ(static_cast<float>(input[i]), roundtrip[i]);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Transpose,
+    TransposeTest,
+    ::testing::Combine(
+        ::testing::Values( // dimensions
+            std::make_pair(1, 1),
+            std::make_pair(1, 50),
+            std::make_pair(50, 1),
+            std::make_pair(16, 16),
+            std::make_pair(17, 33),
+            std::make_pair(123, 77),
+            std::make_pair(0, 10)
+        ),
+        ::testing::Values(1, 3) // number of threads
+    )
+);
+
+TEST(Transpose, Accumulate) {
+    std::vector<double> input{ 1, 2, 3, 4, 5, 6 }; // 2 x 3, row-major.
+    std::vector<double> output(6, 10);
+    tatami_mult::transpose_tile<true>(input.data(), 2, 3, 3, output.data(), 2);
+    std::vector<double> expected{ 11, 14, 12, 15, 13, 16 };
+    EXPECT_EQ(output, expected);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+
+#include "tatami_test/tatami_test.hpp"
+
+#include "tatami_mult/tatami_mult.hpp"
+
+#include "utils.h"
+
+class TriangularTest : public ::testing::TestWithParam<std::tuple<int, bool, bool, int, int> > {
+protected:
+    int N;
+    bool upper, unit;
+    std::vector<std::shared_ptr<const tatami::Matrix<double, int> > > lefts;
+    std::shared_ptr<const tatami::Matrix<double, int> > ref_mat;
+
+    void assemble(int seed) {
+        // The other triangle is filled with junk that should be ignored.
+        auto dump = tatami_test::simulate_vector<double>(N * N, [&]{
+            tatami_test::SimulateVectorOptions opt;
+            opt.lower = -1;
+            opt.upper = 1;
+            opt.density = 0.3;
+            opt.seed = seed;
+            return opt;
+        }());
+        auto triangle = dump;
+        for (int r = 0; r < N; ++r) {
+            dump[r * N + r] = 2 + r % 3;
+            for (int c = 0; c < N; ++c) {
+                const bool keep = (upper ? c > r : c < r);
+                triangle[r * N + c] = (keep ? dump[r * N + c] : 0);
+            }
+            triangle[r * N + r] = (unit ? 1 : dump[r * N + r]);
+        }
+
+        ref_mat.reset(new tatami::DenseRowMatrix<double, int>(N, N, std::move(triangle)));
+        lefts = create_test_matrices(N, N, std::move(dump));
+    }
+
+    static std::vector<std::vector<double> > create_vectors(int N, int num_vectors, int seed) {
+        std::vector<std::vector<double> > output;
+        for (int v = 0; v < num_vectors; ++v) {
+            output.push_back(tatami_test::simulate_vector<double>(N, [&]{
+                tatami_test::SimulateVectorOptions opt;
+                opt.lower = -10;
+                opt.upper = 10;
+                opt.seed = seed + v;
+                return opt;
+            }()));
+        }
+        return output;
+    }
+};
+
+TEST_P(TriangularTest, Multiply) {
+    const auto params = GetParam();
+    N = std::get<0>(params);
+    upper = std::get<1>(params);
+    unit = std::get<2>(params);
+    const int block_size = std::get<3>(params);
+    const int nthreads = std::get<4>(params);
+    assemble(123 + N + upper + unit + block_size + nthreads);
+
+    const int num_vectors = 3;
+    auto rhs = create_vectors(N, num_vectors, 77 + N);
+    std::vector<const double*> rhs_ptrs;
+    for (const auto& r : rhs) {
+        rhs_ptrs.push_back(r.data());
+    }
+
+    std::vector<std::vector<double> > ref(num_vectors, std::vector<double>(N));
+    tatami_mult::MultiplyWithSingleVectorOptions ref_opt;
+    for (int v = 0; v < num_vectors; ++v) {
+        tatami_mult::multiply_with_single_vector(*ref_mat, rhs[v].data(), ref[v].data(), ref_opt);
+    }
+
+    tatami_mult::MultiplyTriangularOptions opt;
+    opt.upper = upper;
+    opt.unit_diagonal = unit;
+    opt.block_size = block_size;
+    opt.num_threads = nthreads;
+
+    for (const auto& left : lefts) {
+        std::vector<double> output(N, 99);
+        tatami_mult::multiply_triangular_with_single_vector(*left, rhs[0].data(), output.data(), opt);
+        for (int r = 0; r < N; ++r) {
+            EXPECT_FLOAT_EQ(ref[0][r], output[r]);
+        }
+
+        std::vector<std::vector<double> > outputs(num_vectors, std::vector<double>(N, -1));
+        std::vector<double*> output_ptrs;
+        for (auto& o : outputs) {
+            output_ptrs.push_back(o.data());
+        }
+        tatami_mult::multiply_triangular_with_multiple_vectors(*left, rhs_ptrs, output_ptrs, opt);
+        for (int v = 0; v < num_vectors; ++v) {
+            for (int r = 0; r < N; ++r) {
+                EXPECT_FLOAT_EQ(ref[v][r], outputs[v][r]);
+            }
+        }
+    }
+}
+
+TEST_P(TriangularTest, Solve) {
+    const auto params = GetParam();
+    N = std::get<0>(params);
+    upper = std::get<1>(params);
+    unit = std::get<2>(params);
+    const int block_size = std::get<3>(params);
+    const int nthreads = std::get<4>(params);
+    assemble(456 + N + upper + unit + block_size + nthreads);
+
+    const int num_vectors = 4;
+    auto rhs = create_vectors(N, num_vectors, 88 + N);
+    std::vector<const double*> rhs_ptrs;
+    for (const auto& r : rhs) {
+        rhs_ptrs.push_back(r.data());
+    }
+
+    tatami_mult::SolveTriangularOptions opt;
+    opt.upper = upper;
+    opt.unit_diagonal = unit;
+    opt.block_size = block_size;
+    opt.num_threads = nthreads;
+    tatami_mult::MultiplyWithSingleVectorOptions ref_opt;
+
+    for (const auto& left : lefts) {
+        // Checking that multiplying the solution by the triangular matrix recovers the RHS.
+        std::vector<double> output(N, 99), check(N);
+        tatami_mult::solve_triangular_with_single_vector(*left, rhs[0].data(), output.data(), opt);
+        tatami_mult::multiply_with_single_vector(*ref_mat, output.data(), check.data(), ref_opt);
+        for (int r = 0; r < N; ++r) {
+            EXPECT_NEAR(rhs[0][r], check[r], 1e-8);
+        }
+
+        // Solving in place.
+        auto outputs = rhs;
+        std::vector<double*> output_ptrs;
+        for (auto& o : outputs) {
+            output_ptrs.push_back(o.data());
+        }
+        tatami_mult::solve_triangular_with_multiple_vectors(*left, output_ptrs, output_ptrs, opt);
+        for (int r = 0; r < N; ++r) {
+            EXPECT_FLOAT_EQ(output[r], outputs[0][r]);
+        }
+        for (int v = 1; v < num_vectors; ++v) {
+            tatami_mult::multiply_with_single_vector(*ref_mat, outputs[v].data(), check.data(), ref_opt);
+            for (int r = 0; r < N; ++r) {
+                EXPECT_NEAR(rhs[v][r], check[r], 1e-8);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Triangular,
+    TriangularTest,
+    ::testing::Combine(
+        ::testing::Values(1, 19, 73), // matrix order
+        ::testing::Values(false, true), // upper triangle
+        ::testing::Values(false, true), // unit diagonal
+        ::testing::Values(1, 10, 128), // block size
+        ::testing::Values(0, 1, 3) // number of threads
+    )
+);
@@ -3,6 +3,12 @@
 
 #include <random>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+
+#include "tatami/tatami.hpp"
+#include "tatami_test/tatami_test.hpp"
 
 inline std::vector<double> simulate_strided_sparse_matrix(const int primary, const int secondary, const int stride, unsigned long long seed) {
     std::vector<double> output;
@@ -31,4 +37,171 @@ inline std::vector<double> simulate_strided_sparse_matrix(const int primary, con
     return output;
 }
 
+// Creating dense row-major, dense column-major, CSR and CSC versions of the same row-major contents.
+inline std::vector<std::shared_ptr<const tatami::Matrix<double, int> > > create_test_matrices(const int NR, const int NC, std::vector<double> dump) {
+    auto dense_row = std::make_shared<tatami::DenseRowMatrix<double, int> >(NR, NC, std::move(dump));
+    return std::vector<std::shared_ptr<const tatami::Matrix<double, int> > >{
+        dense_row,
+        tatami::convert_to_dense<double, int>(*dense_row, false, {}),
+        tatami::convert_to_compressed_sparse<double, int>(*dense_row, true, {}),
+        tatami::convert_to_compressed_sparse<double, int>(*dense_row, false, {})
+    };
+}
+
+inline std::vector<double> simulate_test_contents(const int NR, const int NC, const unsigned long long seed) {
+    return tatami_test::simulate_vector<double>(NR * NC, [&]{
+        tatami_test::SimulateVectorOptions opt;
+        opt.lower = -10;
+        opt.upper = 10;
+        opt.density = 0.3;
+        opt.seed = seed;
+        return opt;
+    }());
+}
+
+inline std::vector<std::shared_ptr<const tatami::Matrix<double, int> > > create_test_matrices(const int NR, const int NC, const unsigned long long seed) {
+    return create_test_matrices(NR, NC, simulate_test_contents(NR, NC, seed));
+}
+
+// Wrapper that records the indices predicted by each oracle and the indices that are actually fetched by oracular dense extractors.
+// It also claims to use an oracle so that the default choice of pre-pass can be checked.
+class FetchRecordingMatrix final : public tatami::Matrix<double, int> {
+public:
+    FetchRecordingMatrix(std::shared_ptr<const tatami::Matrix<double, int> > inner) : my_inner(std::move(inner)) {}
+
+private:
+    std::shared_ptr<const tatami::Matrix<double, int> > my_inner;
+    mutable std::mutex my_lock;
+    mutable std::vector<int> my_predicted, my_fetched;
+
+    class RecordingExtractor final : public tatami::OracularDenseExtractor<double, int> {
+    public:
+        RecordingExtractor(const FetchRecordingMatrix& parent, std::shared_ptr<const tatami::Oracle<int> > oracle, std::unique_ptr<tatami::OracularDenseExtractor<double, int> > inner) :
+            my_parent(parent), my_oracle(std::move(oracle)), my_inner(std::move(inner)) {}
+
+        const double* fetch(int i, double* buffer) {
+            const auto current = my_oracle->get(my_used);
+            ++my_used;
+            {
+                std::lock_guard<std::mutex> lck(my_parent.my_lock);
+                my_parent.my_fetched.push_back(current);
+            }
+            return my_inner->fetch(i, buffer);
+        }
+
+    private:
+        const FetchRecordingMatrix& my_parent;
+        std::shared_ptr<const tatami::Oracle<int> > my_oracle;
+        std::unique_ptr<tatami::OracularDenseExtractor<double, int> > my_inner;
+        std::size_t my_used = 0;
+    };
+
+public:
+    // Sorted indices across all oracles/extractors, for comparison to the expected set of non-empty vectors.
+    std::vector<int> predicted() const {
+        std::lock_guard<std::mutex> lck(my_lock);
+        auto output = my_predicted;
+        std::sort(output.begin(), output.end());
+        return output;
+    }
+
+    std::vector<int> fetched() const {
+        std::lock_guard<std::mutex> lck(my_lock);
+        auto output = my_fetched;
+        std::sort(output.begin(), output.end());
+        return output;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lck(my_lock);
+        my_predicted.clear();
+        my_fetched.clear();
+    }
+
+public:
+    int nrow() const { return my_inner->nrow(); }
+    int ncol() const { return my_inner->ncol(); }
+    bool is_sparse() const { return my_inner->is_sparse(); }
+    double is_sparse_proportion() const { return my_inner->is_sparse_proportion(); }
+    bool prefer_rows() const { return my_inner->prefer_rows(); }
+    double prefer_rows_proportion() const { return my_inner->prefer_rows_proportion(); }
+    bool uses_oracle(bool) const { return true; }
+
+    using tatami::Matrix<double, int>::dense;
+    using tatami::Matrix<double, int>::sparse;
+
+public:
+    std::unique_ptr<tatami::MyopicDenseExtractor<double, int> > dense(bool row, const tatami::Options& opt) const {
+        return my_inner->dense(row, opt);
+    }
+
+    std::unique_ptr<tatami::MyopicDenseExtractor<double, int> > dense(bool row, int block_start, int block_length, const tatami::Options& opt) const {
+        return my_inner->dense(row, block_start, block_length, opt);
+    }
+
+    std::unique_ptr<tatami::MyopicDenseExtractor<double, int> > dense(bool row, tatami::VectorPtr<int> indices_ptr, const tatami::Options& opt) const {
+        return my_inner->dense(row, std::move(indices_ptr), opt);
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<double, int> > sparse(bool row, const tatami::Options& opt) const {
+        return my_inner->sparse(row, opt);
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<double, int> > sparse(bool row, int block_start, int block_length, const tatami::Options& opt) const {
+        return my_inner->sparse(row, block_start, block_length, opt);
+    }
+
+    std::unique_ptr<tatami::MyopicSparseExtractor<double, int> > sparse(bool row, tatami::VectorPtr<int> indices_ptr, const tatami::Options& opt) const {
+        return my_inner->sparse(row, std::move(indices_ptr), opt);
+    }
+
+public:
+    std::unique_ptr<tatami::OracularDenseExtractor<double, int> > dense(bool row, std::shared_ptr<const tatami::Oracle<int> > oracle, const tatami::Options& opt) const {
+        {
+            std::lock_guard<std::mutex> lck(my_lock);
+            for (std::size_t i = 0, total = oracle->total(); i < total; ++i) {
+                my_predicted.push_back(oracle->get(i));
+            }
+        }
+        auto inner = my_inner->dense(row, oracle, opt);
+        return std::make_unique<RecordingExtractor>(*this, std::move(oracle), std::move(inner));
+    }
+
+    std::unique_ptr<tatami::OracularDenseExtractor<double, int> > dense(bool row, std::shared_ptr<const tatami::Oracle<int> > oracle, int block_start, int block_length, const tatami::Options& opt) const {
+        return my_inner->dense(row, std::move(oracle), block_start, block_length, opt);
+    }
+
+    std::unique_ptr<tatami::OracularDenseExtractor<double, int> > dense(bool row, std::shared_ptr<const tatami::Oracle<int> > oracle, tatami::VectorPtr<int> indices_ptr, const tatami::Options& opt) const {
+        return my_inner->dense(row, std::move(oracle), std::move(indices_ptr), opt);
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<double, int> > sparse(bool row, std::shared_ptr<const tatami::Oracle<int> > oracle, const tatami::Options& opt) const {
+        return my_inner->sparse(row, std::move(oracle), opt);
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<double, int> > sparse(bool row, std::shared_ptr<const tatami::Oracle<int> > oracle, int block_start, int block_length, const tatami::Options& opt) const {
+        return my_inner->sparse(row, std::move(oracle), block_start, block_length, opt);
+    }
+
+    std::unique_ptr<tatami::OracularSparseExtractor<double, int> > sparse(bool row, std::shared_ptr<const tatami::Oracle<int> > oracle, tatami::VectorPtr<int> indices_ptr, const tatami::Options& opt) const {
+        return my_inner->sparse(row, std::move(oracle), std::move(indices_ptr), opt);
+    }
+};
+
+// Indices of the rows (or columns) of a row-major matrix that contain at least one non-zero value.
+inline std::vector<int> find_non_empty_test_vectors(const int NR, const int NC, const std::vector<double>& contents, const bool row) {
+    std::vector<int> output;
+    const int primary = (row ? NR : NC);
+    for (int p = 0; p < primary; ++p) {
+        const int secondary = (row ? NC : NR);
+        for (int s = 0; s < secondary; ++s) {
+            if (contents[row ? p * NC + s : s * NC + p] != 0) {
+                output.push_back(p);
+                break;
+            }
+        }
+    }
+    return output;
+}
+
 #endif